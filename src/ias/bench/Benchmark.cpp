@@ -0,0 +1,93 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+
+Benchmark::Benchmark(const std::size_t repeatsNum, const std::string& operationFilter): repeats( std::max<std::size_t>(1, repeatsNum) ), filter(operationFilter), records() {
+}
+
+bool Benchmark::selected(const std::string& operation) const {
+    return filter.empty() || (operation.find(filter) != std::string::npos);
+}
+
+bool Benchmark::measure(const std::string& operation, const std::string& shape, const int width, const int height, const Function& setup, const Function& body) {
+    if (selected(operation) == false) {
+        return false;
+    }
+
+    std::vector<double> times;
+    for (std::size_t i = 0; i < repeats; ++i) {
+        if (setup)
+            setup();
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        body();
+        const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        times.push_back( std::chrono::duration<double, std::milli>(end - start).count() );
+    }
+    std::sort(times.begin(), times.end());
+
+    Record record;
+    record.operation = operation;
+    record.shape = shape;
+    record.width = width;
+    record.height = height;
+    record.minMs = times.front();
+    record.medianMs = times[ times.size() / 2 ];
+    double sum = 0.0;
+    for (std::size_t i = 0; i < times.size(); ++i) {
+        sum += times[i];
+    }
+    record.meanMs = sum / times.size();
+    records.push_back( record );
+
+    std::cerr << operation << " " << shape << " " << width << "x" << height << ": " << record.medianMs << " ms" << std::endl;
+    return true;
+}
+
+void Benchmark::writeJson(std::ostream& out, const std::vector< std::pair<std::string, std::string> >& properties) const {
+    out << std::fixed << std::setprecision(3);
+    out << "{\n";
+    for (std::size_t i = 0; i < properties.size(); ++i) {
+        out << "  \"" << properties[i].first << "\": " << properties[i].second << ",\n";
+    }
+    out << "  \"repeats\": " << repeats << ",\n";
+    out << "  \"results\": [";
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        const Record& record = records[i];
+        const double megapixels = (double)record.width * record.height / 1000000.0;
+        const double throughput = (record.medianMs > 0.0) ? megapixels / (record.medianMs / 1000.0) : 0.0;
+        out << ( (i > 0) ? ",\n" : "\n" );
+        out << "    {\"operation\": \"" << record.operation << "\", \"shape\": \"" << record.shape << "\""
+            << ", \"width\": " << record.width << ", \"height\": " << record.height << ", \"megapixels\": " << megapixels
+            << ", \"min_ms\": " << record.minMs << ", \"median_ms\": " << record.medianMs << ", \"mean_ms\": " << record.meanMs
+            << ", \"megapixels_per_s\": " << throughput << "}";
+    }
+    out << "\n  ]\n";
+    out << "}\n";
+}
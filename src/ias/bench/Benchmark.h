@@ -0,0 +1,81 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+/**
+ * Measures operations and collects results.
+ *
+ * Each measurement calls "setup" (not timed) and "body" (timed) given number of times.
+ * Results are written as JSON, so they can be compared between releases.
+ */
+class Benchmark {
+public:
+
+    typedef std::function<void()> Function;
+
+    struct Record {
+        std::string operation;
+        std::string shape;
+        int width;
+        int height;
+        double minMs;
+        double medianMs;
+        double meanMs;
+    };
+
+
+private:
+
+    std::size_t repeats;
+    std::string filter;
+    std::vector<Record> records;
+
+
+public:
+
+    Benchmark(const std::size_t repeatsNum, const std::string& operationFilter);
+
+    /// check if operation is selected by filter
+    bool selected(const std::string& operation) const;
+
+    /// measure "body", returns false if operation is not selected
+    bool measure(const std::string& operation, const std::string& shape, const int width, const int height, const Function& setup, const Function& body);
+
+    const std::vector<Record>& results() const {
+        return records;
+    }
+
+    void writeJson(std::ostream& out, const std::vector< std::pair<std::string, std::string> >& properties) const;
+
+};
+
+
+#endif /* BENCHMARK_H_ */
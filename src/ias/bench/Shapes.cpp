@@ -0,0 +1,112 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "Shapes.h"
+
+#include <cstdint>
+
+#include "ias/ThreadPool.h"
+
+
+static const char* SHAPE_NAMES[SHAPE_COUNT] = { "disc", "squares", "noise", "serpentine" };
+
+static const int SQUARE_SIZE = 32;
+static const int SQUARE_GAP = 2;
+static const int STRIPE_SIZE = 2;
+
+
+const char* shapeName(const Shape shape) {
+    return SHAPE_NAMES[shape];
+}
+
+bool parseShape(const std::string& name, Shape& shape) {
+    for (int i = 0; i < SHAPE_COUNT; ++i) {
+        if (name.compare(SHAPE_NAMES[i]) == 0) {
+            shape = (Shape)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+/// deterministic noise independent of number of threads
+static bool noisePixel(const int x, const int y) {
+    uint32_t h = (uint32_t)x * 73856093u ^ (uint32_t)y * 19349663u;
+    h ^= h >> 13;
+    h *= 0x5bd1e995u;
+    h ^= h >> 15;
+    return (h % 100) < 65;
+}
+
+static bool inShape(const Shape shape, const int x, const int y, const int width, const int height) {
+    switch (shape) {
+    case SHAPE_DISC: {
+        const int64_t dx = x - width / 2;
+        const int64_t dy = y - height / 2;
+        const int64_t radius = std::min(width, height) * 2 / 5;
+        return (dx * dx + dy * dy <= radius * radius);
+    }
+    case SHAPE_SQUARES:
+        return (x % (SQUARE_SIZE + SQUARE_GAP) < SQUARE_SIZE) && (y % (SQUARE_SIZE + SQUARE_GAP) < SQUARE_SIZE);
+    case SHAPE_NOISE:
+        return noisePixel(x, y);
+    case SHAPE_SERPENTINE: {
+        /// stripes joined alternately at right and left end
+        const int period = 2 * STRIPE_SIZE;
+        const int stripe = y / period;
+        if (y % period < STRIPE_SIZE)
+            return true;
+        const bool rightJoin = (stripe % 2 == 0);
+        return rightJoin ? (x >= width - STRIPE_SIZE) : (x < STRIPE_SIZE);
+    }
+    default:
+        return false;
+    }
+}
+
+GeneratedImage generateImage(const Shape shape, const int width, const int height) {
+    GeneratedImage generated;
+    generated.image.create( height, width, CV_8UC3 );
+    cv::Mat& image = generated.image;
+    ias::parallelRows(height, width, [&](const int begin, const int end) {
+        for (int y = begin; y < end; ++y) {
+            cv::Vec3b* row = image.ptr<cv::Vec3b>(y);
+            for (int x = 0; x < width; ++x) {
+                row[x] = inShape(shape, x, y, width, height) ? REGION_COLOR : cv::Vec3b(255, 255, 255);
+            }
+        }
+    });
+
+    /// region pixel closest to center in the same row or below
+    generated.seed = cv::Point(0, 0);
+    for (int y = height / 2; y < height; ++y) {
+        const cv::Vec3b* row = image.ptr<cv::Vec3b>(y);
+        for (int x = width / 2; x < width; ++x) {
+            if (row[x] == REGION_COLOR) {
+                generated.seed = cv::Point(x, y);
+                return generated;
+            }
+        }
+    }
+    return generated;
+}
@@ -0,0 +1,61 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#ifndef SHAPES_H_
+#define SHAPES_H_
+
+#include <string>
+
+#include <opencv2/core/core.hpp>
+
+
+/**
+ * Generated test images: region of REGION_COLOR on white background.
+ */
+enum Shape {
+    SHAPE_DISC,                     /// single large smooth blob
+    SHAPE_SQUARES,                  /// grid of small squares, seed region is one of them
+    SHAPE_NOISE,                    /// random pixels (65% of region color), irregular region
+    SHAPE_SERPENTINE,               /// one long thin snake, many runs and deep fill
+    SHAPE_COUNT
+};
+
+
+static const cv::Vec3b REGION_COLOR(0, 0, 255);
+
+
+struct GeneratedImage {
+    cv::Mat image;
+    cv::Point seed;                 /// pixel of region
+};
+
+
+const char* shapeName(const Shape shape);
+
+/// returns false if name is unknown
+bool parseShape(const std::string& name, Shape& shape);
+
+GeneratedImage generateImage(const Shape shape, const int width, const int height);
+
+
+#endif /* SHAPES_H_ */
@@ -0,0 +1,288 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "ias/Analysis.h"
+#include "ias/Binarize.h"
+#include "ias/ImageIO.h"
+#include "ias/Kernels.h"
+#include "ias/MaskC1.h"
+#include "ias/ThreadPool.h"
+#include "Benchmark.h"
+#include "Shapes.h"
+
+
+static const uchar TOLERANCE = 20;
+
+
+/// split comma separated list
+static std::vector<std::string> splitList(const std::string& input) {
+    std::vector<std::string> items;
+    std::istringstream iss(input);
+    std::string item;
+    while ( std::getline(iss, item, ',') ) {
+        if (item.empty() == false)
+            items.push_back( item );
+    }
+    return items;
+}
+
+/// image of given size in megapixels with 4:3 aspect ratio
+static cv::Size imageSize(const double megapixels) {
+    const double pixels = megapixels * 1000000.0;
+    const int width = std::max(1, (int)std::lround( std::sqrt(pixels * 4.0 / 3.0) ));
+    const int height = std::max(1, (int)std::lround( pixels / width ));
+    return cv::Size(width, height);
+}
+
+
+static void benchMask(Benchmark& bench, const GeneratedImage& generated, const std::string& shape) {
+    const cv::Mat& image = generated.image;
+    const cv::Point& seed = generated.seed;
+    const int width = image.cols;
+    const int height = image.rows;
+
+    const cv::Mat binarized = ias::MaskC1( image, REGION_COLOR, TOLERANCE ).data();
+    ias::MaskC1 region( binarized.clone() );
+    region.floodFill(seed, 255, 255, 0);
+    const cv::Mat regionMask = region.data();
+
+    ias::MaskC1 mask;
+    const auto binarizedCopy = [&]() {
+        mask = ias::MaskC1( binarized.clone() );
+    };
+    const auto regionCopy = [&]() {
+        mask = ias::MaskC1( regionMask.clone() );
+    };
+    const ias::BitMask packedRegion( regionMask );
+    const auto packedCopy = [&]() {
+        mask = ias::MaskC1( packedRegion );
+    };
+
+    bench.measure("MaskC1::MaskC1(binarize)", shape, width, height, Benchmark::Function(), [&]() {
+        mask = ias::MaskC1( image, REGION_COLOR, TOLERANCE );
+    });
+    bench.measure("MaskC1::MaskC1(seed)", shape, width, height, Benchmark::Function(), [&]() {
+        mask = ias::MaskC1( image, seed, REGION_COLOR, TOLERANCE );
+    });
+    bench.measure("MaskC1::floodFill", shape, width, height, binarizedCopy, [&]() {
+        mask.floodFill(seed, 255, 127, 0);
+    });
+    bench.measure("MaskC1::floodFillParallel", shape, width, height, binarizedCopy, [&]() {
+        mask.floodFillParallel(seed, 255, 127, 0);
+    });
+    bench.measure("MaskC1::applyFilter<Laplace>", shape, width, height, regionCopy, [&]() {
+        mask.applyFilter<ias::LaplaceKernel>();
+    });
+    const cv::Mat filter = cv::Mat::ones( 5, 5, CV_32F ) / 25;
+    bench.measure("MaskC1::applyFilter(5x5)", shape, width, height, regionCopy, [&]() {
+        mask.applyFilter(filter);
+    });
+    bench.measure("MaskC1::threshold", shape, width, height, regionCopy, [&]() {
+        mask.threshold(128);
+    });
+    bench.measure("MaskC1::dilate", shape, width, height, regionCopy, [&]() {
+        mask.dilate(3);
+    });
+    bench.measure("MaskC1::erode", shape, width, height, regionCopy, [&]() {
+        mask.erode(3);
+    });
+    bench.measure("MaskC1::changeColor", shape, width, height, regionCopy, [&]() {
+        mask.changeColor(255, 127);
+    });
+    bench.measure("MaskC1::perimeter", shape, width, height, regionCopy, [&]() {
+        mask.perimeter();
+    });
+    bench.measure("MaskC1::dilate(packed)", shape, width, height, packedCopy, [&]() {
+        mask.dilate(3);
+    });
+    bench.measure("MaskC1::erode(packed)", shape, width, height, packedCopy, [&]() {
+        mask.erode(3);
+    });
+    bench.measure("MaskC1::perimeter(packed)", shape, width, height, packedCopy, [&]() {
+        mask.perimeter();
+    });
+    bench.measure("MaskC1::pack", shape, width, height, regionCopy, [&]() {
+        mask.pack();
+    });
+    bench.measure("MaskC1::unpack", shape, width, height, packedCopy, [&]() {
+        mask.unpack();
+    });
+}
+
+static void benchAnalysis(Benchmark& bench, const GeneratedImage& generated, const std::string& shape, const std::string& tmpDir) {
+    const cv::Mat& image = generated.image;
+    const cv::Point& seed = generated.seed;
+    const int width = image.cols;
+    const int height = image.rows;
+
+    ias::Analysis object;
+    object.setImage(image);
+
+    const auto findRegion = [&]() {
+        object.findRegion(seed, REGION_COLOR, TOLERANCE);
+    };
+
+    bench.measure("Analysis::findRegion", shape, width, height, Benchmark::Function(), findRegion);
+    bench.measure("Analysis::findPerimeter", shape, width, height, findRegion, [&]() {
+        object.findPerimeter();
+    });
+    bench.measure("Analysis::findSmoothPerimeter", shape, width, height, findRegion, [&]() {
+        object.findSmoothPerimeter();
+    });
+    bench.measure("Analysis::regionStats", shape, width, height, Benchmark::Function(), [&]() {
+        object.regionStats(seed, REGION_COLOR, TOLERANCE);
+    });
+
+    const std::string extensions[] = { "raw", "ppm" };
+    for (const std::string& extension: extensions) {
+        const std::string operation = "Analysis::loadImage(" + extension + ")";
+        if (bench.selected(operation) == false)
+            continue;
+        const std::string path = tmpDir + "/ias_bench_image." + extension;
+        if (ias::storeImage(image, path) == false) {
+            std::cerr << "unable to write file: " << path << std::endl;
+            continue;
+        }
+        ias::Analysis loader;
+        bench.measure(operation, shape, width, height, Benchmark::Function(), [&]() {
+            loader.loadImage(path);
+        });
+        std::remove( path.c_str() );
+    }
+
+    const std::string resultExtensions[] = { "png", "pbm", "rle" };
+    findRegion();
+    for (const std::string& extension: resultExtensions) {
+        const std::string path = tmpDir + "/ias_bench_result." + extension;
+        bench.measure("Analysis::storeResult(" + extension + ")", shape, width, height, Benchmark::Function(), [&]() {
+            object.storeResult(path);
+        });
+        std::remove( path.c_str() );
+    }
+}
+
+
+static void printHelp() {
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --help                  Help screen" << std::endl;
+    std::cout << "  --sizes=[MP,...]        Sizes of generated images in megapixels (default 1,10,100)" << std::endl;
+    std::cout << "  --shapes=[name,...]     Shapes of region: disc, squares, noise, serpentine (default all)" << std::endl;
+    std::cout << "  --repeats=[N]           Number of measurements of each operation (default 3)" << std::endl;
+    std::cout << "  --threads=[N]           Number of threads (0 - number of CPU cores, default 1)" << std::endl;
+    std::cout << "  --filter=[text]         Measure only operations containing 'text'" << std::endl;
+    std::cout << "  --tmp=[dir]             Directory of temporary files (default .)" << std::endl;
+    std::cout << "  --output=[path]         Write JSON results to file instead of standard output" << std::endl;
+}
+
+
+int main(int argc, char **argv) {
+    std::vector<std::string> sizes = splitList("1,10,100");
+    std::vector<Shape> shapes;
+    std::size_t repeats = 3;
+    std::string filter;
+    std::string tmpDir = ".";
+    std::string outputPath;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string param = argv[i];
+        const std::size_t separator = param.find('=');
+        const std::string name = param.substr(0, separator);
+        const std::string value = (separator == std::string::npos) ? "" : param.substr(separator + 1);
+
+        if (name.compare("--help") == 0) {
+            printHelp();
+            return 0;
+        } else if (name.compare("--sizes") == 0) {
+            sizes = splitList(value);
+        } else if (name.compare("--shapes") == 0) {
+            const std::vector<std::string> names = splitList(value);
+            for (std::size_t s = 0; s < names.size(); ++s) {
+                Shape shape;
+                if (parseShape(names[s], shape) == false) {
+                    std::cerr << "unknown shape: " << names[s] << std::endl;
+                    return 1;
+                }
+                shapes.push_back(shape);
+            }
+        } else if (name.compare("--repeats") == 0) {
+            repeats = std::max(1, atoi( value.c_str() ));
+        } else if (name.compare("--threads") == 0) {
+            ias::ThreadPool::global().resize( std::max(0, atoi( value.c_str() )) );
+        } else if (name.compare("--filter") == 0) {
+            filter = value;
+        } else if (name.compare("--tmp") == 0) {
+            tmpDir = value;
+        } else if (name.compare("--output") == 0) {
+            outputPath = value;
+        } else {
+            std::cerr << "unknown option: " << param << std::endl;
+            return 1;
+        }
+    }
+    if (shapes.empty()) {
+        for (int s = 0; s < SHAPE_COUNT; ++s) {
+            shapes.push_back( (Shape)s );
+        }
+    }
+
+    Benchmark bench(repeats, filter);
+    for (std::size_t i = 0; i < sizes.size(); ++i) {
+        const double megapixels = atof( sizes[i].c_str() );
+        if (megapixels <= 0.0) {
+            std::cerr << "invalid size: " << sizes[i] << std::endl;
+            return 1;
+        }
+        const cv::Size size = imageSize(megapixels);
+        for (std::size_t s = 0; s < shapes.size(); ++s) {
+            const GeneratedImage generated = generateImage( shapes[s], size.width, size.height );
+            const std::string shape = shapeName( shapes[s] );
+            benchMask(bench, generated, shape);
+            benchAnalysis(bench, generated, shape, tmpDir);
+        }
+    }
+
+    std::vector< std::pair<std::string, std::string> > properties;
+    std::ostringstream threads;
+    threads << ias::ThreadPool::global().size();
+    properties.push_back( std::make_pair( std::string("threads"), threads.str() ) );
+    properties.push_back( std::make_pair( std::string("binarize"), std::string("\"") + ias::binarizeInstructionSet() + "\"" ) );
+
+    if (outputPath.empty()) {
+        bench.writeJson(std::cout, properties);
+        return 0;
+    }
+    std::ofstream output( outputPath.c_str() );
+    bench.writeJson(output, properties);
+    if (output.fail()) {
+        std::cerr << "unable to write file: " << outputPath << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -24,20 +24,37 @@
 #ifndef ANALYSIS_H_
 #define ANALYSIS_H_
 
+#include <mutex>
 #include <string>
 
+#include "ias/ImageIO.h"
 #include "ias/MaskC1.h"
+#include "ias/MaskCache.h"
+#include "ias/RegionIndex.h"
+#include "ias/RegionQuery.h"
+#include "ias/RegionStats.h"
+#include "ias/RleMask.h"
 
 
 namespace ias {
 
     /**
+     * Operations on loaded image.
      *
+     * Const query methods (region(), perimeter(), smoothPerimeter(), findRegionRle(), regionStats())
+     * return result by value and can be called by many threads at once on the same object.
+     * Methods find*() are wrappers storing result of queries as last result. Loading image,
+     * indexRegions() and setMaskCacheBudget() can not be executed concurrently with queries.
      */
     class Analysis {
 
+        ImageFile imageFile;                        /// keeps memory of mapped image
         cv::Mat currentImage;
         MaskC1 lastResult;
+        RegionIndex regionIndex;
+        mutable MaskCache binarizedCache;           /// binarized images used by region()
+        mutable std::mutex cacheMutex;              /// guards "binarizedCache"
+        bool parallelFill;                          /// fill by parallel labeling of whole image
 
 
     public:
@@ -50,12 +67,18 @@ namespace ias {
             return currentImage;
         }
 
-        const cv::Mat& result() const {
+        /// packed result is converted to matrix
+        cv::Mat result() const {
             return lastResult.data();
         }
 
         bool loadImage(const std::string& imagePath);
 
+        /// use already decoded BGR image, releases data calculated for previous image
+        void setImage(const cv::Mat& image);
+
+        void setImage(const ImageFile& image);
+
         cv::Vec3b color(const int y, const int x ) const;
 
         cv::Vec3b color(const cv::Point& pixel) const;
@@ -65,15 +88,90 @@ namespace ias {
          * "color" in BGR format
          * Returns empty mask if failed, otherwise single channel mask in size of image.
          */
+        MaskC1 region(const cv::Point& pixelCoords, const cv::Vec3b& color, const uchar tolerance = 0) const;
+
+        /// store result of region() as last result
         void findRegion(const cv::Point& pixelCoords, const cv::Vec3b& color, const uchar tolerance = 0);
 
+        /**
+         * Get union of regions of many seeds and colors, all colors are classified in one pass over image
+         * (see ias::findRegions()). If "labelled" is set, pixels of region of "i"-th query are set to i+1.
+         * Returns empty mask if failed.
+         */
+        MaskC1 region(const std::vector<RegionQuery>& queries, const bool labelled = false) const;
+
+        /// store result of region() of many queries as last result
+        void findRegion(const std::vector<RegionQuery>& queries, const bool labelled = false);
+
+        /**
+         * Find region as run length encoded mask, without creating dense mask.
+         * Result is not stored as last result. Returns empty mask if no image is loaded.
+         */
+        RleMask findRegionRle(const cv::Point& pixelCoords, const cv::Vec3b& color, const uchar tolerance = 0) const;
+
+        /**
+         * Calculate statistics of region (area, bounding box, centroid, perimeter, touching border)
+         * from runs produced by fill, without creating dense mask. Result is not stored as last result.
+         */
+        RegionStats regionStats(const cv::Point& pixelCoords, const cv::Vec3b& color, const uchar tolerance = 0) const;
+
+        /**
+         * Set budget (in bytes) of cache of binarized images used by findRegion().
+         * Budget 0 (default) disables the cache. Cache is cleared when new image is loaded.
+         */
+        void setMaskCacheBudget(const std::size_t bytes);
+
+        /// statistics are not synchronized with running queries
+        const MaskCache& maskCache() const {
+            return binarizedCache;
+        }
+
+        /**
+         * Label all regions of "color" on loaded image. Following calls to findRegion()
+         * with the same color and tolerance are answered from the index.
+         * Index is released when new image is loaded.
+         */
+        void indexRegions(const cv::Vec3b& color, const uchar tolerance = 0);
+
+        const RegionIndex& regions() const {
+            return regionIndex;
+        }
+
+        /**
+         * Find regions by parallel connected component labeling of whole binarized image
+         * when thread pool has more than one thread. Default fill (disabled option) tests
+         * color only on pixels reached from seed, so its cost depends on size of region.
+         * Parallel labeling always processes whole image, it is faster only for regions
+         * covering big part of image.
+         */
+        void setParallelFill(const bool enabled) {
+            parallelFill = enabled;
+        }
+
+        bool parallelFillEnabled() const {
+            return parallelFill;
+        }
+
         /**
          * Get mask representing found perimeter(s).
+         * "connectivity" (4 or 8) defines which neighbours of region pixel are checked.
          * Returns empty mask if failed, otherwise single channel mask in size of image.
          */
-        void findPerimeter(const cv::Mat& regionsMask);
+        MaskC1 perimeter(const cv::Mat& regionsMask, const int connectivity = 8) const;
+
+        /// binary mask is packed, so perimeter is found on words
+        MaskC1 perimeter(const MaskC1& regionsMask, const int connectivity = 8) const;
+
+        /// get smooth contour of regions, returns empty mask if failed
+        MaskC1 smoothPerimeter(const cv::Mat& regionsMask) const;
+
+        MaskC1 smoothPerimeter(const MaskC1& regionsMask) const;
 
-        void findPerimeter();
+        /// store result of perimeter() as last result
+        void findPerimeter(const cv::Mat& regionsMask, const int connectivity = 8);
+
+        /// calculate perimeter of last result
+        void findPerimeter(const int connectivity = 8);
 
         void findSmoothPerimeter(const cv::Mat& regionsMask);
 
@@ -85,19 +183,15 @@ namespace ias {
 
         void displayJoin() const;
 
-        void storeResult(const std::string& outputPath) const;
-
-
-    private:
-
-        void detectEdges();
+        /// "compression" is level of PNG compression (0..9, -1 - default)
+        void storeResult(const std::string& outputPath, const int compression = -1) const;
 
 
     public:
 
         static void displayMat(const cv::Mat& matrix);
 
-        static void storeMat(const cv::Mat& matrix, const std::string& outputPath);
+        static void storeMat(const cv::Mat& matrix, const std::string& outputPath, const int compression = -1);
 
     };
 
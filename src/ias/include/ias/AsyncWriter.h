@@ -0,0 +1,85 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#ifndef ASYNCWRITER_H_
+#define ASYNCWRITER_H_
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include <opencv2/core/core.hpp>
+
+#include "ias/BoundedQueue.h"
+
+
+namespace ias {
+
+    /**
+     * Stores images to files on background thread, so caller can continue processing
+     * while previous result is being encoded. Images are written in order of calls.
+     * write() blocks while "capacity" images are waiting.
+     */
+    class AsyncWriter {
+
+        struct Job {
+            cv::Mat matrix;
+            std::string path;
+            int compression;
+        };
+
+        BoundedQueue<Job> queue;
+        std::atomic<std::size_t> failures;
+        std::thread thread;
+
+
+    public:
+
+        explicit AsyncWriter(const std::size_t capacity = 4);
+
+        /// waits for pending images
+        ~AsyncWriter();
+
+        /**
+         * Queue matrix to be stored with storeImage(). Data is shared with caller, so
+         * it must not be modified in place until stored (pooled buffers are not reused
+         * while queued). Set "copy" to queue copy of matrix instead.
+         */
+        void write(const cv::Mat& matrix, const std::string& path, const int compression = -1, const bool copy = false);
+
+        /// wait for pending images, returns number of images that could not be stored
+        std::size_t close();
+
+
+    private:
+
+        void run();
+
+        AsyncWriter(const AsyncWriter&);
+
+        AsyncWriter& operator=(const AsyncWriter&);
+
+    };
+
+} /* namespace ias */
+#endif /* ASYNCWRITER_H_ */
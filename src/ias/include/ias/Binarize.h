@@ -0,0 +1,58 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#ifndef BINARIZE_H_
+#define BINARIZE_H_
+
+#include <opencv2/core/core.hpp>
+
+
+namespace ias {
+
+    /// compare each color component separately
+    inline bool isColorSame(const cv::Vec3b& color, const cv::Vec3b& pixel, const uchar tolerance ) {
+        for (int i = 0; i < 3; ++i) {
+            const uchar diff = std::abs( color(i) - pixel(i) );
+            if (diff > tolerance)
+                return false;
+        }
+        return true;
+    }
+
+    /**
+     * Binarize row of BGR pixels. Output pixel is set to 255 if each color component
+     * differs from "color" at most by "tolerance", otherwise it is set to 0.
+     *
+     * Uses SSE2 or AVX2 kernel if available on running CPU, otherwise scalar code.
+     * All implementations give identical results.
+     */
+    void binarizeRow(const cv::Vec3b* row, uchar* out, const int width, const cv::Vec3b& color, const uchar tolerance);
+
+    /// scalar implementation, used as reference and for row tails
+    void binarizeRowScalar(const cv::Vec3b* row, uchar* out, const int width, const cv::Vec3b& color, const uchar tolerance);
+
+    /// name of instruction set selected by binarizeRow(), e.g. "avx2"
+    const char* binarizeInstructionSet();
+
+} /* namespace ias */
+#endif /* BINARIZE_H_ */
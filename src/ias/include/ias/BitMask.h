@@ -0,0 +1,148 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#ifndef BITMASK_H_
+#define BITMASK_H_
+
+#include <cstdint>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+
+namespace ias {
+
+    /**
+     * Binary mask stored with 1 bit per pixel (64 pixels per word).
+     *
+     * Packed storage of MaskC1, provides the same operations working on whole words.
+     * Pixels are seen as 0 or 255 values, any non-zero value is stored as 255. Conversion
+     * from/to cv::Mat is done only by constructor, load() and toMat().
+     * Bits after last column of row are always kept zero.
+     */
+    class BitMask {
+        int nRows;
+        int nCols;
+        int nWords;                         /// words per row
+        std::vector<uint64_t> bits;
+
+    public:
+
+        BitMask(): nRows(0), nCols(0), nWords(0), bits() {
+        }
+
+        BitMask(const int width, const int height, const uchar value = 0);
+
+        /// non-zero pixels of CV_8UC1 matrix are set
+        explicit BitMask(const cv::Mat& matrix);
+
+        /// CV_8UC1 matrix of 0 and 255 values
+        cv::Mat toMat() const;
+
+        /// write pixels to CV_8UC1 matrix of size of mask
+        void toMat(cv::Mat& matrix) const;
+
+        /// returns true if matrix contains only 0 and 255 values, so conversion does not lose information
+        bool load(const cv::Mat& matrix);
+
+        bool empty() const {
+            return bits.empty();
+        }
+
+        int rows() const {
+            return nRows;
+        }
+
+        int cols() const {
+            return nCols;
+        }
+
+        int wordsPerRow() const {
+            return nWords;
+        }
+
+        /// size of packed data
+        std::size_t bytes() const {
+            return bits.size() * sizeof(uint64_t);
+        }
+
+        const uint64_t* row(const int y) const {
+            return &bits[ (std::size_t)y * nWords ];
+        }
+
+        uint64_t* row(const int y) {
+            return &bits[ (std::size_t)y * nWords ];
+        }
+
+        uchar get(const int x, const int y) const {
+            return ( (row(y)[x / 64] >> (x % 64)) & 1 ) ? 255 : 0;
+        }
+
+        void set(const int x, const int y, const uchar val) {
+            const uint64_t bit = (uint64_t)1 << (x % 64);
+            if (val != 0)
+                row(y)[x / 64] |= bit;
+            else
+                row(y)[x / 64] &= ~bit;
+        }
+
+        /// set pixels from "left" to "right" (inclusive) of row "y"
+        void setRun(const int y, const int left, const int right);
+
+        /// number of set pixels
+        std::size_t count() const;
+
+        void changeColor(const uchar from, const uchar to);
+
+        void threshold(const uchar thresh);
+
+        void dilate(const int size = 3, const std::size_t repeats = 1);
+
+        void dilate(const cv::Size& element, const std::size_t repeats = 1);
+
+        void erode(const int size = 3, const std::size_t repeats = 1);
+
+        void erode(const cv::Size& element, const std::size_t repeats = 1);
+
+        /**
+         * Keep only boundary pixels: set pixels having at least one unset neighbour
+         * (pixels outside of mask are unset). "connectivity" is 4 or 8.
+         * For 8-connectivity result is the same as thresholded Laplace filter.
+         */
+        void perimeter(const int connectivity = 8);
+
+
+    private:
+
+        /// mask of valid bits in last word of row
+        uint64_t lastWordMask() const;
+
+        void fill(const bool value);
+
+        template<typename Op>
+        void morphology(const cv::Size& element, const std::size_t repeats);
+
+    };
+
+} /* namespace ias */
+#endif /* BITMASK_H_ */
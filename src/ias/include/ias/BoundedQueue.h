@@ -0,0 +1,97 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#ifndef BOUNDEDQUEUE_H_
+#define BOUNDEDQUEUE_H_
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+
+namespace ias {
+
+    /**
+     * Thread safe FIFO queue with limited capacity, connects stages of pipeline.
+     *
+     * push() blocks while queue is full, pop() blocks while queue is empty.
+     * After close() no more items are accepted and pop() returns remaining items,
+     * then fails.
+     */
+    template<typename T>
+    class BoundedQueue {
+
+        std::deque<T> items;
+        const std::size_t capacity;
+        bool closed;
+        std::mutex mutex;
+        std::condition_variable notFull;
+        std::condition_variable notEmpty;
+
+
+    public:
+
+        explicit BoundedQueue(const std::size_t maxSize): items(), capacity( (maxSize < 1) ? 1 : maxSize ), closed(false), mutex(), notFull(), notEmpty() {
+        }
+
+        /// returns false if queue is closed
+        bool push(const T& item) {
+            std::unique_lock<std::mutex> lock(mutex);
+            notFull.wait(lock, [this]() { return closed || items.size() < capacity; });
+            if (closed) {
+                return false;
+            }
+            items.push_back(item);
+            notEmpty.notify_one();
+            return true;
+        }
+
+        /// returns false if queue is closed and empty
+        bool pop(T& item) {
+            std::unique_lock<std::mutex> lock(mutex);
+            notEmpty.wait(lock, [this]() { return closed || items.empty() == false; });
+            if (items.empty()) {
+                return false;
+            }
+            item = items.front();
+            items.pop_front();
+            notFull.notify_one();
+            return true;
+        }
+
+        void close() {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+            notFull.notify_all();
+            notEmpty.notify_all();
+        }
+
+        std::size_t size() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return items.size();
+        }
+
+    };
+
+} /* namespace ias */
+#endif /* BOUNDEDQUEUE_H_ */
@@ -0,0 +1,111 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#ifndef BUFFERPOOL_H_
+#define BUFFERPOOL_H_
+
+#include <list>
+#include <mutex>
+
+#include <opencv2/core/core.hpp>
+
+
+namespace ias {
+
+    /**
+     * Pool of released matrices reused by following operations of the same size and type.
+     *
+     * Matrix is taken to pool only if no other header shares its data, so buffer still used
+     * by caller is never handed out again. Size of pool is limited by budget in bytes, oldest
+     * buffers are freed when budget is exceeded. Budget 0 disables the pool. Pool is thread safe.
+     */
+    class BufferPool {
+
+        mutable std::mutex mutex;
+        std::list<cv::Mat> buffers;                 /// most recently released first
+        std::size_t budgetBytes;
+        std::size_t usedBytes;
+        std::size_t acquireCount;
+        std::size_t allocationCount;
+        std::size_t releaseCount;
+
+
+    public:
+
+        static const std::size_t DEFAULT_BUDGET = 256 * 1024 * 1024;
+
+
+        explicit BufferPool(const std::size_t budget = DEFAULT_BUDGET);
+
+        /// pool used by MaskC1 operations
+        static BufferPool& global();
+
+        /// check if "matrix" is only header of its continuous data allocated by OpenCV
+        static bool exclusive(const cv::Mat& matrix);
+
+        std::size_t budget() const;
+
+        /// set budget in bytes, buffers exceeding new budget are freed
+        void setBudget(const std::size_t budget);
+
+        /**
+         * Get matrix from pool or allocate new one if pool has no buffer of given size and type.
+         * Content of matrix is undefined.
+         */
+        cv::Mat acquire(const int rows, const int cols, const int type);
+
+        /**
+         * Return matrix to pool, "matrix" is empty after the call. Returns false if matrix
+         * was not taken to pool (data is shared or matrix is bigger than budget).
+         */
+        bool release(cv::Mat& matrix);
+
+        /// number of pooled buffers
+        std::size_t size() const;
+
+        /// bytes of pooled buffers
+        std::size_t bytes() const;
+
+        std::size_t acquires() const;
+
+        /// number of acquires served by new allocation
+        std::size_t allocations() const;
+
+        /// number of buffers taken to pool
+        std::size_t releases() const;
+
+        /// free all buffers, statistics are kept
+        void clear();
+
+        void resetStats();
+
+
+    private:
+
+        void evict(const std::size_t budget);
+
+    };
+
+} /* namespace ias */
+#endif /* BUFFERPOOL_H_ */
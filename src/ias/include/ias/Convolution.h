@@ -0,0 +1,100 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#ifndef CONVOLUTION_H_
+#define CONVOLUTION_H_
+
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+
+namespace ias {
+
+    /**
+     * Convolution of single channel 8-bit matrix with user defined filter.
+     *
+     * Pixels outside of matrix are treated as zeros, result is saturated to [0..255]
+     * and truncated towards zero. Filter is analysed once in constructor:
+     * - filters with integer (or n/2^k) coefficients are computed with integer arithmetic,
+     * - separable integer filters are computed as two 1-D passes,
+     * - other filters are computed in double precision in the same order as naive implementation.
+     * Interior of matrix is processed without any bounds checking, border pixels take slow path.
+     */
+    class Convolution {
+
+        /// non-zero element of filter
+        template<typename T>
+        struct Tap {
+            int dy;
+            int dx;
+            T coeff;
+        };
+
+        int fRows;
+        int fCols;
+        int anchorY;
+        int anchorX;
+
+        bool integer;
+        int shift;                                  /// integer result is divided by 2^shift
+        std::vector< Tap<int> > intTaps;
+        std::vector< Tap<double> > realTaps;
+
+        bool separable;
+        std::vector<int> rowKernel;                 /// horizontal pass
+        std::vector<int> colKernel;                 /// vertical pass
+
+
+    public:
+
+        explicit Convolution(const cv::Mat& filter);
+
+        bool isInteger() const {
+            return integer;
+        }
+
+        bool isSeparable() const {
+            return separable;
+        }
+
+        /// "target" is (re)allocated if needed, it can not share data with "source"
+        void apply(const cv::Mat& source, cv::Mat& target) const;
+
+
+    private:
+
+        void detectInteger();
+
+        void detectSeparable();
+
+        void applyTaps(const cv::Mat& source, cv::Mat& target, const cv::Range& rows) const;
+
+        void applyReal(const cv::Mat& source, cv::Mat& target, const cv::Range& rows) const;
+
+        void applySeparable(const cv::Mat& source, cv::Mat& target, const cv::Range& rows) const;
+
+    };
+
+} /* namespace ias */
+#endif /* CONVOLUTION_H_ */
@@ -0,0 +1,184 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#ifndef IMAGEIO_H_
+#define IMAGEIO_H_
+
+#include <string>
+#include <memory>
+#include <cstdio>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+#include "ias/MappedFile.h"
+
+
+namespace ias {
+
+    /**
+     * Layout of uncompressed image file.
+     *
+     * Headered raw format ("IASR") is 16 bytes of header: magic "IASR", width, height
+     * and number of channels (1 or 3) as 32-bit little-endian integers, followed by rows
+     * of pixels (BGR order for 3 channels) without padding. PBM rows are bit-packed,
+     * zero bit is white (255) pixel. PGM/PPM samples are scaled from [0, maxValue] to [0, 255].
+     */
+    struct ImageLayout {
+        enum Format {
+            UNKNOWN,
+            RAW,                            /// "IASR" headered raw
+            PPM,                            /// binary PPM (P6), RGB order
+            PGM,                            /// binary PGM (P5)
+            PBM,                            /// binary PBM (P4), single bit per pixel
+            RLE                             /// run length encoded mask ("IASL"), rows of variable size
+        };
+
+        Format format;
+        int width;
+        int height;
+        int channels;
+        std::size_t offset;                 /// position of first pixel
+        int maxValue;                       /// maximal sample value of PGM/PPM file
+
+        ImageLayout(): format(UNKNOWN), width(0), height(0), channels(0), offset(0), maxValue(255) {
+        }
+
+        std::size_t rowSize() const {
+            if (format == PBM)
+                return ((std::size_t)width + 7) / 8;
+            return (std::size_t)width * channels;
+        }
+
+        /// parse header of file, returns false if format is not supported or data is too short
+        bool parse(const uchar* data, const std::size_t size);
+
+        /// convert row of file to BGR pixels
+        void convertRow(const uchar* row, cv::Vec3b* out) const;
+    };
+
+
+    /**
+     * BGR image loaded from file.
+     *
+     * Uncompressed files are memory mapped instead of decoding: raw BGR files are used
+     * in place without copying, PPM/PGM/PBM files are converted to BGR in one pass.
+     * Run length encoded masks are decoded. Other formats are decoded with cv::imread. Copies share mapping, mapping is
+     * released with the last copy.
+     */
+    class ImageFile {
+
+        std::shared_ptr<MappedFile> mapping;
+        cv::Mat matrix;
+
+
+    public:
+
+        ImageFile(): mapping(), matrix() {
+        }
+
+        /// wrap already decoded image
+        explicit ImageFile(const cv::Mat& image): mapping(), matrix(image) {
+        }
+
+        bool load(const std::string& path);
+
+        void release();
+
+        bool empty() const {
+            return matrix.empty();
+        }
+
+        const cv::Mat& image() const {
+            return matrix;
+        }
+
+        /// check if image uses memory of mapped file directly
+        bool mapped() const {
+            return (bool)mapping;
+        }
+
+
+    private:
+
+        bool decode(const std::string& path);
+
+    };
+
+
+    /**
+     * Writes image row by row to headered raw (".raw") or PGM/PPM file, so whole image
+     * does not have to be kept in memory. Masks (single channel) can be written also
+     * to PBM (".pbm") and run length encoded (".rle") file, non-zero pixels are set.
+     */
+    class RowWriter {
+
+        std::FILE* file;
+        ImageLayout layout;
+        int rowsLeft;
+        std::vector<uchar> buffer;          /// converted row
+        bool valid;
+
+
+    public:
+
+        RowWriter(): file(NULL), layout(), rowsLeft(0), buffer(), valid(false) {
+        }
+
+        ~RowWriter() {
+            close();
+        }
+
+        /// create file and write header, returns false if format is not supported
+        bool open(const std::string& path, const int width, const int height, const int channels);
+
+        /// write next row of pixels (BGR order for 3 channels)
+        bool write(const uchar* row);
+
+        /// returns false if any write failed or not all rows were written
+        bool close();
+
+
+    private:
+
+        RowWriter(const RowWriter&);
+
+        RowWriter& operator=(const RowWriter&);
+
+    };
+
+
+    /**
+     * Store matrix to file. Files with extension ".raw" are stored in headered raw format,
+     * ".pgm" (single channel) and ".ppm" (three channels) are written as binary PNM,
+     * ".pbm" and ".rle" (single channel) as bilevel masks, all of them directly from
+     * matrix rows. Binary masks (values 0 and 255) stored to ".png" are encoded as
+     * 1-bit PNG. Other formats are encoded with cv::imwrite.
+     *
+     * "compression" is level of PNG compression (0..9, -1 - default: level 6 for 1-bit PNG,
+     * default level of cv::imwrite for other images).
+     */
+    bool storeImage(const cv::Mat& matrix, const std::string& path, const int compression = -1);
+
+} /* namespace ias */
+#endif /* IMAGEIO_H_ */
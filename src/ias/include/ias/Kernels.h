@@ -0,0 +1,170 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#ifndef KERNELS_H_
+#define KERNELS_H_
+
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+
+namespace ias {
+
+    /**
+     * 3x3 filter known at compile time. Result of convolution is divided by 2^Shift.
+     * Coefficients are template parameters, so convolution loop is unrolled
+     * and zero taps are removed by compiler.
+     */
+    template<int K00, int K01, int K02,
+             int K10, int K11, int K12,
+             int K20, int K21, int K22,
+             int Shift>
+    struct Kernel3x3 {
+        static constexpr int k00 = K00;
+        static constexpr int k01 = K01;
+        static constexpr int k02 = K02;
+        static constexpr int k10 = K10;
+        static constexpr int k11 = K11;
+        static constexpr int k12 = K12;
+        static constexpr int k20 = K20;
+        static constexpr int k21 = K21;
+        static constexpr int k22 = K22;
+        static constexpr int shift = Shift;
+
+        static cv::Mat matrix() {
+            cv::Mat filter = cv::Mat::zeros( 3, 3, CV_64F );
+            filter.at<double>(0,0) = K00;
+            filter.at<double>(0,1) = K01;
+            filter.at<double>(0,2) = K02;
+            filter.at<double>(1,0) = K10;
+            filter.at<double>(1,1) = K11;
+            filter.at<double>(1,2) = K12;
+            filter.at<double>(2,0) = K20;
+            filter.at<double>(2,1) = K21;
+            filter.at<double>(2,2) = K22;
+            filter /= (1 << Shift);
+            return filter;
+        }
+    };
+
+    /// Laplace filter (8-neighbour)
+    typedef Kernel3x3< -1, -1, -1,
+                       -1,  8, -1,
+                       -1, -1, -1,  0 > LaplaceKernel;
+
+    /// Laplace filter (4-neighbour)
+    typedef Kernel3x3<  0, -1,  0,
+                       -1,  4, -1,
+                        0, -1,  0,  0 > Laplace4Kernel;
+
+    /// Gaussian blur
+    typedef Kernel3x3<  1,  2,  1,
+                        2,  4,  2,
+                        1,  2,  1,  4 > GaussianKernel;
+
+    /// sum of neighbourhood
+    typedef Kernel3x3<  1,  1,  1,
+                        1,  1,  1,
+                        1,  1,  1,  0 > BoxKernel;
+
+
+    template<typename Kernel>
+    inline uchar saturateKernel(const int sum) {
+        if (sum < 0)
+            return 0;
+        const int value = sum >> Kernel::shift;
+        if (value > 255)
+            return 255;
+        return value;
+    }
+
+    /**
+     * Convolve single row of 8-bit data. Rows "above" and "below" can point to zero row
+     * for first and last row of matrix. Pixels outside of row are treated as zeros.
+     */
+    template<typename Kernel>
+    void convolveRow3x3(const uchar* above, const uchar* row, const uchar* below, uchar* out, const int nCols) {
+        if (nCols < 1) {
+            return ;
+        }
+        if (nCols == 1) {
+            const int sum = Kernel::k01 * above[0] + Kernel::k11 * row[0] + Kernel::k21 * below[0];
+            out[0] = saturateKernel<Kernel>( sum );
+            return ;
+        }
+
+        /// first pixel has no left neighbour
+        {
+            const int sum = Kernel::k01 * above[0] + Kernel::k02 * above[1] +
+                            Kernel::k11 * row[0]   + Kernel::k12 * row[1]   +
+                            Kernel::k21 * below[0] + Kernel::k22 * below[1];
+            out[0] = saturateKernel<Kernel>( sum );
+        }
+
+        for (int x = 1; x < nCols - 1; ++x) {
+            const int sum = Kernel::k00 * above[x-1] + Kernel::k01 * above[x] + Kernel::k02 * above[x+1] +
+                            Kernel::k10 * row[x-1]   + Kernel::k11 * row[x]   + Kernel::k12 * row[x+1]   +
+                            Kernel::k20 * below[x-1] + Kernel::k21 * below[x] + Kernel::k22 * below[x+1];
+            out[x] = saturateKernel<Kernel>( sum );
+        }
+
+        /// last pixel has no right neighbour
+        {
+            const int x = nCols - 1;
+            const int sum = Kernel::k00 * above[x-1] + Kernel::k01 * above[x] +
+                            Kernel::k10 * row[x-1]   + Kernel::k11 * row[x]   +
+                            Kernel::k20 * below[x-1] + Kernel::k21 * below[x];
+            out[x] = saturateKernel<Kernel>( sum );
+        }
+    }
+
+    /// convolve only "rows" of matrix, "target" has to be allocated already
+    template<typename Kernel>
+    void convolve3x3(const cv::Mat& source, cv::Mat& target, const cv::Range& rows) {
+        const int nRows = source.rows;
+        const int nCols = source.cols;
+
+        const std::vector<uchar> zeros( nCols, 0 );
+        const uchar* zeroRow = zeros.data();
+
+        for (int y = rows.start; y < rows.end; ++y) {
+            const uchar* above = (y > 0) ? source.ptr<uchar>(y-1) : zeroRow;
+            const uchar* below = (y < nRows-1) ? source.ptr<uchar>(y+1) : zeroRow;
+            convolveRow3x3<Kernel>( above, source.ptr<uchar>(y), below, target.ptr<uchar>(y), nCols );
+        }
+    }
+
+    /**
+     * Convolve 8-bit single channel matrix with compile time kernel. Pixels outside of matrix
+     * are treated as zeros. Result is the same as Convolution with Kernel::matrix().
+     * "target" can not share data with "source".
+     */
+    template<typename Kernel>
+    void convolve3x3(const cv::Mat& source, cv::Mat& target) {
+        target.create( source.rows, source.cols, CV_8UC1 );
+        convolve3x3<Kernel>( source, target, cv::Range(0, source.rows) );
+    }
+
+} /* namespace ias */
+#endif /* KERNELS_H_ */
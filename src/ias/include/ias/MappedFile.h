@@ -0,0 +1,90 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#ifndef MAPPEDFILE_H_
+#define MAPPEDFILE_H_
+
+#include <string>
+
+#include <opencv2/core/core.hpp>
+
+
+namespace ias {
+
+    /**
+     * File mapped into memory (POSIX mmap).
+     *
+     * By default file is mapped read-only and shared, so pages are backed by the file
+     * and file bigger than RAM and swap can be mapped. Writable mapping is private:
+     * writing to the memory does not change the file, but whole file is counted as
+     * committed memory, so mapping of big file can fail (ENOMEM).
+     */
+    class MappedFile {
+
+        uchar* address;
+        std::size_t length;
+        bool writable;
+
+
+    public:
+
+        MappedFile(): address(NULL), length(0), writable(false) {
+        }
+
+        ~MappedFile() {
+            close();
+        }
+
+        /// map whole file, returns false if file could not be mapped
+        bool open(const std::string& path, const bool writableCopy = false);
+
+        void close();
+
+        bool empty() const {
+            return (address == NULL);
+        }
+
+        const uchar* data() const {
+            return address;
+        }
+
+        /// returns NULL if file is mapped read-only
+        uchar* writableData() {
+            return writable ? address : NULL;
+        }
+
+        std::size_t size() const {
+            return length;
+        }
+
+
+    private:
+
+        MappedFile(const MappedFile&);
+
+        MappedFile& operator=(const MappedFile&);
+
+    };
+
+} /* namespace ias */
+#endif /* MAPPEDFILE_H_ */
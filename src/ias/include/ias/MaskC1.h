@@ -24,38 +24,102 @@
 #ifndef MASKC1_H_
 #define MASKC1_H_
 
+#include <utility>
+
 #include <opencv2/core/core.hpp>
 
+#include "ias/BitMask.h"
+#include "ias/BufferPool.h"
+
 
 namespace ias {
 
     /**
      * Class implementing basic operations on image, e.g. thresholding, filtering, changing colors etc.
+     *
+     * Operations producing new matrix (filters, morphology) take target buffer from global BufferPool
+     * and return previous buffer to the pool, so repeated operations swap two buffers. Mask not shared
+     * with other matrices is returned to the pool also when it is replaced or destroyed.
+     *
+     * Binary mask (only 0 and 255 values) can be stored packed with 1 bit per pixel (see BitMask),
+     * then get(), set(), changeColor(), threshold(), morphology and perimeter() work on 64-pixel words.
+     * Regions extracted by fill are created packed. Packed mask is converted to matrix only when
+     * its data is read (data(), operator*) or when operation can produce other values (filters,
+     * flood fill, setting value other than 0 and 255). Copies of packed mask do not share data.
      */
     class MaskC1 {
         cv::Mat mask;
+        BitMask bits;                       /// packed storage, used instead of "mask" if not empty
 
     public:
 
-        MaskC1(): mask() {
+        MaskC1(): mask(), bits() {
         }
 
-        MaskC1(const int width, const int height): mask() {
+        MaskC1(const int width, const int height): mask(), bits() {
             mask = cv::Mat::zeros( height, width, CV_8UC1 );
         }
 
-        MaskC1(const int width, const int height, const uchar value): mask() {
+        MaskC1(const int width, const int height, const uchar value): mask(), bits() {
             mask = cv::Mat::ones( height, width, CV_8UC1 ) * value;
         }
 
-        MaskC1(const cv::Mat& matrix): mask(matrix) {
+        MaskC1(const cv::Mat& matrix): mask(matrix), bits() {
+        }
+
+        /// packed mask
+        explicit MaskC1(BitMask packedMask): mask(), bits( std::move(packedMask) ) {
+        }
+
+        MaskC1(const MaskC1& other): mask(other.mask), bits(other.bits) {
+        }
+
+        MaskC1(MaskC1&& other): mask(), bits() {
+            std::swap(mask, other.mask);
+            std::swap(bits, other.bits);
+        }
+
+        ~MaskC1() {
+            BufferPool::global().release(mask);
+        }
+
+        MaskC1& operator=(const MaskC1& other) {
+            cv::Mat previous = mask;
+            mask = other.mask;
+            bits = other.bits;
+            BufferPool::global().release(previous);
+            return *this;
+        }
+
+        MaskC1& operator=(MaskC1&& other) {
+            cv::Mat previous = mask;
+            mask = other.mask;
+            other.mask = cv::Mat();
+            bits = std::move(other.bits);
+            other.bits = BitMask();
+            BufferPool::global().release(previous);
+            return *this;
         }
 
         /// binarize RGB image
         MaskC1(const cv::Mat& image, const cv::Vec3b& color, const uchar tolerance);
 
-        const cv::Mat& operator*() const {
-            return mask;
+        /**
+         * Extract region of "color" containing "seed" pixel from RGB image. Region is set to 255, rest of mask to 0.
+         * Color is compared only on pixels reached by the fill, so cost depends on region size, not on image size.
+         * Gives the same result as binarizing image and flood filling the mask.
+         */
+        MaskC1(const cv::Mat& image, const cv::Point& seed, const cv::Vec3b& color, const uchar tolerance);
+
+        /**
+         * Extract region of pixels equal to "value" containing "seed" from single channel mask.
+         * Region is set to 255, rest of mask to 0. Cost depends on region size, not on mask size.
+         */
+        MaskC1(const cv::Mat& source, const cv::Point& seed, const uchar value);
+
+        /// matrix of mask, packed mask is converted to new matrix
+        cv::Mat operator*() const {
+            return data();
         }
 
 //        cv::Mat& operator*() {
@@ -63,45 +127,108 @@ namespace ias {
 //        }
 
         bool empty() const {
-            return mask.empty();
+            return mask.empty() && bits.empty();
         }
 
-        const cv::Mat& data() const {
-            return mask;
+        cv::Size size() const {
+            return packed() ? cv::Size( bits.cols(), bits.rows() ) : mask.size();
         }
 
+        /// matrix of mask, packed mask is converted to new matrix
+        cv::Mat data() const {
+            return packed() ? bits.toMat() : mask;
+        }
+
+        bool packed() const {
+            return !bits.empty();
+        }
+
+        /// packed storage, empty if mask is not packed
+        const BitMask& packedData() const {
+            return bits;
+        }
+
+        /**
+         * Store mask with 1 bit per pixel. Mask is not changed if it contains values other
+         * than 0 and 255. Returns true if mask is packed.
+         */
+        bool pack();
+
+        /// store packed mask as CV_8UC1 matrix taken from BufferPool
+        void unpack();
+
 //        cv::Mat& data() {
 //            return mask;
 //        }
 
         void invalidate() {
-            mask = cv::Mat();
+            BufferPool::global().release(mask);
+            bits = BitMask();
         }
 
         uchar get(const int x, const int y) const {
+            if (packed())
+                return bits.get(x, y);
             return mask.at<uchar>(y, x);
         }
 
         void set(const int x, const int y, const uchar val) {
+            if (packed()) {
+                if (val == 0 || val == 255) {
+                    bits.set(x, y, val);
+                    return ;
+                }
+                unpack();
+            }
             mask.at<uchar>(y, x) = val;
         }
 
         void changeColor(const uchar from, const uchar to);
 
+        /**
+         * Change pixels of "color" connected (4-connectivity) with "startCoords" to "target".
+         * Remaining pixels of "color" are changed to "zero".
+         */
         void floodFill(const cv::Point& startCoords, const uchar color, const uchar target, const uint zero);
 
+        /**
+         * Gives the same result as floodFill(), but uses connected component labeling
+         * executed in parallel on global ThreadPool.
+         */
+        void floodFillParallel(const cv::Point& startCoords, const uchar color, const uchar target, const uint zero);
+
         void applyFilter(const cv::Mat& filter);
 
+        /// apply compile time kernel (LaplaceKernel, Laplace4Kernel, GaussianKernel or BoxKernel from "ias/Kernels.h")
+        template<typename Kernel>
+        void applyFilter();
+
         void threshold(const uchar thresh);
 
+        /**
+         * Morphological operations with rectangular element (maximum/minimum of neighbourhood).
+         * Pixels outside of mask are treated as zeros. Cost per pixel does not depend on element size,
+         * repeats are merged into single larger element.
+         */
         void dilate(const int size = 3, const std::size_t repeats = 1);
 
+        void dilate(const cv::Size& element, const std::size_t repeats = 1);
+
         void erode(const int size = 3, const std::size_t repeats = 1);
 
+        void erode(const cv::Size& element, const std::size_t repeats = 1);
+
+        /**
+         * Keep only boundary pixels of regions. "connectivity" (4 or 8) defines which neighbours
+         * are checked. Packed mask is processed on words, other masks by thresholded Laplace filter.
+         */
+        void perimeter(const int connectivity = 8);
+
 
     private:
 
-        double apply(const cv::Mat& filter, const int y, const int x);
+        /// use "buffer" as mask, previous mask is returned to BufferPool
+        void swapBuffer(cv::Mat& buffer);
 
     };
 
@@ -0,0 +1,106 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#ifndef MASKCACHE_H_
+#define MASKCACHE_H_
+
+#include <list>
+
+#include <opencv2/core/core.hpp>
+
+
+namespace ias {
+
+    /**
+     * Least recently used cache of binarized masks keyed by color and tolerance.
+     *
+     * Size of cache is limited by budget in bytes, least recently used masks are
+     * released when budget is exceeded. Budget 0 disables the cache.
+     */
+    class MaskCache {
+
+        struct Entry {
+            cv::Vec3b color;
+            uchar tolerance;
+            cv::Mat mask;
+        };
+
+        std::list<Entry> entries;           /// most recently used first
+        std::size_t budgetBytes;
+        std::size_t usedBytes;
+        std::size_t hitCount;
+        std::size_t missCount;
+
+
+    public:
+
+        explicit MaskCache(const std::size_t budget = 0);
+
+        bool enabled() const {
+            return (budgetBytes > 0);
+        }
+
+        std::size_t budget() const {
+            return budgetBytes;
+        }
+
+        /// set budget in bytes, masks exceeding new budget are released
+        void setBudget(const std::size_t budget);
+
+        /// number of cached masks
+        std::size_t size() const {
+            return entries.size();
+        }
+
+        std::size_t bytes() const {
+            return usedBytes;
+        }
+
+        std::size_t hits() const {
+            return hitCount;
+        }
+
+        std::size_t misses() const {
+            return missCount;
+        }
+
+        /// get cached mask (updates statistics), returns empty matrix if not found
+        cv::Mat find(const cv::Vec3b& color, const uchar tolerance);
+
+        /// store mask, masks bigger than budget are not stored
+        void insert(const cv::Vec3b& color, const uchar tolerance, const cv::Mat& mask);
+
+        /// release all masks, statistics are kept
+        void clear();
+
+        void resetStats();
+
+
+    private:
+
+        void evict(const std::size_t budget);
+
+    };
+
+} /* namespace ias */
+#endif /* MASKCACHE_H_ */
@@ -0,0 +1,78 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#ifndef MASKCODEC_H_
+#define MASKCODEC_H_
+
+#include <cstdint>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+
+namespace ias {
+
+    /// compression level of 1-bit PNG used when level is not given (-1)
+    static const int DEFAULT_COMPRESSION = 6;
+
+
+    /// check if matrix is CV_8UC1 containing only values 0 and 255
+    bool isBinaryMask(const cv::Mat& matrix);
+
+    /**
+     * Encode binary mask to 1-bit grayscale PNG. Non-zero pixels are white.
+     * Image data is compressed by zlib with given level (-1 for default).
+     */
+    void encodeBilevelPng(const cv::Mat& mask, const int level, std::vector<uchar>& out);
+
+
+    /**
+     * Run length encoding of mask rows ("IASL" format).
+     *
+     * File is 12 bytes of header: magic "IASL", width and height as 32-bit little-endian
+     * integers, followed by rows. Each row is sequence of lengths of runs alternately
+     * of zero and non-zero pixels, starting with zero pixels (first run can be empty).
+     * Lengths are stored as LEB128 varints and sum up to width, so empty row of any
+     * width takes few bytes. Non-zero pixels are decoded as 255.
+     */
+    static const std::size_t RLE_HEADER_SIZE = 12;
+
+    void encodeRleHeader(const int width, const int height, std::vector<uchar>& out);
+
+    /// read header, returns false if data is not run length encoded mask
+    bool decodeRleHeader(const uchar* data, const std::size_t size, int& width, int& height);
+
+    /// append LEB128 varint
+    void appendVarint(std::vector<uchar>& out, uint32_t value);
+
+    /// read LEB128 varint at "pos" and move "pos" after it, returns false if data is not valid
+    bool readVarint(const uchar* data, const std::size_t size, std::size_t& pos, uint32_t& value);
+
+    /// append encoded row
+    void encodeRleRow(const uchar* row, const int width, std::vector<uchar>& out);
+
+    /// decode whole file, returns false if data is not valid
+    bool decodeRle(const uchar* data, const std::size_t size, cv::Mat& mask);
+
+} /* namespace ias */
+#endif /* MASKCODEC_H_ */
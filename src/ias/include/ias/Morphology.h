@@ -0,0 +1,85 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#ifndef MORPHOLOGY_H_
+#define MORPHOLOGY_H_
+
+#include <opencv2/core/core.hpp>
+
+
+namespace ias {
+
+    /// operations of erosion and dilation, shared by whole-image and row-streaming morphology
+    struct MinOp {
+        static inline uchar apply(const uchar a, const uchar b) {
+            return (a < b) ? a : b;
+        }
+    };
+
+    struct MaxOp {
+        static inline uchar apply(const uchar a, const uchar b) {
+            return (a > b) ? a : b;
+        }
+    };
+
+    /**
+     * Rectangular structuring element. Element covers pixels [x - left, x + right] and [y - top, y + bottom].
+     */
+    struct StructuringElement {
+        int left;
+        int right;
+        int top;
+        int bottom;
+
+        StructuringElement(): left(0), right(0), top(0), bottom(0) {
+        }
+
+        /// element of given size, anchored in its center (like filter of the same size)
+        explicit StructuringElement(const cv::Size& size): left(size.width / 2), right(size.width - 1 - size.width / 2),
+                                                           top(size.height / 2), bottom(size.height - 1 - size.height / 2)
+        {
+        }
+
+        /// element equivalent to applying this element "times" times
+        StructuringElement repeated(const std::size_t times) const {
+            StructuringElement element;
+            element.left = left * times;
+            element.right = right * times;
+            element.top = top * times;
+            element.bottom = bottom * times;
+            return element;
+        }
+    };
+
+    /**
+     * Maximum over structuring element (pixels outside of matrix are zeros).
+     * Uses van Herk/Gil-Werman algorithm, so cost per pixel does not depend on element size.
+     * "target" can not share data with "source".
+     */
+    void dilateRect(const cv::Mat& source, cv::Mat& target, const StructuringElement& element);
+
+    /// minimum over structuring element (pixels outside of matrix are zeros)
+    void erodeRect(const cv::Mat& source, cv::Mat& target, const StructuringElement& element);
+
+} /* namespace ias */
+#endif /* MORPHOLOGY_H_ */
@@ -0,0 +1,162 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+namespace ias {
+
+    /// accumulated measurements of one processing stage
+    struct ProfileStage {
+        std::string name;
+        uint64_t calls;
+        uint64_t nanoseconds;
+        uint64_t pixels;                    /// pixels processed by all calls
+        uint64_t bytes;                     /// bytes allocated on calling thread by all calls
+
+        explicit ProfileStage(const std::string& stageName): name(stageName), calls(0), nanoseconds(0), pixels(0), bytes(0) {
+        }
+
+        double milliseconds() const {
+            return nanoseconds / 1000000.0;
+        }
+
+        double megapixelsPerSecond() const;
+    };
+
+
+    /**
+     * Collects wall time, processed pixels and allocated bytes of processing stages.
+     *
+     * Stages are measured by IAS_PROFILE_SCOPE macro. Macro expands to nothing if library
+     * is built without IAS_PROFILING option, otherwise measurement costs one atomic load
+     * when profiler is disabled. Profiler is disabled by default.
+     * Nested stages are measured separately, so time of outer stage includes inner stages.
+     *
+     * Allocated bytes are not estimated by stages: places allocating memory report size
+     * of new buffer by IAS_PROFILE_ALLOCATION and stage gets sum of allocations made on
+     * its thread while it was running (including inner stages).
+     */
+    class Profiler {
+
+        std::atomic<bool> active;
+        mutable std::mutex mutex;
+        std::vector<ProfileStage> stageList;            /// in order of first call
+
+
+    public:
+
+        Profiler();
+
+        /// profiler used by IAS_PROFILE_SCOPE
+        static Profiler& global();
+
+        /// check if library was built with instrumentation
+        static bool compiled();
+
+        bool enabled() const {
+            return active.load(std::memory_order_relaxed);
+        }
+
+        void setEnabled(const bool enabled);
+
+        /// add allocation to counter of calling thread, used by IAS_PROFILE_ALLOCATION
+        static void countAllocation(const uint64_t bytes);
+
+        /// bytes allocated by calling thread since its start (counted while profiler is enabled)
+        static uint64_t allocatedBytes();
+
+        void record(const char* stage, const uint64_t nanoseconds, const uint64_t pixels, const uint64_t bytes);
+
+        std::vector<ProfileStage> stages() const;
+
+        void reset();
+
+        /// one line per stage
+        void writeText(std::ostream& output) const;
+
+        void writeJson(std::ostream& output) const;
+
+    };
+
+
+    /// measures time from construction to destruction if profiler is enabled
+    class ProfileScope {
+
+        const char* stage;
+        const bool active;
+        uint64_t pixelCount;
+        uint64_t allocatedStart;
+        std::chrono::steady_clock::time_point start;
+
+
+    public:
+
+        ProfileScope(const char* stageName, const uint64_t pixels = 0):
+            stage(stageName), active( Profiler::global().enabled() ), pixelCount(pixels), allocatedStart(0), start()
+        {
+            if (active) {
+                allocatedStart = Profiler::allocatedBytes();
+                start = std::chrono::steady_clock::now();
+            }
+        }
+
+        ~ProfileScope() {
+            if (active == false)
+                return ;
+            const std::chrono::nanoseconds elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - start );
+            Profiler::global().record(stage, elapsed.count(), pixelCount, Profiler::allocatedBytes() - allocatedStart);
+        }
+
+        /// set number of pixels known at end of stage
+        void count(const uint64_t pixels) {
+            pixelCount = pixels;
+        }
+
+    };
+
+} /* namespace ias */
+
+
+#ifdef IAS_PROFILING
+    #define IAS_PROFILE_SCOPE(stage, pixels)        ::ias::ProfileScope iasProfileScope(stage, pixels)
+    #define IAS_PROFILE_COUNT(pixels)               iasProfileScope.count(pixels)
+    #define IAS_PROFILE_ALLOCATION(bytes)           ::ias::Profiler::countAllocation(bytes)
+#else
+    #define IAS_PROFILE_SCOPE(stage, pixels)
+    #define IAS_PROFILE_COUNT(pixels)
+    #define IAS_PROFILE_ALLOCATION(bytes)
+#endif
+
+
+#endif /* PROFILER_H_ */
@@ -0,0 +1,112 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#ifndef REGIONINDEX_H_
+#define REGIONINDEX_H_
+
+#include <vector>
+
+#include "ias/MaskC1.h"
+#include "ias/RleMask.h"
+#include "ias/RunLabeling.h"
+#include "ias/SpanFill.h"
+
+
+namespace ias {
+
+    /**
+     * Index of all regions (4-connectivity) of pixels similar to given color.
+     *
+     * Image is binarized and labeled once, then each region keeps list of its runs
+     * and bounding box. Region of any seed is drawn directly from its runs, so
+     * cost of query depends on region size instead of image size.
+     */
+    class RegionIndex {
+
+        cv::Size imageSize;
+        cv::Vec3b regionColor;
+        uchar regionTolerance;
+
+        RunLabeling labeling;
+        std::vector<uint32_t> runRegion;            /// region of each run
+        std::vector<std::size_t> regionStart;       /// runs of region "r" are [regionStart[r], regionStart[r+1])
+        std::vector<FillSpan> regionRuns;
+        std::vector<cv::Rect> boxes;
+
+
+    public:
+
+        RegionIndex();
+
+        /// index regions of BGR image
+        RegionIndex(const cv::Mat& image, const cv::Vec3b& color, const uchar tolerance);
+
+        bool empty() const {
+            return (imageSize.area() < 1);
+        }
+
+        /// check if index was built for given parameters
+        bool matches(const cv::Vec3b& color, const uchar tolerance) const {
+            return (empty() == false) && (regionColor == color) && (regionTolerance == tolerance);
+        }
+
+        const cv::Size& size() const {
+            return imageSize;
+        }
+
+        /// number of regions
+        std::size_t regions() const {
+            return boxes.size();
+        }
+
+        /// region containing pixel or -1 if pixel has other color
+        long regionAt(const cv::Point& pixel) const;
+
+        const cv::Rect& boundingBox(const std::size_t region) const {
+            return boxes[region];
+        }
+
+        /// number of pixels of region
+        std::size_t area(const std::size_t region) const;
+
+        /// set pixels of region in "mask" to "value"
+        void drawRegion(const std::size_t region, cv::Mat& mask, const uchar value) const;
+
+        /// set pixels of region in packed "mask"
+        void drawRegion(const std::size_t region, BitMask& mask) const;
+
+        /**
+         * Get mask of region containing "seed" in size of image. Region is set to 255,
+         * rest of mask to 0 (whole mask is 0 if seed has other color).
+         * Gives the same result as MaskC1(image, seed, color, tolerance). Mask is packed,
+         * only runs of region are written.
+         */
+        MaskC1 regionMask(const cv::Point& seed) const;
+
+        /// get region containing "seed" as runs, empty if seed has other color
+        RleMask regionRle(const cv::Point& seed) const;
+
+    };
+
+} /* namespace ias */
+#endif /* REGIONINDEX_H_ */
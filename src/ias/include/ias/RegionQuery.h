@@ -0,0 +1,76 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#ifndef REGIONQUERY_H_
+#define REGIONQUERY_H_
+
+#include <vector>
+
+#include "ias/MaskC1.h"
+
+
+namespace ias {
+
+    /// seed pixel, color and tolerance of single region
+    struct RegionQuery {
+        cv::Point seed;
+        cv::Vec3b color;
+        uchar tolerance;
+
+        RegionQuery(): seed(), color(), tolerance(0) {
+        }
+
+        RegionQuery(const cv::Point& seedPixel, const cv::Vec3b& regionColor, const uchar colorTolerance):
+            seed(seedPixel), color(regionColor), tolerance(colorTolerance)
+        {
+        }
+    };
+
+
+    /// maximum number of colors classified in one pass (bits of class mask)
+    static const std::size_t MAX_COLOR_CLASSES = 8;
+
+    /// maximum number of queries of labelled result
+    static const std::size_t MAX_REGION_LABELS = 255;
+
+    /**
+     * Classify pixels of BGR image in one pass over image. Bit "i" of output pixel is set
+     * if pixel differs from "colors[i]" at most by "tolerances[i]" on each component.
+     * At most MAX_COLOR_CLASSES colors are supported.
+     */
+    void classifyColors(const cv::Mat& image, const std::vector<cv::Vec3b>& colors, const std::vector<uchar>& tolerances, cv::Mat& classes);
+
+    /**
+     * Find regions of all queries. Distinct colors are classified in one pass over image
+     * (one pass per MAX_COLOR_CLASSES colors), then each seed is filled (4-connectivity) over
+     * its class. Each region is the same as found by single query.
+     *
+     * Result is packed union of regions (pixels set to 255) or labelled mask if "labelled" is set
+     * (pixels of region of query "i" set to i+1, the first query wins if regions overlap).
+     * Returns empty mask if labelled result is requested for more than MAX_REGION_LABELS queries.
+     */
+    MaskC1 findRegions(const cv::Mat& image, const std::vector<RegionQuery>& queries, const bool labelled = false);
+
+} /* namespace ias */
+#endif /* REGIONQUERY_H_ */
@@ -0,0 +1,48 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#ifndef REGIONSTATS_H_
+#define REGIONSTATS_H_
+
+#include "ias/RleMask.h"
+
+
+namespace ias {
+
+    /**
+     * Statistics of region, calculated from its runs in one pass without dense mask.
+     */
+    struct RegionStats {
+        std::size_t area;                   /// number of pixels
+        cv::Rect boundingBox;               /// empty if region is empty
+        cv::Point2d centroid;               /// mean position of pixels
+        std::size_t perimeter;              /// number of perimeter pixels (the same as Analysis::findPerimeter())
+        bool touchesBorder;                 /// region contains pixel on border of image
+
+        RegionStats();
+
+        explicit RegionStats(const RleMask& region, const int connectivity = 8);
+    };
+
+} /* namespace ias */
+#endif /* REGIONSTATS_H_ */
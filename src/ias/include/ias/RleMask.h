@@ -0,0 +1,157 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#ifndef RLEMASK_H_
+#define RLEMASK_H_
+
+#include <string>
+#include <vector>
+
+#include "ias/MaskC1.h"
+#include "ias/RunLabeling.h"
+#include "ias/SpanFill.h"
+
+
+namespace ias {
+
+    /**
+     * Run length encoded mask.
+     *
+     * Each row keeps sorted list of maximal runs of set pixels, so memory and cost of
+     * operations depend on number of runs instead of number of pixels. Regions found
+     * by flood fill are produced directly as runs, dense mask is created on demand.
+     * Serialized form is the same as ".rle" files (see MaskCodec.h).
+     */
+    class RleMask {
+
+        int nRows;
+        int nCols;
+        std::vector<RowRun> runs;
+        std::vector<std::size_t> rowStart;          /// runs of row "y" are [rowStart[y], rowStart[y+1])
+
+
+    public:
+
+        RleMask();
+
+        /// empty mask of given size
+        RleMask(const int rows, const int cols);
+
+        /// non-zero pixels of CV_8UC1 matrix
+        explicit RleMask(const cv::Mat& mask);
+
+        /// mask from spans (in any order, spans can not overlap)
+        RleMask(const int rows, const int cols, std::vector<FillSpan> spans);
+
+        /**
+         * Find region (4-connectivity) of pixels similar to "color" containing "seed"
+         * on BGR image. Gives the same region as MaskC1(image, seed, color, tolerance).
+         */
+        static RleMask fill(const cv::Mat& image, const cv::Point& seed, const cv::Vec3b& color, const uchar tolerance);
+
+        int rows() const {
+            return nRows;
+        }
+
+        int cols() const {
+            return nCols;
+        }
+
+        /// number of runs
+        std::size_t size() const {
+            return runs.size();
+        }
+
+        /// check if no pixel is set
+        bool empty() const {
+            return runs.empty();
+        }
+
+        std::size_t rowBegin(const int y) const {
+            return rowStart[y];
+        }
+
+        std::size_t rowEnd(const int y) const {
+            return rowStart[y + 1];
+        }
+
+        const RowRun& run(const std::size_t index) const {
+            return runs[index];
+        }
+
+        /// number of set pixels
+        std::size_t area() const;
+
+        /// bounding box of set pixels, empty rectangle if no pixel is set
+        cv::Rect boundingBox() const;
+
+        bool contains(const cv::Point& pixel) const;
+
+        bool operator==(const RleMask& other) const;
+
+        bool operator!=(const RleMask& other) const {
+            return !(*this == other);
+        }
+
+        /// pixels set in any of masks, masks have to be of the same size
+        RleMask unite(const RleMask& other) const;
+
+        /// pixels set in both masks
+        RleMask intersect(const RleMask& other) const;
+
+        /// pixels set in this mask and not set in "other"
+        RleMask subtract(const RleMask& other) const;
+
+        /**
+         * Pixels having at least one neighbour (4- or 8-connectivity) not set, pixels
+         * outside of mask are treated as not set. Gives the same result as
+         * Analysis::findPerimeter() on dense mask.
+         */
+        RleMask perimeter(const int connectivity = 8) const;
+
+        /// set pixels of "mask" (CV_8UC1 of the same size) to "value"
+        void draw(cv::Mat& mask, const uchar value) const;
+
+        /// dense mask, set pixels are 255, others 0
+        MaskC1 toMask() const;
+
+        /// append serialized mask
+        void serialize(std::vector<uchar>& out) const;
+
+        /// read serialized mask, returns false if data is not valid
+        bool deserialize(const uchar* data, const std::size_t size);
+
+        bool store(const std::string& path) const;
+
+        bool load(const std::string& path);
+
+
+    private:
+
+        template<typename Operation>
+        RleMask combine(const RleMask& other, const Operation& operation) const;
+
+    };
+
+} /* namespace ias */
+#endif /* RLEMASK_H_ */
@@ -0,0 +1,105 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#ifndef ROWPIPELINE_H_
+#define ROWPIPELINE_H_
+
+#include <vector>
+#include <functional>
+
+#include <opencv2/core/core.hpp>
+
+
+namespace ias {
+
+    /**
+     * Chain of 3x3 operations executed row by row.
+     *
+     * Each stage keeps ring buffer of three input rows and passes every calculated row
+     * to the next stage immediately, so whole chain needs only a few rows of memory
+     * and input is read once. Pixels outside of image are treated as zeros, so result
+     * is the same as executing operations one by one on whole matrix.
+     */
+    class RowPipeline {
+    public:
+
+        enum Operation {
+            ERODE,                          /// minimum of 3x3 neighbourhood
+            DILATE,                         /// maximum of 3x3 neighbourhood
+            GAUSSIAN_BLUR,                  /// GaussianKernel
+            LAPLACE,                        /// LaplaceKernel
+            LAPLACE4                        /// Laplace4Kernel
+        };
+
+        typedef std::function<void (const uchar* row)> RowSink;
+
+
+    private:
+
+        struct Stage {
+            Operation operation;
+            int threshold;                  /// negative value means no thresholding
+            std::vector<uchar> rows;        /// ring buffer of three rows
+            std::vector<uchar> output;
+            int received;
+        };
+
+        std::vector<Stage> stages;
+        std::vector<uchar> zeros;
+        int nCols;
+        int nRows;
+        RowSink sink;
+
+
+    public:
+
+        RowPipeline(): stages(), zeros(), nCols(0), nRows(0), sink() {
+        }
+
+        /// add operation, result of operation is thresholded if "threshold" is not negative
+        void addStage(const Operation operation, const int threshold = -1);
+
+        bool empty() const {
+            return stages.empty();
+        }
+
+        /// start streaming image of given size, calculated rows are passed to "output" in order
+        void start(const int width, const int height, const RowSink& output);
+
+        /// push next row of image, after last row all remaining rows are passed to output
+        void push(const uchar* row);
+
+        /// process whole matrix
+        void run(const cv::Mat& source, cv::Mat& target);
+
+
+    private:
+
+        void feed(const std::size_t index, const uchar* row);
+
+        void emit(const std::size_t index, const int y);
+
+    };
+
+} /* namespace ias */
+#endif /* ROWPIPELINE_H_ */
@@ -0,0 +1,98 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#ifndef RUNLABELING_H_
+#define RUNLABELING_H_
+
+#include <vector>
+#include <cstdint>
+
+#include <opencv2/core/core.hpp>
+
+
+namespace ias {
+
+    /**
+     * Horizontal run of pixels [left, right] in one row.
+     */
+    struct RowRun {
+        int left;
+        int right;
+    };
+
+    /**
+     * Connected component labeling (4-connectivity) of pixels of given value.
+     *
+     * Image is split into bands of rows processed in parallel. Each band finds runs
+     * of pixels and joins runs overlapping with previous row with local union-find.
+     * Then runs touching band seams are merged with concurrent (lock-free) union-find.
+     * Component label is index of its first run (in row-major order), so labels do not
+     * depend on number of threads.
+     */
+    class RunLabeling {
+
+        int nRows;
+        std::vector<RowRun> runs;
+        std::vector<std::size_t> rowStart;          /// runs of row "y" are [rowStart[y], rowStart[y+1])
+        std::vector<uint32_t> labels;               /// label of each run
+
+
+    public:
+
+        RunLabeling(): nRows(0), runs(), rowStart(), labels() {
+        }
+
+        /// label pixels of "mask" equal to "value"
+        void label(const cv::Mat& mask, const uchar value);
+
+        int rows() const {
+            return nRows;
+        }
+
+        std::size_t size() const {
+            return runs.size();
+        }
+
+        std::size_t rowBegin(const int y) const {
+            return rowStart[y];
+        }
+
+        std::size_t rowEnd(const int y) const {
+            return rowStart[y+1];
+        }
+
+        const RowRun& run(const std::size_t index) const {
+            return runs[index];
+        }
+
+        uint32_t runLabel(const std::size_t index) const {
+            return labels[index];
+        }
+
+        /// index of run containing pixel or -1 if pixel has other value
+        long findRun(const cv::Point& pixel) const;
+
+    };
+
+} /* namespace ias */
+#endif /* RUNLABELING_H_ */
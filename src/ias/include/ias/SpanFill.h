@@ -0,0 +1,123 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#ifndef SPANFILL_H_
+#define SPANFILL_H_
+
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+
+namespace ias {
+
+    /**
+     * Horizontal run of pixels [left, right] in row "y".
+     */
+    struct FillSpan {
+        int y;
+        int left;
+        int right;
+
+        FillSpan(): y(0), left(0), right(0) {
+        }
+
+        FillSpan(const int row, const int leftX, const int rightX): y(row), left(leftX), right(rightX) {
+        }
+    };
+
+    /**
+     * Scanline flood fill (4-connectivity) working on spans instead of single pixels.
+     *
+     * "claim(x, y)" has to return true if pixel belongs to filled area and was not claimed before.
+     * Claimed pixel has to be marked by the functor, so the next call for the same pixel returns false.
+     * Every pixel is tested at most a few times and stack gets one entry per run of
+     * neighbouring row, so its size is bounded by number of runs instead of number of pixels.
+     *
+     * "stack" is a scratch buffer, it can be reused between calls to avoid allocations.
+     * "output(span)" is called for each filled span, spans do not overlap and together
+     * cover the filled area (neighbouring spans of one row are not merged).
+     */
+    template<typename Claim, typename SpanOutput>
+    void spanFill(const cv::Point& seed, const int nCols, const int nRows, Claim& claim, std::vector<FillSpan>& stack, SpanOutput& output) {
+        stack.clear();
+        if (seed.x < 0 || seed.y < 0 || seed.x >= nCols || seed.y >= nRows) {
+            return ;
+        }
+        if (claim(seed.x, seed.y) == false) {
+            return ;
+        }
+
+        stack.push_back( FillSpan(seed.y, seed.x, seed.x) );
+        while( !stack.empty() ) {
+            const FillSpan span = stack.back();
+            stack.pop_back();
+
+            const int y = span.y;
+
+            /// extend span (its pixels are already claimed)
+            int left = span.left;
+            while( left > 0 && claim(left-1, y) ) {
+                --left;
+            }
+            int right = span.right;
+            while( right < (nCols-1) && claim(right+1, y) ) {
+                ++right;
+            }
+            output( FillSpan(y, left, right) );
+
+            /// push one span per run of claimed pixels in neighbouring rows
+            for (int ny = y-1; ny <= y+1; ny += 2) {
+                if (ny < 0 || ny >= nRows)
+                    continue;
+                int x = left;
+                while( x <= right ) {
+                    if ( claim(x, ny) == false ) {
+                        ++x;
+                        continue;
+                    }
+                    const int start = x;
+                    ++x;
+                    while( x <= right && claim(x, ny) ) {
+                        ++x;
+                    }
+                    stack.push_back( FillSpan(ny, start, x-1) );
+                }
+            }
+        }
+    }
+
+    /// ignores filled spans
+    struct NoSpanOutput {
+        void operator()(const FillSpan&) {
+        }
+    };
+
+    template<typename Claim>
+    void spanFill(const cv::Point& seed, const int nCols, const int nRows, Claim& claim, std::vector<FillSpan>& stack) {
+        NoSpanOutput output;
+        spanFill(seed, nCols, nRows, claim, stack, output);
+    }
+
+} /* namespace ias */
+#endif /* SPANFILL_H_ */
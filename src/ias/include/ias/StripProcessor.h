@@ -0,0 +1,95 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#ifndef STRIPPROCESSOR_H_
+#define STRIPPROCESSOR_H_
+
+#include <string>
+
+#include "ias/ImageIO.h"
+#include "ias/MappedFile.h"
+#include "ias/RowPipeline.h"
+
+
+namespace ias {
+
+    /**
+     * Finds region on images bigger than available memory.
+     *
+     * Image is read from memory mapped raw or PNM file in horizontal strips. Region is
+     * found in two passes: first pass labels each strip separately and joins labels
+     * of components touching strip borders with union-find, second pass labels strips
+     * again and writes rows of region. Components touching borders get global labels
+     * in order of strips, so both passes agree without keeping labels of whole image.
+     * Local operations (perimeter, smooth perimeter) are applied on the stream of rows
+     * by RowPipeline. Pixel buffers depend only on strip size and image width, but union-find
+     * keeps 4 bytes per component touching strip border (at most image width per strip) and
+     * per-strip label offsets, so label tables grow with height / rowsPerStrip * width.
+     */
+    class StripProcessor {
+
+        int stripRows;
+        MappedFile file;
+        ImageLayout layout;
+        RowPipeline pipeline;
+
+
+    public:
+
+        explicit StripProcessor(const int rowsPerStrip);
+
+        /// open raw, PPM or PGM image, returns false if file is not supported
+        bool open(const std::string& imagePath);
+
+        const ImageLayout& imageLayout() const {
+            return layout;
+        }
+
+        /// calculate perimeter of found region (the same as Analysis::findPerimeter)
+        void addPerimeter(const int connectivity = 8);
+
+        /// calculate smooth perimeter of found region (the same as Analysis::findSmoothPerimeter)
+        void addSmoothPerimeter();
+
+        /// remove operations added to region
+        void clearOperations();
+
+        /**
+         * Find region of "color" containing "seed" and pass rows of result to "output".
+         * Result is the same as Analysis::findRegion followed by added operations.
+         */
+        bool findRegion(const cv::Point& seed, const cv::Vec3b& color, const uchar tolerance, const RowPipeline::RowSink& output);
+
+        /// store result to raw or PGM file
+        bool findRegion(const cv::Point& seed, const cv::Vec3b& color, const uchar tolerance, const std::string& outputPath);
+
+
+    private:
+
+        /// binarize rows [firstRow, firstRow + mask.rows) of image
+        void binarizeStrip(const int firstRow, const cv::Vec3b& color, const uchar tolerance, cv::Mat& mask, cv::Mat& converted) const;
+
+    };
+
+} /* namespace ias */
+#endif /* STRIPPROCESSOR_H_ */
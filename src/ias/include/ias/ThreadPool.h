@@ -0,0 +1,118 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+
+
+namespace ias {
+
+    /**
+     * Persistent pool of worker threads executing loops split into bands.
+     *
+     * Range of loop is split into contiguous bands depending only on range size and
+     * number of threads, so each element is always processed by exactly one call of
+     * loop body. Calling thread takes part in processing. Nested calls and calls made
+     * while pool is busy with other loop are executed serially by calling thread.
+     */
+    class ThreadPool {
+    public:
+
+        typedef std::function<void (int begin, int end)> BandFunction;
+
+
+    private:
+
+        std::vector<std::thread> workers;
+        std::atomic<std::size_t> threadsNum;     /// workers plus calling thread, readable without lock
+
+        std::mutex mutex;
+        std::condition_variable wakeUp;
+        std::condition_variable finished;
+        std::mutex loopMutex;               /// one loop at a time
+
+        const BandFunction* function;       /// loop being executed, guarded by "mutex"
+        int rangeSize;
+        int nBands;
+        std::atomic<int> nextBand;
+        int active;                         /// workers executing current loop
+        unsigned long generation;
+        bool stopping;
+        std::exception_ptr error;
+
+
+    public:
+
+        /// "threads" is total number of threads including calling thread
+        explicit ThreadPool(const std::size_t threads = 1);
+
+        ~ThreadPool();
+
+        /// pool used by library operations
+        static ThreadPool& global();
+
+        /// number of threads including calling thread
+        std::size_t size() const {
+            return threadsNum.load();
+        }
+
+        /// set number of threads, 0 means number of hardware threads
+        void resize(std::size_t threads);
+
+        /**
+         * Execute "body" for bands of range [0, count) and wait for completion.
+         * Each band has at least "grain" elements. Exception thrown by body is
+         * rethrown in calling thread.
+         */
+        void parallelFor(const int count, const BandFunction& body, const int grain = 1);
+
+
+    private:
+
+        void start(const std::size_t threads);
+
+        void stop();
+
+        void work();
+
+        void runBands(const BandFunction& body, const int loopCount, const int loopBands);
+
+    };
+
+
+    /**
+     * Process rows of image in parallel with global pool. Bands are big enough
+     * to make threading overhead negligible. "body" receives range of rows.
+     */
+    void parallelRows(const int nRows, const int nCols, const ThreadPool::BandFunction& body);
+
+} /* namespace ias */
+#endif /* THREADPOOL_H_ */
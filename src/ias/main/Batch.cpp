@@ -0,0 +1,279 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "Batch.h"
+
+#include <exception>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <atomic>
+
+#include <boost/log/trivial.hpp>
+
+#include "ias/Analysis.h"
+#include "ias/BoundedQueue.h"
+#include "Commands.h"
+
+
+/// collects results of --savePixels command for encoding stage
+class JobWriter: public ResultWriter {
+    std::vector<Batch::Output>& outputs;
+
+public:
+
+    JobWriter(std::vector<Batch::Output>& jobOutputs): outputs(jobOutputs) {
+    }
+
+    virtual void write(const cv::Mat& result, const std::string& path) {
+        Batch::Output output;
+        output.path = path;
+        output.compression = compression;
+        /// results are not modified in place by following commands, pooled buffer is not reused while shared
+        output.result = result;
+        outputs.push_back( output );
+    }
+
+};
+
+
+/// closes queue when last thread of stage finishes
+class StageGuard {
+    std::atomic<std::size_t>& running;
+    ias::BoundedQueue<std::size_t>& next;
+
+public:
+
+    StageGuard(std::atomic<std::size_t>& runningThreads, ias::BoundedQueue<std::size_t>& nextQueue): running(runningThreads), next(nextQueue) {
+    }
+
+    ~StageGuard() {
+        if (--running == 0) {
+            next.close();
+        }
+    }
+
+};
+
+
+/// options changing state shared by all jobs of batch, result of job would depend on other jobs
+static bool isGlobalOption(const std::string& option) {
+    static const char* const GLOBAL_OPTIONS[] = { "--threads", "--bufferPool", "--asyncSave", "--profile",
+                                                  "--batch", "--batchWorkers", "--strips", "--serve" };
+    const std::string param = option.substr( 0, option.find('=') );
+    for (const char* name: GLOBAL_OPTIONS) {
+        if (param.compare(name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+Batch::Batch(const std::size_t workersNum): jobs(), workers( (workersNum < 1) ? 1 : workersNum ), compression(-1) {
+}
+
+bool Batch::load(const std::string& manifestPath) {
+    std::ifstream file( manifestPath.c_str() );
+    if (file.is_open() == false) {
+        return false;
+    }
+    load(file);
+    return true;
+}
+
+void Batch::load(std::istream& stream) {
+    std::string line;
+    std::size_t lineNum = 0;
+    while ( std::getline(stream, line) ) {
+        ++lineNum;
+        std::istringstream words(line);
+        std::string path;
+        if ( !(words >> path) ) {
+            continue;
+        }
+        if (path[0] == '#') {
+            continue;
+        }
+
+        Job job;
+        job.line = lineNum;
+        job.imagePath = path;
+        job.success = true;
+        std::string option;
+        while (words >> option) {
+            job.options.push_back( option );
+        }
+        jobs.push_back( job );
+    }
+}
+
+std::size_t Batch::run() {
+    const std::size_t capacity = 2 * workers;
+    ias::BoundedQueue<std::size_t> computeQueue(capacity);
+    ias::BoundedQueue<std::size_t> encodeQueue(capacity);
+
+    std::atomic<std::size_t> nextJob(0);
+    std::atomic<std::size_t> decoders(workers);
+    std::atomic<std::size_t> computers(workers);
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < workers; ++i) {
+        threads.push_back( std::thread([&]() {
+            StageGuard guard(decoders, computeQueue);
+            while (true) {
+                const std::size_t index = nextJob++;
+                if (index >= jobs.size()) {
+                    return ;
+                }
+                decode(index);
+                if (jobs[index].success) {
+                    computeQueue.push(index);
+                }
+            }
+        }) );
+        threads.push_back( std::thread([&]() {
+            StageGuard guard(computers, encodeQueue);
+            std::size_t index = 0;
+            while ( computeQueue.pop(index) ) {
+                if ( compute(index) ) {
+                    encodeQueue.push(index);
+                }
+            }
+        }) );
+        threads.push_back( std::thread([&]() {
+            std::size_t index = 0;
+            while ( encodeQueue.pop(index) ) {
+                encode(index);
+            }
+        }) );
+    }
+    for (std::size_t i = 0; i < threads.size(); ++i) {
+        threads[i].join();
+    }
+
+    std::size_t failed = 0;
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+        const Job& job = jobs[i];
+        if (job.success) {
+            BOOST_LOG_TRIVIAL(info) << "job " << job.line << " succeeded: " << job.imagePath;
+        } else {
+            BOOST_LOG_TRIVIAL(error) << "job " << job.line << " failed: " << job.imagePath << ": " << job.message;
+            ++failed;
+        }
+    }
+    BOOST_LOG_TRIVIAL(info) << "batch finished, jobs: " << jobs.size() << " failed: " << failed;
+    return failed;
+}
+
+void Batch::decode(const std::size_t index) {
+    Job& job = jobs[index];
+    try {
+        if (job.image.load(job.imagePath) == false) {
+            job.success = false;
+            job.message = "unable to load file";
+        }
+    } catch (const std::exception& e) {
+        /// failure of one job does not stop the pipeline
+        job.image.release();
+        job.success = false;
+        job.message = e.what();
+    }
+}
+
+bool Batch::compute(const std::size_t index) {
+    Job& job = jobs[index];
+    try {
+        ias::Analysis object;
+        object.setImage(job.image);
+        job.image.release();
+
+        JobWriter writer(job.outputs);
+        writer.setCompression(compression);
+        bool regionLabels = false;
+        for (std::size_t i = 0; i < job.options.size(); ++i) {
+            const std::string& option = job.options[i];
+            if (option.compare(0, 9, "--display") == 0) {
+                BOOST_LOG_TRIVIAL(warning) << "option not supported in batch mode: " << option;
+                continue;
+            }
+            if ( isGlobalOption(option) ) {
+                job.success = false;
+                job.message = "option not supported in batch mode: " + option;
+                job.outputs.clear();
+                return false;
+            }
+            if (option.compare("--regionLabels") == 0) {
+                regionLabels = true;
+                continue;
+            }
+            const std::size_t regionCount = regionGroupSize(job.options, i);
+            if (regionCount > 1 || (regionCount == 1 && regionLabels)) {
+                const std::vector<std::string> regions( job.options.begin() + i, job.options.begin() + i + regionCount );
+                if (handleRegions(object, regions, regionLabels) != 0) {
+                    job.success = false;
+                    job.message = "invalid option: " + option;
+                    job.outputs.clear();
+                    return false;
+                }
+                i += regionCount - 1;
+                continue;
+            }
+            if (handleParam(object, option, writer) != 0) {
+                job.success = false;
+                job.message = "invalid option: " + option;
+                job.outputs.clear();
+                return false;
+            }
+        }
+        return (job.outputs.empty() == false);
+    } catch (const std::exception& e) {
+        job.image.release();
+        job.success = false;
+        job.message = e.what();
+        job.outputs.clear();
+        return false;
+    }
+}
+
+void Batch::encode(const std::size_t index) {
+    Job& job = jobs[index];
+    for (std::size_t i = 0; i < job.outputs.size(); ++i) {
+        const Output& output = job.outputs[i];
+        if (output.result.empty()) {
+            job.success = false;
+            job.message = "no result to save: " + output.path;
+            continue;
+        }
+        try {
+            if ( ias::storeImage(output.result, output.path, output.compression) == false ) {
+                job.success = false;
+                job.message = "unable to save file: " + output.path;
+            }
+        } catch (const std::exception& e) {
+            job.success = false;
+            job.message = "unable to save file: " + output.path + ": " + e.what();
+        }
+    }
+    job.outputs.clear();
+}
@@ -0,0 +1,109 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#ifndef BATCH_H_
+#define BATCH_H_
+
+#include <string>
+#include <vector>
+
+#include "ias/ImageIO.h"
+
+
+/**
+ * Processing of many images listed in manifest file in one process.
+ *
+ * Each line of manifest contains path of image followed by options separated by
+ * spaces, options have the same form as command line options, e.g.:
+ *      data/test1.png --findRegion=0,0,0,0,255,20 --findPerimeter --savePixels=out1.png
+ * Empty lines and lines starting with '#' are skipped. Options changing process-wide
+ * state (e.g. --threads, --bufferPool, --asyncSave) fail the job.
+ *
+ * Jobs go through three stages: decoding image, executing options and encoding results.
+ * Stages are connected with bounded queues and each stage is run by "workers" threads,
+ * so decoding and encoding of some images overlaps with processing of others.
+ */
+class Batch {
+public:
+
+    struct Output {
+        std::string path;
+        cv::Mat result;
+        int compression;
+    };
+
+    struct Job {
+        std::size_t line;                   /// line in manifest
+        std::string imagePath;
+        std::vector<std::string> options;
+
+        ias::ImageFile image;
+        std::vector<Output> outputs;
+
+        bool success;
+        std::string message;
+    };
+
+
+private:
+
+    std::vector<Job> jobs;
+    std::size_t workers;
+    int compression;
+
+
+public:
+
+    explicit Batch(const std::size_t workersNum = 1);
+
+    /// default level of PNG compression of results (-1 - default)
+    void setCompression(const int level) {
+        compression = level;
+    }
+
+    /// read jobs from manifest file, returns false if file could not be read
+    bool load(const std::string& manifestPath);
+
+    /// read jobs from stream
+    void load(std::istream& stream);
+
+    /// execute all jobs, returns number of failed jobs
+    std::size_t run();
+
+    const std::vector<Job>& results() const {
+        return jobs;
+    }
+
+
+private:
+
+    void decode(const std::size_t index);
+
+    bool compute(const std::size_t index);
+
+    void encode(const std::size_t index);
+
+};
+
+
+#endif /* BATCH_H_ */
@@ -0,0 +1,270 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "Commands.h"
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/log/trivial.hpp>
+
+#include "ias/BufferPool.h"
+#include "ias/ThreadPool.h"
+
+
+void ResultWriter::writeText(const std::string& text) {
+    /// batch jobs can print from many threads
+    static std::mutex outputMutex;
+    std::lock_guard<std::mutex> lock(outputMutex);
+    std::cout << text << std::endl;
+}
+
+
+static std::string statsToJson(const ias::RegionStats& stats) {
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(3);
+    json << "{\"area\": " << stats.area
+         << ", \"boundingBox\": {\"x\": " << stats.boundingBox.x << ", \"y\": " << stats.boundingBox.y
+         << ", \"width\": " << stats.boundingBox.width << ", \"height\": " << stats.boundingBox.height << "}"
+         << ", \"centroid\": {\"x\": " << stats.centroid.x << ", \"y\": " << stats.centroid.y << "}"
+         << ", \"perimeter\": " << stats.perimeter
+         << ", \"touchesBorder\": " << (stats.touchesBorder ? "true" : "false") << "}";
+    return json.str();
+}
+
+
+int handleParam(ias::Analysis& object, const std::string& option, ResultWriter& writer) {
+    std::vector<std::string> words;
+    boost::split(words, option, boost::is_any_of("="));
+
+    if (words.empty()) {
+        BOOST_LOG_TRIVIAL(error) << "bad argument: " << option;
+        return 1;
+    }
+
+    const std::string& param = words[0];
+    if ( param.compare("--image") == 0 ) {
+        if (words.size() < 2) {
+            BOOST_LOG_TRIVIAL(error) << "missing image path: " << option;
+            return 1;
+        }
+        const std::string& path = words[1];
+        BOOST_LOG_TRIVIAL(info) << "loading image: " << path;
+        const bool valid = object.loadImage(path);
+        if (valid == false) {
+            BOOST_LOG_TRIVIAL(error) << "unable to load file: " << path;
+            return 1;
+        }
+
+    } else if ( param.compare("--threads") == 0 ) {
+        if (words.size() < 2) {
+            BOOST_LOG_TRIVIAL(error) << "missing number of threads: " << option;
+            return 1;
+        }
+        const int threads = atoi( words[1].c_str() );
+        if (threads < 0) {
+            BOOST_LOG_TRIVIAL(error) << "invalid number of threads: " << option;
+            return 1;
+        }
+        ias::ThreadPool::global().resize( threads );
+        BOOST_LOG_TRIVIAL(info) << "using threads: " << ias::ThreadPool::global().size();
+        return 0;
+
+    } else if ( param.compare("--parallelFill") == 0 ) {
+        BOOST_LOG_TRIVIAL(info) << "finding regions by parallel labeling";
+        object.setParallelFill(true);
+        return 0;
+
+    } else if ( param.compare("--findRegion") == 0 ) {
+        if (words.size() < 2) {
+            BOOST_LOG_TRIVIAL(error) << "missing region: " << option;
+            return 1;
+        }
+        const std::string& input = words[1];
+        RegionParams regionParams(input);
+        if (regionParams.valid == false) {
+            BOOST_LOG_TRIVIAL(error) << "unable to parse: " << option;
+            return 1;
+        }
+        BOOST_LOG_TRIVIAL(info) << "calculating region: " << input;
+        object.findRegion( regionParams.pixelCoords, regionParams.color, regionParams.equalityMargin );
+        return 0;
+
+    } else if ( param.compare("--regionStats") == 0 ) {
+        if (words.size() < 2) {
+            BOOST_LOG_TRIVIAL(error) << "missing region: " << option;
+            return 1;
+        }
+        RegionParams regionParams(words[1]);
+        if (regionParams.valid == false) {
+            BOOST_LOG_TRIVIAL(error) << "unable to parse: " << option;
+            return 1;
+        }
+        BOOST_LOG_TRIVIAL(info) << "calculating region statistics: " << words[1];
+        const ias::RegionStats stats = object.regionStats( regionParams.pixelCoords, regionParams.color, regionParams.equalityMargin );
+        writer.writeText( statsToJson(stats) );
+        return 0;
+
+    } else if ( param.compare("--maskCache") == 0 ) {
+        if (words.size() < 2) {
+            BOOST_LOG_TRIVIAL(error) << "missing cache size: " << option;
+            return 1;
+        }
+        const int megabytes = atoi( words[1].c_str() );
+        if (megabytes < 0) {
+            BOOST_LOG_TRIVIAL(error) << "invalid cache size: " << option;
+            return 1;
+        }
+        BOOST_LOG_TRIVIAL(info) << "mask cache size: " << megabytes << "MB";
+        object.setMaskCacheBudget( (std::size_t)megabytes * 1024 * 1024 );
+        return 0;
+
+    } else if ( param.compare("--cacheStats") == 0 ) {
+        const ias::MaskCache& cache = object.maskCache();
+        BOOST_LOG_TRIVIAL(info) << "mask cache: hits=" << cache.hits() << " misses=" << cache.misses()
+                                << " masks=" << cache.size() << " bytes=" << cache.bytes();
+        return 0;
+
+    } else if ( param.compare("--bufferPool") == 0 ) {
+        if (words.size() < 2) {
+            BOOST_LOG_TRIVIAL(error) << "missing pool size: " << option;
+            return 1;
+        }
+        const int megabytes = atoi( words[1].c_str() );
+        if (megabytes < 0) {
+            BOOST_LOG_TRIVIAL(error) << "invalid pool size: " << option;
+            return 1;
+        }
+        BOOST_LOG_TRIVIAL(info) << "buffer pool size: " << megabytes << "MB";
+        ias::BufferPool::global().setBudget( (std::size_t)megabytes * 1024 * 1024 );
+        return 0;
+
+    } else if ( param.compare("--poolStats") == 0 ) {
+        const ias::BufferPool& pool = ias::BufferPool::global();
+        BOOST_LOG_TRIVIAL(info) << "buffer pool: acquires=" << pool.acquires() << " allocations=" << pool.allocations()
+                                << " releases=" << pool.releases() << " buffers=" << pool.size() << " bytes=" << pool.bytes();
+        return 0;
+
+    } else if ( param.compare("--indexRegions") == 0 ) {
+        if (words.size() < 2) {
+            BOOST_LOG_TRIVIAL(error) << "missing color: " << option;
+            return 1;
+        }
+        const ColorParams colorParams(words[1]);
+        if (colorParams.valid == false) {
+            BOOST_LOG_TRIVIAL(error) << "unable to parse: " << option;
+            return 1;
+        }
+        BOOST_LOG_TRIVIAL(info) << "indexing regions: " << words[1];
+        object.indexRegions( colorParams.color, colorParams.equalityMargin );
+        BOOST_LOG_TRIVIAL(info) << "regions found: " << object.regions().regions();
+        return 0;
+
+    } else if ( param.compare("--findPerimeter") == 0 ) {
+        int connectivity = 8;
+        if (words.size() > 1) {
+            connectivity = atoi( words[1].c_str() );
+            if (connectivity != 4 && connectivity != 8) {
+                BOOST_LOG_TRIVIAL(error) << "invalid connectivity: " << option;
+                return 1;
+            }
+        }
+        BOOST_LOG_TRIVIAL(info) << "calculating perimeter, connectivity: " << connectivity;
+        object.findPerimeter(connectivity);
+        return 0;
+
+    } else if ( param.compare("--findSmoothPerimeter") == 0 ) {
+        BOOST_LOG_TRIVIAL(info) << "calculating smooth perimeter";
+        object.findSmoothPerimeter();
+        return 0;
+
+    } else if ( param.compare("--compression") == 0 ) {
+        if (words.size() < 2) {
+            BOOST_LOG_TRIVIAL(error) << "missing compression level: " << option;
+            return 1;
+        }
+        const int level = atoi( words[1].c_str() );
+        if (level < 0 || level > 9) {
+            BOOST_LOG_TRIVIAL(error) << "invalid compression level: " << option;
+            return 1;
+        }
+        writer.setCompression( level );
+        return 0;
+
+    } else if ( param.compare("--displayImage") == 0 ) {
+        BOOST_LOG_TRIVIAL(info) << "displaying image";
+        object.displayImage();
+
+    } else if ( param.compare("--displayPixels") == 0 ) {
+        BOOST_LOG_TRIVIAL(info) << "displaying result";
+        object.displayPixels();
+
+    } else if ( param.compare("--displayJoin") == 0 ) {
+        BOOST_LOG_TRIVIAL(info) << "displaying image and result on one window";
+        object.displayJoin();
+
+    } else if ( param.compare("--savePixels") == 0 ) {
+        if (words.size() < 2) {
+            BOOST_LOG_TRIVIAL(error) << "missing file path: " << option;
+            return 1;
+        }
+        const std::string& path = words[1];
+        BOOST_LOG_TRIVIAL(info) << "saving result to file: " << path;
+        writer.write(object.result(), path);
+    }
+
+    return 0;
+}
+
+std::size_t regionGroupSize(const std::vector<std::string>& options, const std::size_t first) {
+    std::size_t count = 0;
+    while ( first + count < options.size() && options[first + count].compare(0, 13, "--findRegion=") == 0 ) {
+        ++count;
+    }
+    return count;
+}
+
+int handleRegions(ias::Analysis& object, const std::vector<std::string>& options, const bool labelled) {
+    std::vector<ias::RegionQuery> queries;
+    for (std::size_t i = 0; i < options.size(); ++i) {
+        const std::string& option = options[i];
+        const std::string input = option.substr( option.find('=') + 1 );
+        RegionParams regionParams(input);
+        if (regionParams.valid == false) {
+            BOOST_LOG_TRIVIAL(error) << "unable to parse: " << option;
+            return 1;
+        }
+        queries.push_back( ias::RegionQuery( regionParams.pixelCoords, regionParams.color, regionParams.equalityMargin ) );
+    }
+    if (labelled && queries.size() > ias::MAX_REGION_LABELS) {
+        BOOST_LOG_TRIVIAL(error) << "too many labelled regions: " << queries.size();
+        return 1;
+    }
+
+    BOOST_LOG_TRIVIAL(info) << "calculating " << (labelled ? "labels" : "union") << " of regions: " << queries.size();
+    object.findRegion( queries, labelled );
+    return 0;
+}
@@ -0,0 +1,200 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#ifndef COMMANDS_H_
+#define COMMANDS_H_
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ias/Analysis.h"
+#include "ias/AsyncWriter.h"
+
+
+/**
+ * Parameters of --findRegion command: pX,pY,B,G,R,T
+ */
+class RegionParams {
+public:
+
+    bool valid;
+
+    cv::Point pixelCoords;
+    cv::Vec3b color;
+    uchar equalityMargin;
+
+
+private:
+
+    std::istringstream iss;
+
+
+public:
+
+    RegionParams(const std::string& input): valid(false), pixelCoords(), color(), equalityMargin(), iss(input) {
+        const int x = read<int>(); readSeparator();
+        const int y = read<int>(); readSeparator();
+        pixelCoords = cv::Point(x, y);
+
+        const int b = read<int>(); readSeparator();
+        const int g = read<int>(); readSeparator();
+        const int r = read<int>(); readSeparator();
+        color = cv::Vec3b(b, g, r);
+
+        equalityMargin = read<int>();
+
+        valid = !iss.fail();
+    }
+
+
+private:
+
+    template<typename Type>
+    Type read() {
+        Type value;
+        iss >> value;
+        return value;
+    }
+
+    void readSeparator() {
+        read<char>();
+    }
+
+};
+
+
+/**
+ * Parameters of --indexRegions command: B,G,R,T
+ */
+class ColorParams {
+public:
+
+    bool valid;
+
+    cv::Vec3b color;
+    uchar equalityMargin;
+
+
+public:
+
+    ColorParams(const std::string& input): valid(false), color(), equalityMargin() {
+        std::istringstream iss(input);
+        int b, g, r, t;
+        char sep1, sep2, sep3;
+        iss >> b >> sep1 >> g >> sep2 >> r >> sep3 >> t;
+        if (iss.fail()) {
+            return ;
+        }
+        color = cv::Vec3b(b, g, r);
+        equalityMargin = t;
+        valid = true;
+    }
+
+};
+
+
+/**
+ * Destination of results of --savePixels command.
+ */
+class ResultWriter {
+protected:
+
+    int compression;                    /// level of PNG compression set by --compression
+
+
+public:
+
+    ResultWriter(): compression(-1) {
+    }
+
+    virtual ~ResultWriter() {
+    }
+
+    int compressionLevel() const {
+        return compression;
+    }
+
+    void setCompression(const int level) {
+        compression = level;
+    }
+
+    virtual void write(const cv::Mat& result, const std::string& path) = 0;
+
+    /// output of commands printing values (e.g. --regionStats), standard output by default
+    virtual void writeText(const std::string& text);
+
+};
+
+
+/**
+ * Stores results to files immediately.
+ */
+class FileWriter: public ResultWriter {
+public:
+
+    virtual void write(const cv::Mat& result, const std::string& path) {
+        ias::Analysis::storeMat(result, path, compression);
+    }
+
+};
+
+
+/**
+ * Stores results to files on background thread (--asyncSave).
+ */
+class AsyncFileWriter: public ResultWriter {
+
+    ias::AsyncWriter writer;
+
+
+public:
+
+    virtual void write(const cv::Mat& result, const std::string& path) {
+        if (result.empty())
+            return ;
+        writer.write(result, path, compression);
+    }
+
+    /// wait for pending results, returns number of failed writes
+    std::size_t close() {
+        return writer.close();
+    }
+
+};
+
+
+/// execute single command line option on "object", returns 0 on success
+int handleParam(ias::Analysis& object, const std::string& option, ResultWriter& writer);
+
+/// number of consecutive --findRegion options starting at "first"
+std::size_t regionGroupSize(const std::vector<std::string>& options, const std::size_t first);
+
+/**
+ * Find regions of many --findRegion options in one pass over image. Result is union of regions
+ * or labelled mask (region of "i"-th option set to i+1) if "labelled" is set. Returns 0 on success.
+ */
+int handleRegions(ias::Analysis& object, const std::vector<std::string>& options, const bool labelled);
+
+
+#endif /* COMMANDS_H_ */
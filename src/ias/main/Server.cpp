@@ -0,0 +1,324 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "Server.h"
+
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <thread>
+#include <sstream>
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <opencv2/highgui/highgui.hpp>
+#include <boost/log/trivial.hpp>
+
+#include "ias/Analysis.h"
+#include "Commands.h"
+
+
+/// limit of request size
+static const uint32_t MAX_REQUEST_SIZE = 1 << 20;
+
+/// command line options allowed in session, they change only state of session's Analysis object
+static const char* const SESSION_COMMANDS[] = { "findRegion", "regionStats", "indexRegions", "findPerimeter",
+                                                "findSmoothPerimeter", "maskCache", "cacheStats", "parallelFill" };
+
+
+/// session commands which can not be sent without argument
+static const char* const ARGUMENT_COMMANDS[] = { "findRegion", "regionStats", "indexRegions", "maskCache" };
+
+
+static bool isSessionCommand(const std::string& command) {
+    for (const char* allowed: SESSION_COMMANDS) {
+        if (command.compare(allowed) == 0)
+            return true;
+    }
+    return false;
+}
+
+static bool requiresArgument(const std::string& command) {
+    for (const char* name: ARGUMENT_COMMANDS) {
+        if (command.compare(name) == 0)
+            return true;
+    }
+    return false;
+}
+
+
+static bool readAll(const int fd, char* buffer, std::size_t size) {
+    while (size > 0) {
+        const ssize_t got = ::read(fd, buffer, size);
+        if (got < 0 && errno == EINTR)
+            continue;
+        if (got <= 0)
+            return false;
+        buffer += got;
+        size -= got;
+    }
+    return true;
+}
+
+static bool writeAll(const int fd, const char* buffer, std::size_t size) {
+    while (size > 0) {
+        const ssize_t sent = ::write(fd, buffer, size);
+        if (sent < 0 && errno == EINTR)
+            continue;
+        if (sent <= 0)
+            return false;
+        buffer += sent;
+        size -= sent;
+    }
+    return true;
+}
+
+static bool readFrame(const int fd, std::string& payload) {
+    unsigned char header[4];
+    if (readAll(fd, (char*)header, 4) == false) {
+        return false;
+    }
+    const uint32_t size = ((uint32_t)header[0] << 24) | ((uint32_t)header[1] << 16) | ((uint32_t)header[2] << 8) | header[3];
+    if (size > MAX_REQUEST_SIZE) {
+        return false;
+    }
+    payload.resize(size);
+    if (size == 0) {
+        return true;
+    }
+    return readAll(fd, &payload[0], size);
+}
+
+static bool writeFrame(const int fd, const std::string& payload) {
+    const uint32_t size = payload.size();
+    const unsigned char header[4] = { (unsigned char)(size >> 24), (unsigned char)(size >> 16), (unsigned char)(size >> 8), (unsigned char)size };
+    if (writeAll(fd, (const char*)header, 4) == false) {
+        return false;
+    }
+    return writeAll(fd, payload.data(), payload.size());
+}
+
+
+ias::ImageFile ImageStore::get(const std::string& path) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::map<std::string, ias::ImageFile>::const_iterator found = images.find(path);
+        if (found != images.end()) {
+            return found->second;
+        }
+    }
+
+    /// decode without blocking other sessions
+    ias::ImageFile image;
+    if (image.load(path) == false) {
+        return image;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    /// other session could decode the same image in meantime
+    std::pair<std::map<std::string, ias::ImageFile>::iterator, bool> inserted = images.insert( std::make_pair(path, image) );
+    return inserted.first->second;
+}
+
+bool ImageStore::release(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return images.erase(path) > 0;
+}
+
+
+Server::~Server() {
+    joinSessions(true);
+}
+
+int Server::serveStdio() {
+    signal(SIGPIPE, SIG_IGN);
+    BOOST_LOG_TRIVIAL(info) << "serving on standard input/output";
+    session(STDIN_FILENO, STDOUT_FILENO);
+    return 0;
+}
+
+int Server::serveSocket(const std::string& socketPath) {
+    signal(SIGPIPE, SIG_IGN);
+
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        BOOST_LOG_TRIVIAL(error) << "socket path too long: " << socketPath;
+        return 1;
+    }
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    const int listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        BOOST_LOG_TRIVIAL(error) << "unable to create socket: " << std::strerror(errno);
+        return 1;
+    }
+    ::unlink(socketPath.c_str());
+    if (::bind(listenFd, (sockaddr*)&address, sizeof(address)) != 0 || ::listen(listenFd, 16) != 0) {
+        BOOST_LOG_TRIVIAL(error) << "unable to listen on socket " << socketPath << ": " << std::strerror(errno);
+        ::close(listenFd);
+        return 1;
+    }
+
+    BOOST_LOG_TRIVIAL(info) << "serving on socket: " << socketPath;
+    while (true) {
+        const int clientFd = ::accept(listenFd, NULL, NULL);
+        if (clientFd < 0) {
+            if (errno == EINTR)
+                continue;
+            BOOST_LOG_TRIVIAL(error) << "unable to accept client: " << std::strerror(errno);
+            break;
+        }
+        joinSessions(false);
+
+        SessionThread client;
+        client.fd = clientFd;
+        client.finished = std::make_shared< std::atomic<bool> >(false);
+        const std::shared_ptr< std::atomic<bool> > finished = client.finished;
+        client.thread = std::thread( [this, clientFd, finished]() {
+            session(clientFd, clientFd);
+            *finished = true;
+        } );
+        sessions.push_back( std::move(client) );
+    }
+
+    ::close(listenFd);
+    joinSessions(true);
+    return 1;
+}
+
+void Server::joinSessions(const bool all) {
+    for (std::list<SessionThread>::iterator item = sessions.begin(); item != sessions.end(); ) {
+        if (all == false && *item->finished == false) {
+            ++item;
+            continue;
+        }
+        if (*item->finished == false) {
+            /// unblock reading of request
+            ::shutdown(item->fd, SHUT_RDWR);
+        }
+        item->thread.join();
+        ::close(item->fd);
+        item = sessions.erase(item);
+    }
+}
+
+/// collects text output of commands, it is sent in response
+class SessionWriter: public FileWriter {
+public:
+
+    std::string text;
+
+    virtual void writeText(const std::string& output) {
+        text += output + "\n";
+    }
+
+};
+
+
+void Server::session(const int inFd, const int outFd) {
+    ias::Analysis object;
+    SessionWriter writer;
+    std::string request;
+
+    while ( readFrame(inFd, request) ) {
+        std::istringstream words(request);
+        std::string command;
+        std::string argument;
+        words >> command >> argument;
+
+        std::string response = "OK";
+        try {
+            if (command.compare("quit") == 0) {
+                writeFrame(outFd, response);
+                return ;
+
+            } else if (command.compare("load") == 0) {
+                const ias::ImageFile image = store.get(argument);
+                if (image.empty()) {
+                    response = "ERROR unable to load file: " + argument;
+                } else {
+                    object.setImage(image);
+                }
+
+            } else if (command.compare("unload") == 0) {
+                if (store.release(argument) == false) {
+                    response = "ERROR image not loaded: " + argument;
+                }
+
+            } else if (command.compare("fetch") == 0) {
+                const cv::Mat& result = object.result();
+                if (result.empty()) {
+                    response = "ERROR no result";
+                } else if (argument.empty()) {
+                    std::ostringstream header;
+                    header << "OK " << result.rows << " " << result.cols << "\n";
+                    response = header.str();
+                    for (int y = 0; y < result.rows; ++y) {
+                        response.append( (const char*)result.ptr<uchar>(y), result.cols );
+                    }
+                } else {
+                    std::vector<uchar> buffer;
+                    if (cv::imencode(argument, result, buffer) == false) {
+                        response = "ERROR unable to encode: " + argument;
+                    } else {
+                        response = "OK " + argument + "\n";
+                        response.append( buffer.begin(), buffer.end() );
+                    }
+                }
+
+            } else if (isSessionCommand(command) == false) {
+                response = "ERROR unknown command";
+
+            } else if (argument.empty() && requiresArgument(command)) {
+                response = "ERROR missing argument: " + command;
+
+            } else {
+                /// the same as command line option
+                std::string option = "--" + command;
+                if (argument.empty() == false) {
+                    option += "=" + argument;
+                }
+                writer.text.clear();
+                if (handleParam(object, option, writer) != 0) {
+                    response = "ERROR command failed: " + request;
+                } else if (writer.text.empty() == false) {
+                    response = "OK\n" + writer.text;
+                }
+            }
+        } catch (const std::exception& e) {
+            /// e.g. cv::Exception of unsupported format, other sessions keep running
+            BOOST_LOG_TRIVIAL(error) << "request failed: " << request << ": " << e.what();
+            response = std::string("ERROR ") + e.what();
+        }
+
+        if (writeFrame(outFd, response) == false) {
+            return ;
+        }
+    }
+}
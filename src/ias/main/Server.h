@@ -0,0 +1,128 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#ifndef SERVER_H_
+#define SERVER_H_
+
+#include <atomic>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "ias/ImageIO.h"
+
+
+/**
+ * Decoded images shared by all sessions of server.
+ */
+class ImageStore {
+
+    std::map<std::string, ias::ImageFile> images;
+    std::mutex mutex;
+
+
+public:
+
+    ImageStore(): images(), mutex() {
+    }
+
+    /// get decoded image, image is decoded on first request, returns empty image if failed
+    ias::ImageFile get(const std::string& path);
+
+    /// release image, returns false if image was not loaded
+    bool release(const std::string& path);
+
+};
+
+
+/**
+ * Long running server keeping decoded images in memory.
+ *
+ * Requests and responses are frames: 4 bytes of payload length (big-endian) followed by
+ * payload. Request payload is text command:
+ *      load [path]                         -- load image (decoded once for all sessions)
+ *      unload [path]                       -- release decoded image
+ *      findRegion [pX,pY,B,G,R,T]          -- the same as command line options
+ *      regionStats [pX,pY,B,G,R,T]
+ *      indexRegions [B,G,R,T]
+ *      findPerimeter [C]
+ *      findSmoothPerimeter
+ *      maskCache [MB]
+ *      cacheStats
+ *      parallelFill
+ *      fetch [.ext]                        -- get result, raw pixels or image encoded to format "ext"
+ *      quit                                -- end session
+ * Other commands (e.g. options changing global state or writing files) are answered
+ * with "ERROR unknown command". Response payload starts with "OK" or "ERROR <message>". Response of "fetch" is
+ * "OK <rows> <cols>\n" (or "OK <ext>\n") followed by data.
+ *
+ * Each client is handled by its own thread with its own Analysis object. Threads of
+ * ended sessions are joined when next client is accepted, remaining sessions are
+ * shut down and joined when server stops.
+ */
+class Server {
+
+    /// thread serving connected client, client socket is closed after thread is joined
+    struct SessionThread {
+        int fd;
+        std::shared_ptr< std::atomic<bool> > finished;
+        std::thread thread;
+    };
+
+    ImageStore store;
+    std::list<SessionThread> sessions;
+
+
+public:
+
+    Server(): store(), sessions() {
+    }
+
+    /// joins all session threads
+    ~Server();
+
+    /// serve single session on stdin/stdout, returns 0 on success
+    int serveStdio();
+
+    /// accept clients on Unix domain socket, returns only on error
+    int serveSocket(const std::string& socketPath);
+
+
+private:
+
+    void session(const int inFd, const int outFd);
+
+    /// join finished session threads, or all sessions if "all" is true
+    void joinSessions(const bool all);
+
+    Server(const Server&);
+
+    Server& operator=(const Server&);
+
+};
+
+
+#endif /* SERVER_H_ */
@@ -0,0 +1,114 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "StripMode.h"
+
+#include <cstdlib>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/log/trivial.hpp>
+
+#include "Commands.h"
+#include "ias/ThreadPool.h"
+
+
+StripMode::StripMode(const int stripRows): processor(stripRows), imageOpened(false), regionSet(false), pixelCoords(), color(), equalityMargin(0) {
+}
+
+int StripMode::handleParam(const std::string& option) {
+    std::vector<std::string> words;
+    boost::split(words, option, boost::is_any_of("="));
+
+    const std::string& param = words[0];
+    if ( param.compare("--logcout") == 0 || param.compare("--profile") == 0 ) {
+        return 0;
+
+    } else if ( param.compare("--image") == 0 && words.size() > 1 ) {
+        const std::string& path = words[1];
+        BOOST_LOG_TRIVIAL(info) << "opening image: " << path;
+        imageOpened = processor.open(path);
+        regionSet = false;
+        if (imageOpened == false) {
+            BOOST_LOG_TRIVIAL(error) << "unable to open file (only raw and PNM images are supported): " << path;
+            return 1;
+        }
+        const ias::ImageLayout& layout = processor.imageLayout();
+        BOOST_LOG_TRIVIAL(info) << "image size: " << layout.width << "x" << layout.height;
+        return 0;
+
+    } else if ( param.compare("--threads") == 0 && words.size() > 1 ) {
+        const int threads = atoi( words[1].c_str() );
+        if (threads < 0) {
+            BOOST_LOG_TRIVIAL(error) << "invalid number of threads: " << option;
+            return 1;
+        }
+        ias::ThreadPool::global().resize( threads );
+        BOOST_LOG_TRIVIAL(info) << "using threads: " << ias::ThreadPool::global().size();
+        return 0;
+
+    } else if ( param.compare("--findRegion") == 0 && words.size() > 1 ) {
+        RegionParams regionParams(words[1]);
+        if (regionParams.valid == false) {
+            BOOST_LOG_TRIVIAL(error) << "unable to parse: " << option;
+            return 1;
+        }
+        pixelCoords = regionParams.pixelCoords;
+        color = regionParams.color;
+        equalityMargin = regionParams.equalityMargin;
+        regionSet = true;
+        processor.clearOperations();
+        return 0;
+
+    } else if ( param.compare("--findPerimeter") == 0 ) {
+        int connectivity = 8;
+        if (words.size() > 1) {
+            connectivity = atoi( words[1].c_str() );
+            if (connectivity != 4 && connectivity != 8) {
+                BOOST_LOG_TRIVIAL(error) << "invalid connectivity: " << option;
+                return 1;
+            }
+        }
+        processor.addPerimeter(connectivity);
+        return 0;
+
+    } else if ( param.compare("--findSmoothPerimeter") == 0 ) {
+        processor.addSmoothPerimeter();
+        return 0;
+
+    } else if ( param.compare("--savePixels") == 0 && words.size() > 1 ) {
+        if (imageOpened == false || regionSet == false) {
+            BOOST_LOG_TRIVIAL(error) << "missing --image or --findRegion before: " << option;
+            return 1;
+        }
+        const std::string& path = words[1];
+        BOOST_LOG_TRIVIAL(info) << "calculating region in strips: " << pixelCoords.x << "," << pixelCoords.y << ", saving result to file: " << path;
+        if (processor.findRegion(pixelCoords, color, equalityMargin, path) == false) {
+            BOOST_LOG_TRIVIAL(error) << "unable to save file (only raw and PGM files are supported): " << path;
+            return 1;
+        }
+        return 0;
+    }
+
+    BOOST_LOG_TRIVIAL(error) << "option not supported in strip mode: " << option;
+    return 1;
+}
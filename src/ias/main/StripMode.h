@@ -0,0 +1,61 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#ifndef STRIPMODE_H_
+#define STRIPMODE_H_
+
+#include <string>
+
+#include "ias/StripProcessor.h"
+
+
+/**
+ * Handling of command line options after --strips command.
+ *
+ * Image is not loaded to memory, it is processed in strips of given number of rows.
+ * Result is calculated when --savePixels command is given:
+ *      --strips=1024 --image=big.raw --findRegion=0,0,0,0,255,20 --findPerimeter --savePixels=out.pgm
+ * Only raw and PNM images are supported, result can be saved to raw or PGM file.
+ */
+class StripMode {
+
+    ias::StripProcessor processor;
+
+    bool imageOpened;
+    bool regionSet;
+    cv::Point pixelCoords;
+    cv::Vec3b color;
+    uchar equalityMargin;
+
+
+public:
+
+    explicit StripMode(const int stripRows);
+
+    /// execute single command line option, returns 0 on success
+    int handleParam(const std::string& option);
+
+};
+
+
+#endif /* STRIPMODE_H_ */
@@ -21,6 +21,9 @@
 /// SOFTWARE.
 ///
 
+#include <cstdlib>
+#include <fstream>
+#include <memory>
 #include <sstream>
 
 #include <boost/algorithm/string.hpp>
@@ -29,6 +32,11 @@
 #include <boost/log/utility/setup/file.hpp>
 
 #include "ias/Analysis.h"
+#include "ias/Profiler.h"
+#include "Batch.h"
+#include "Commands.h"
+#include "Server.h"
+#include "StripMode.h"
 
 
 static bool findFlag(int argc, char **argv, const std::string& flag) {
@@ -40,116 +48,63 @@ static bool findFlag(int argc, char **argv, const std::string& flag) {
     return false;
 }
 
-
-class RegionParams {
-public:
-
-    bool valid;
-
-    cv::Point pixelCoords;
-    cv::Vec3b color;
-    uchar equalityMargin;
-
-
-private:
-
-    std::istringstream iss;
-
-
-public:
-
-    RegionParams(const std::string& input): valid(false), pixelCoords(), color(), equalityMargin(), iss(input) {
-        const int x = read<int>(); readSeparator();
-        const int y = read<int>(); readSeparator();
-        pixelCoords = cv::Point(x, y);
-
-        const int b = read<int>(); readSeparator();
-        const int g = read<int>(); readSeparator();
-        const int r = read<int>(); readSeparator();
-        color = cv::Vec3b(b, g, r);
-
-        equalityMargin = read<int>();
-
-        valid = true;
+/// find "--option" or "--option=value"
+static bool findOption(int argc, char **argv, const std::string& option, std::string& value) {
+    for(int i=1; i<argc; ++i) {
+        const std::string param = argv[i];
+        if (param.compare( option ) == 0) {
+            value.clear();
+            return true;
+        }
+        if (param.compare( 0, option.size() + 1, option + "=" ) == 0) {
+            value = param.substr( option.size() + 1 );
+            return true;
+        }
     }
+    return false;
+}
 
 
-private:
-
-    template<typename Type>
-    Type read() {
-        Type value;
-        iss >> value;
-        return value;
-    }
-
-    void readSeparator() {
-        read<char>();
-    }
+/// logs measurements of processing stages (or writes them to JSON file) on exit
+class ProfileReport {
 
-};
+    const bool enabled;
+    const std::string outputPath;
 
 
-static int handleParam(ias::Analysis& object, const std::string& option) {
-    std::vector<std::string> words;
-    boost::split(words, option, boost::is_any_of("="));
+public:
 
-    if (words.empty()) {
-        BOOST_LOG_TRIVIAL(error) << "bad argument: " << option;
-        return 1;
+    ProfileReport(const bool enable, const std::string& path): enabled(enable), outputPath(path) {
+        if (enabled == false)
+            return ;
+        if (ias::Profiler::compiled() == false) {
+            BOOST_LOG_TRIVIAL(warning) << "profiling is not compiled in (IAS_PROFILING option)";
+        }
+        ias::Profiler::global().setEnabled(true);
     }
 
-    const std::string& param = words[0];
-    if ( param.compare("--image") == 0 ) {
-        const std::string& path = words[1];
-        BOOST_LOG_TRIVIAL(info) << "loading image: " << path;
-        const bool valid = object.loadImage(path);
-        if (valid == false) {
-            BOOST_LOG_TRIVIAL(error) << "unable to load file: " << path;
-            return 1;
+    ~ProfileReport() {
+        if (enabled == false)
+            return ;
+        const ias::Profiler& profiler = ias::Profiler::global();
+        if (outputPath.empty() == false) {
+            std::ofstream output( outputPath.c_str() );
+            profiler.writeJson(output);
+            if (output.fail()) {
+                BOOST_LOG_TRIVIAL(error) << "unable to write profile: " << outputPath;
+            }
+            return ;
         }
-
-    } else if ( param.compare("--findRegion") == 0 ) {
-        const std::string& input = words[1];
-        RegionParams regionParams(input);
-        if (regionParams.valid == false) {
-            BOOST_LOG_TRIVIAL(error) << "unable to parse: " << option;
-            return 1;
+        std::ostringstream text;
+        profiler.writeText(text);
+        std::string line;
+        std::istringstream lines( text.str() );
+        while ( std::getline(lines, line) ) {
+            BOOST_LOG_TRIVIAL(info) << "profile: " << line;
         }
-        BOOST_LOG_TRIVIAL(info) << "calculating region: " << input;
-        object.findRegion( regionParams.pixelCoords, regionParams.color, regionParams.equalityMargin );
-        return 0;
-
-    } else if ( param.compare("--findPerimeter") == 0 ) {
-        BOOST_LOG_TRIVIAL(info) << "calculating perimeter";
-        object.findPerimeter();
-        return 0;
-
-    } else if ( param.compare("--findSmoothPerimeter") == 0 ) {
-        BOOST_LOG_TRIVIAL(info) << "calculating smooth perimeter";
-        object.findSmoothPerimeter();
-        return 0;
-
-    } else if ( param.compare("--displayImage") == 0 ) {
-        BOOST_LOG_TRIVIAL(info) << "displaying image";
-        object.displayImage();
-
-    } else if ( param.compare("--displayPixels") == 0 ) {
-        BOOST_LOG_TRIVIAL(info) << "displaying result";
-        object.displayPixels();
-
-    } else if ( param.compare("--displayJoin") == 0 ) {
-        BOOST_LOG_TRIVIAL(info) << "displaying image and result on one window";
-        object.displayJoin();
-
-    } else if ( param.compare("--savePixels") == 0 ) {
-        const std::string& path = words[1];
-        BOOST_LOG_TRIVIAL(info) << "saving result to file: " << path;
-        object.storeResult(path);
     }
 
-    return 0;
-}
+};
 
 
 int main(int argc, char **argv) {
@@ -166,26 +121,139 @@ int main(int argc, char **argv) {
         std::cout << "Options:" << std::endl;
         std::cout << "  --help                          Help screen" << std::endl;
         std::cout << "  --logcout                       Output to console" << std::endl;
+        std::cout << "  --profile[=path]                Log time, processed pixels and allocated bytes of each processing stage" << std::endl;
+        std::cout << "                                  on exit, or write them as JSON to file 'path'" << std::endl;
+        std::cout << "  --threads=[N]                   Number of threads used by next commands (0 - number of CPU cores)" << std::endl;
+        std::cout << "  --parallelFill                  Find regions by parallel labeling of whole image when --threads > 1" << std::endl;
+        std::cout << "                                  (faster only for regions covering big part of image)" << std::endl;
         std::cout << "  --image=[path]                  Open image from file 'path'" << std::endl;
         std::cout << "  --findRegion=[pX,pY,B,G,R,T]    Calculate region of region calculated by --findRegion command where:" << std::endl;
         std::cout << "                                  -- pX,pY are coordinates of pixel on loaded image" << std::endl;
         std::cout << "                                  -- B,G,R are components of color to find" << std::endl;
         std::cout << "                                  -- T      is tolerance of color" << std::endl;
-        std::cout << "  --findPerimeter                 Calculate perimeter of region calculated by --findRegion command" << std::endl;
+        std::cout << "                                  Consecutive --findRegion commands calculate union of regions" << std::endl;
+        std::cout << "                                  of all seeds and colors in one pass over image" << std::endl;
+        std::cout << "  --regionLabels                  Following groups of --findRegion commands calculate labelled mask" << std::endl;
+        std::cout << "                                  (region of i-th command has value i) instead of union" << std::endl;
+        std::cout << "  --regionStats=[pX,pY,B,G,R,T]   Print statistics of region (area, bounding box, centroid, perimeter," << std::endl;
+        std::cout << "                                  touching border) as JSON, parameters are the same as of --findRegion" << std::endl;
+        std::cout << "  --maskCache=[MB]                Cache binarized images used by --findRegion, MB is size limit (0 - disabled)" << std::endl;
+        std::cout << "  --cacheStats                    Log hit/miss statistics of mask cache" << std::endl;
+        std::cout << "  --bufferPool=[MB]               Size limit of pool of reused temporary masks (0 - disabled, default 256)" << std::endl;
+        std::cout << "  --poolStats                     Log allocation statistics of buffer pool" << std::endl;
+        std::cout << "  --indexRegions=[B,G,R,T]        Label all regions of color on loaded image, following --findRegion" << std::endl;
+        std::cout << "                                  commands with the same color and tolerance use the index" << std::endl;
+        std::cout << "  --findPerimeter[=C]             Calculate perimeter of region calculated by --findRegion command" << std::endl;
+        std::cout << "                                  -- C is connectivity of perimeter (4 or 8, default 8)" << std::endl;
+        std::cout << "  --compression=[N]               Level of PNG compression of saved results (0..9, default 6 for binary masks)" << std::endl;
+        std::cout << "  --asyncSave                     Save results on background thread, while following commands are executed" << std::endl;
         std::cout << "  --displayImage                  Display opened image" << std::endl;
         std::cout << "  --displayPixels                 Display result of find* command" << std::endl;
         std::cout << "  --savePixels=[path]             Save result of find* command to file 'path'" << std::endl;
+        std::cout << "                                  (masks are saved to .png as 1-bit PNG, .pbm and .rle are compact mask formats)" << std::endl;
+        std::cout << "  --batchWorkers=[N]              Number of threads of each stage of --batch command (default 1)" << std::endl;
+        std::cout << "  --batch=[path]                  Process images listed in manifest file 'path', each line contains" << std::endl;
+        std::cout << "                                  path of image and options, e.g. 'in.png --findRegion=0,0,0,0,0,0 --savePixels=out.png'" << std::endl;
+        std::cout << "  --strips=[H]                    Process following commands on image not loaded to memory, in strips" << std::endl;
+        std::cout << "                                  of H rows, e.g. '--strips=1024 --image=in.raw --findRegion=0,0,0,0,0,0" << std::endl;
+        std::cout << "                                  --findPerimeter --savePixels=out.pgm' (raw and PNM files only)" << std::endl;
+        std::cout << "  --serve[=path]                  Run server on Unix domain socket 'path' or on standard input/output," << std::endl;
+        std::cout << "                                  requests are length-prefixed commands: load, findRegion, findPerimeter," << std::endl;
+        std::cout << "                                  findSmoothPerimeter, fetch, quit" << std::endl;
         return 0;
     }
 
+    std::string profilePath;
+    const bool profile = findOption(argc, argv, "--profile", profilePath);
+    const ProfileReport profileReport(profile, profilePath);
+
     ias::Analysis object;
+    FileWriter fileWriter;
+    std::unique_ptr<AsyncFileWriter> asyncWriter;           /// worker thread is started by --asyncSave
+    ResultWriter* writer = &fileWriter;
+    std::size_t batchWorkers = 1;
+    bool regionLabels = false;
+    const std::vector<std::string> args(argv, argv + argc);
 
     for(int i=1; i<argc; ++i) {
         const std::string param = argv[i];
-        const int ret = handleParam(object, param);
+
+        std::vector<std::string> words;
+        boost::split(words, param, boost::is_any_of("="));
+        if (words.size() > 1 && words[0].compare("--batchWorkers") == 0) {
+            const int workers = atoi( words[1].c_str() );
+            if (workers < 1) {
+                BOOST_LOG_TRIVIAL(error) << "invalid number of workers: " << param;
+                return 1;
+            }
+            batchWorkers = workers;
+            continue;
+        }
+        if (words[0].compare("--serve") == 0) {
+            Server server;
+            if (words.size() > 1)
+                return server.serveSocket(words[1]);
+            return server.serveStdio();
+        }
+        if (words.size() > 1 && words[0].compare("--strips") == 0) {
+            const int stripRows = atoi( words[1].c_str() );
+            if (stripRows < 1) {
+                BOOST_LOG_TRIVIAL(error) << "invalid number of rows: " << param;
+                return 1;
+            }
+            StripMode strips(stripRows);
+            for (++i; i<argc; ++i) {
+                const int ret = strips.handleParam( argv[i] );
+                if (ret != 0)
+                    return ret;
+            }
+            return 0;
+        }
+        if (words.size() > 1 && words[0].compare("--batch") == 0) {
+            Batch batch(batchWorkers);
+            batch.setCompression( writer->compressionLevel() );
+            if (batch.load(words[1]) == false) {
+                BOOST_LOG_TRIVIAL(error) << "unable to read manifest: " << words[1];
+                return 1;
+            }
+            BOOST_LOG_TRIVIAL(info) << "processing batch: " << words[1];
+            if (batch.run() > 0)
+                return 1;
+            continue;
+        }
+
+        if (words[0].compare("--regionLabels") == 0) {
+            regionLabels = true;
+            continue;
+        }
+        const std::size_t regionCount = regionGroupSize(args, i);
+        if (regionCount > 1 || (regionCount == 1 && regionLabels)) {
+            /// consecutive --findRegion options are found together
+            const std::vector<std::string> regions( args.begin() + i, args.begin() + i + regionCount );
+            const int ret = handleRegions(object, regions, regionLabels);
+            if (ret != 0)
+                return ret;
+            i += regionCount - 1;
+            continue;
+        }
+
+        if (words[0].compare("--asyncSave") == 0) {
+            if (!asyncWriter) {
+                asyncWriter.reset( new AsyncFileWriter() );
+            }
+            asyncWriter->setCompression( writer->compressionLevel() );
+            writer = asyncWriter.get();
+            continue;
+        }
+
+        const int ret = handleParam(object, param, *writer);
         if (ret != 0)
             return ret;
     }
 
+    if (asyncWriter && asyncWriter->close() > 0) {
+        BOOST_LOG_TRIVIAL(error) << "unable to save results";
+        return 1;
+    }
     return 0;
 }
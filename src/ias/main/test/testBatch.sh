@@ -0,0 +1,79 @@
+#!/bin/bash
+
+
+SCRIPT_DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )"
+
+
+pushd $SCRIPT_DIR > /dev/null
+
+
+IAS_APP=./../iascli
+DATA_DIR=../../test/data
+
+
+echo -e "Testing batch processing"
+cat > batch_manifest.txt << EOL
+# image and options
+$DATA_DIR/test1.png --findRegion=200,200,0,0,249,20 --savePixels=batch1.png --findPerimeter --savePixels=batch2.png
+$DATA_DIR/test1.png --findRegion=0,0,255,255,255,20 --findSmoothPerimeter --savePixels=batch3.png
+EOL
+$IAS_APP --logcout --batchWorkers=2 --batch=batch_manifest.txt
+EXIT_CODE=$?
+if [ $EXIT_CODE -ne 0 ]; then
+	echo "Test failed -- could not process batch"
+	exit 1
+fi
+if [ ! -f batch1.png ] || [ ! -f batch2.png ] || [ ! -f batch3.png ]; then
+	echo "Test failed -- missing results"
+	exit 1
+fi
+echo "Passed"
+
+
+echo -e "\nTesting batch with missing image"
+echo "$DATA_DIR/not_found.png --findRegion=0,0,0,0,0,0" > batch_manifest.txt
+$IAS_APP --logcout --batch=batch_manifest.txt
+EXIT_CODE=$?
+if [ $EXIT_CODE -eq 0 ]; then
+	echo "Test failed -- should return error"
+	exit 1
+else
+	echo "Passed"
+fi
+
+
+
+echo -e "\nTesting batch with failing jobs"
+rm -f batch1.png
+cat > batch_manifest.txt << EOL
+$DATA_DIR/test1.png --findRegion=200,200,0,0,249,20 --savePixels=batch1.xyz
+$DATA_DIR/test1.png --findRegion --savePixels=batch2.png
+$DATA_DIR/test1.png --findRegion=200,200,0,0,249,20 --savePixels=batch1.png
+EOL
+OUTPUT=$( $IAS_APP --logcout --batchWorkers=2 --batch=batch_manifest.txt 2>&1 )
+EXIT_CODE=$?
+if [ $EXIT_CODE -eq 0 ] || [[ "$OUTPUT" != *"jobs: 3 failed: 2"* ]] || [ ! -f batch1.png ]; then
+	echo "Test failed -- failed jobs should be reported: $OUTPUT"
+	exit 1
+else
+	echo "Passed"
+fi
+
+
+echo -e "\nTesting batch with global options"
+cat > batch_manifest.txt << EOL
+$DATA_DIR/test1.png --threads=4 --findRegion=200,200,0,0,249,20 --savePixels=batch1.png
+$DATA_DIR/test1.png --bufferPool=0 --findRegion=200,200,0,0,249,20 --savePixels=batch1.png
+$DATA_DIR/test1.png --asyncSave --findRegion=200,200,0,0,249,20 --savePixels=batch1.png
+EOL
+OUTPUT=$( $IAS_APP --logcout --batch=batch_manifest.txt 2>&1 )
+EXIT_CODE=$?
+if [ $EXIT_CODE -eq 0 ] || [[ "$OUTPUT" != *"jobs: 3 failed: 3"* ]] || [[ "$OUTPUT" != *"option not supported in batch mode"* ]]; then
+	echo "Test failed -- global options should fail jobs: $OUTPUT"
+	exit 1
+else
+	echo "Passed"
+fi
+
+
+popd > /dev/null
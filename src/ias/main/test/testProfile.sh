@@ -0,0 +1,36 @@
+#!/bin/bash
+
+
+SCRIPT_DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )"
+
+
+pushd $SCRIPT_DIR > /dev/null
+
+
+IAS_APP=./../iascli
+DATA_DIR=../../test/data
+OUT_DIR=/tmp/ias_profile
+mkdir -p $OUT_DIR
+
+
+echo -e "Testing profile of stages"
+rm -f $OUT_DIR/profile.json
+$IAS_APP --profile=$OUT_DIR/profile.json --image=$DATA_DIR/test1.png --findRegion=200,200,0,0,249,20 --findPerimeter --savePixels=$OUT_DIR/perimeter.png
+EXIT_CODE=$?
+if [ $EXIT_CODE -ne 0 ]; then
+	echo "Test failed -- could not process image"
+	exit 1
+fi
+PROFILE=$( cat $OUT_DIR/profile.json )
+if [[ "$PROFILE" != *\"stages\"* ]]; then
+	echo "Test failed -- invalid profile: $PROFILE"
+	exit 1
+fi
+if [[ "$PROFILE" == *\"stage\"* ]] && [[ "$PROFILE" != *Analysis::region* ]]; then
+	echo "Test failed -- missing region stage: $PROFILE"
+	exit 1
+fi
+echo "Passed"
+
+
+popd > /dev/null
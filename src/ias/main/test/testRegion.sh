@@ -33,4 +33,40 @@ else
 fi
 
 
+
+echo -e "\nTesting union of regions of many seeds and colors"
+rm -f out2.png
+$IAS_APP --logcout --image=$DATA_DIR/test1.png --findRegion=200,200,0,0,249,20 --findRegion=0,30,0,0,255,20 --savePixels=out2.png
+EXIT_CODE=$?
+if [ $EXIT_CODE -ne 0 ] || [ ! -f out2.png ]; then
+	echo "Test failed -- could not find union of regions"
+	exit 1
+else
+	echo "Passed"
+fi
+
+
+echo -e "\nTesting labelled regions"
+rm -f out3.pgm
+$IAS_APP --logcout --image=$DATA_DIR/test1.png --regionLabels --findRegion=200,200,0,0,249,20 --findRegion=0,30,0,0,255,20 --savePixels=out3.pgm
+EXIT_CODE=$?
+if [ $EXIT_CODE -ne 0 ] || [ ! -f out3.pgm ]; then
+	echo "Test failed -- could not find labelled regions"
+	exit 1
+else
+	echo "Passed"
+fi
+
+
+echo -e "\nTesting union of regions with invalid parameters"
+$IAS_APP --logcout --image=$DATA_DIR/test1.png --findRegion=200,200,0,0,249,20 --findRegion=0,30
+EXIT_CODE=$?
+if [ $EXIT_CODE -eq 0 ]; then
+	echo "Test failed -- should return error"
+	exit 1
+else
+	echo "Passed"
+fi
+
+
 popd > /dev/null
@@ -0,0 +1,49 @@
+#!/bin/bash
+
+
+SCRIPT_DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )"
+
+
+pushd $SCRIPT_DIR > /dev/null
+
+
+IAS_APP=./../iascli
+DATA_DIR=../../test/data
+
+
+echo -e "Testing saving masks in background"
+$IAS_APP --logcout --compression=9 --asyncSave --image=$DATA_DIR/test1.png --findRegion=200,200,0,0,249,20 --savePixels=save1.png --savePixels=save1.pbm --savePixels=save1.rle --findPerimeter --savePixels=save2.png
+EXIT_CODE=$?
+if [ $EXIT_CODE -ne 0 ]; then
+	echo "Test failed -- could not save results"
+	exit 1
+fi
+if [ ! -f save1.png ] || [ ! -f save1.pbm ] || [ ! -f save1.rle ] || [ ! -f save2.png ]; then
+	echo "Test failed -- missing results"
+	exit 1
+fi
+echo "Passed"
+
+
+echo -e "\nTesting loading saved masks"
+$IAS_APP --logcout --image=save1.pbm --savePixels=save3.pgm --image=save1.rle --savePixels=save4.pgm
+EXIT_CODE=$?
+if [ $EXIT_CODE -ne 0 ]; then
+	echo "Test failed -- could not load masks"
+	exit 1
+fi
+echo "Passed"
+
+
+echo -e "\nTesting invalid compression level"
+$IAS_APP --logcout --compression=10
+EXIT_CODE=$?
+if [ $EXIT_CODE -eq 0 ]; then
+	echo "Test failed -- should return error"
+	exit 1
+else
+	echo "Passed"
+fi
+
+
+popd > /dev/null
@@ -0,0 +1,81 @@
+#!/bin/bash
+
+
+SCRIPT_DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )"
+
+
+pushd $SCRIPT_DIR > /dev/null
+
+
+IAS_APP=./../iascli
+DATA_DIR=../../test/data
+
+
+## print frame: 4 bytes of length (big-endian) and payload
+frame() {
+	local LEN=${#1}
+	printf "\\x$(printf %02x $((LEN >> 24 & 255)))\\x$(printf %02x $((LEN >> 16 & 255)))\\x$(printf %02x $((LEN >> 8 & 255)))\\x$(printf %02x $((LEN & 255)))%s" "$1"
+}
+
+
+echo -e "Testing server on standard input/output"
+RESPONSE=$( { frame "load $DATA_DIR/test1.png"; frame "findRegion 200,200,0,0,249,20"; frame "findPerimeter"; frame "quit"; } | $IAS_APP --serve | tr -d '\000-\011' )
+if [ "$RESPONSE" != "OKOKOKOK" ]; then
+	echo "Test failed -- invalid response: $RESPONSE"
+	exit 1
+else
+	echo "Passed"
+fi
+
+
+echo -e "\nTesting region statistics in server response"
+RESPONSE=$( { frame "load $DATA_DIR/test1.png"; frame "regionStats 200,200,0,0,249,20"; frame "quit"; } | $IAS_APP --serve | tr -d '\000-\011' )
+if [[ "$RESPONSE" != *\"area\"* ]]; then
+	echo "Test failed -- missing statistics: $RESPONSE"
+	exit 1
+else
+	echo "Passed"
+fi
+
+
+echo -e "\nTesting server rejecting options outside of session"
+RESPONSE=$( { frame "savePixels /tmp/ias_serve_test.png"; frame "threads 1"; frame "findRegon 200,200,0,0,249,20"; frame "quit"; } | $IAS_APP --serve | tr -d '\000-\011' )
+if [[ "$RESPONSE" != *"ERROR unknown command"*"ERROR unknown command"*"ERROR unknown command"*OK ]]; then
+	echo "Test failed -- should reject commands: $RESPONSE"
+	exit 1
+else
+	echo "Passed"
+fi
+
+
+echo -e "\nTesting server rejecting commands without argument"
+RESPONSE=$( { frame "load $DATA_DIR/test1.png"; frame "findRegion"; frame "regionStats"; frame "indexRegions"; frame "maskCache"; frame "findPerimeter"; frame "quit"; } | $IAS_APP --serve | tr -d '\000-\011' )
+if [[ "$RESPONSE" != OK*"ERROR missing argument: findRegion"*"ERROR missing argument: regionStats"*"ERROR missing argument: indexRegions"*"ERROR missing argument: maskCache"*OK*OK ]]; then
+	echo "Test failed -- should reject commands: $RESPONSE"
+	exit 1
+else
+	echo "Passed"
+fi
+
+
+echo -e "\nTesting server session surviving failed request"
+RESPONSE=$( { frame "load $DATA_DIR/test1.png"; frame "findRegion 200,200,0,0,249,20"; frame "fetch foo"; frame "findPerimeter"; frame "quit"; } | $IAS_APP --serve | tr -d '\000-\011' )
+if [[ "$RESPONSE" != OKOK*ERROR*OK*OK ]]; then
+	echo "Test failed -- invalid response: $RESPONSE"
+	exit 1
+else
+	echo "Passed"
+fi
+
+
+echo -e "\nTesting server with missing image"
+RESPONSE=$( { frame "load $DATA_DIR/not_found.png"; frame "quit"; } | $IAS_APP --serve | tr -d '\000-\011' )
+if [[ "$RESPONSE" != *ERROR* ]]; then
+	echo "Test failed -- should return error: $RESPONSE"
+	exit 1
+else
+	echo "Passed"
+fi
+
+
+popd > /dev/null
@@ -0,0 +1,39 @@
+#!/bin/bash
+
+
+SCRIPT_DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )"
+
+
+pushd $SCRIPT_DIR > /dev/null
+
+
+IAS_APP=./../iascli
+DATA_DIR=../../test/data
+
+
+echo -e "Testing region statistics"
+OUTPUT=$( $IAS_APP --image=$DATA_DIR/test1.png --regionStats=200,200,0,0,249,20 )
+EXIT_CODE=$?
+if [ $EXIT_CODE -ne 0 ]; then
+	echo "Test failed -- could not calculate statistics"
+	exit 1
+fi
+if [[ "$OUTPUT" != *\"area\"* ]] || [[ "$OUTPUT" != *\"perimeter\"* ]] || [[ "$OUTPUT" != *\"touchesBorder\"* ]]; then
+	echo "Test failed -- invalid output: $OUTPUT"
+	exit 1
+fi
+echo "Passed"
+
+
+echo -e "\nTesting region statistics with invalid parameters"
+$IAS_APP --logcout --image=$DATA_DIR/test1.png --regionStats=200
+EXIT_CODE=$?
+if [ $EXIT_CODE -eq 0 ]; then
+	echo "Test failed -- should return error"
+	exit 1
+else
+	echo "Passed"
+fi
+
+
+popd > /dev/null
@@ -0,0 +1,45 @@
+#!/bin/bash
+
+
+SCRIPT_DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )"
+
+
+pushd $SCRIPT_DIR > /dev/null
+
+
+IAS_APP=./../iascli
+DATA_DIR=../../test/data
+
+
+echo -e "Testing strip processing"
+$IAS_APP --logcout --image=$DATA_DIR/test1.png --findRegion=200,200,0,0,249,20 --savePixels=strips_region.pgm --findPerimeter --savePixels=strips_expected.pgm
+EXIT_CODE=$?
+if [ $EXIT_CODE -ne 0 ]; then
+	echo "Test failed -- could not find region"
+	exit 1
+fi
+$IAS_APP --logcout --strips=7 --image=strips_region.pgm --findRegion=200,200,255,255,255,0 --findPerimeter --savePixels=strips_result.pgm
+EXIT_CODE=$?
+if [ $EXIT_CODE -ne 0 ]; then
+	echo "Test failed -- could not process strips"
+	exit 1
+fi
+if ! cmp -s strips_expected.pgm strips_result.pgm; then
+	echo "Test failed -- results differ"
+	exit 1
+fi
+echo "Passed"
+
+
+echo -e "\nTesting strip processing of compressed image"
+$IAS_APP --logcout --strips=7 --image=$DATA_DIR/test1.png --findRegion=0,0,0,0,0,0 --savePixels=strips_result.pgm
+EXIT_CODE=$?
+if [ $EXIT_CODE -eq 0 ]; then
+	echo "Test failed -- should return error"
+	exit 1
+else
+	echo "Passed"
+fi
+
+
+popd > /dev/null
@@ -25,23 +25,40 @@
 
 #include <opencv2/opencv.hpp>
 
+#include "ias/Profiler.h"
+#include "ias/RowPipeline.h"
+#include "ias/ThreadPool.h"
+
 
 using namespace cv;
 
 
 namespace ias {
 
-    Analysis::Analysis(): currentImage(), lastResult() {
+    Analysis::Analysis(): imageFile(), currentImage(), lastResult(), regionIndex(), binarizedCache(), cacheMutex(), parallelFill(false) {
     }
 
     Analysis::~Analysis() {
     }
 
     bool Analysis::loadImage(const std::string& imagePath) {
-        currentImage = imread(imagePath, 1);                               /// BGR format
+        ImageFile file;
+        file.load(imagePath);                                               /// BGR format
+        setImage( file );
         return !currentImage.empty();
     }
 
+    void Analysis::setImage(const cv::Mat& image) {
+        setImage( ImageFile(image) );
+    }
+
+    void Analysis::setImage(const ImageFile& image) {
+        imageFile = image;
+        currentImage = imageFile.image();
+        regionIndex = RegionIndex();
+        binarizedCache.clear();
+    }
+
     cv::Vec3b Analysis::color(const int y, const int x ) const {
         if (currentImage.empty()) {
             return cv::Vec3b();
@@ -74,119 +91,171 @@ namespace ias {
         return currentImage.at<cv::Vec3b>( pixel );
     }
 
-    void Analysis::findRegion(const cv::Point& pixelCoords, const cv::Vec3b& color, const uchar tolerance) {
-        lastResult.invalidate();
+    MaskC1 Analysis::region(const cv::Point& pixelCoords, const cv::Vec3b& color, const uchar tolerance) const {
         if (currentImage.empty()) {
-            return ;
+            return MaskC1();
         }
+        IAS_PROFILE_SCOPE("Analysis::region", currentImage.total());
 
-        lastResult = MaskC1( currentImage, color, tolerance );
-        lastResult.floodFill(pixelCoords, 255, 127, 0);
-        lastResult.changeColor( 127, 255 );
-    }
-
-    void Analysis::findPerimeter(const cv::Mat& regionsMask ) {
-        if (currentImage.empty()) {
-            lastResult.invalidate();
-            return ;
-        }
-        if (regionsMask.empty()) {
-            lastResult.invalidate();
-            return ;
+        if (regionIndex.matches(color, tolerance)) {
+            return regionIndex.regionMask(pixelCoords);
         }
 
-        const int nRows = currentImage.rows;
-        const int nCols = currentImage.cols;
-        if (nRows != regionsMask.rows || nCols != regionsMask.cols) {
-            lastResult.invalidate();
-            return ;
+        if (binarizedCache.enabled()) {
+            cv::Mat binarized;
+            {
+                std::lock_guard<std::mutex> lock(cacheMutex);
+                binarized = binarizedCache.find(color, tolerance);
+            }
+            if (binarized.empty()) {
+                /// binarize without lock, concurrent queries of the same color can binarize twice
+                binarized = MaskC1( currentImage, color, tolerance ).data();
+                std::lock_guard<std::mutex> lock(cacheMutex);
+                binarizedCache.insert(color, tolerance, binarized);
+            }
+            return MaskC1( binarized, pixelCoords, 255 );
         }
 
-        lastResult = MaskC1(regionsMask);
+        if (parallelFill && ThreadPool::global().size() > 1) {
+            /// labels whole image, pays off only for regions covering big part of image
+            MaskC1 result( currentImage, color, tolerance );
+            result.floodFillParallel(pixelCoords, 255, 127, 0);
+            result.changeColor( 127, 255 );
+            return result;
+        }
 
-        detectEdges();
-        lastResult.threshold(128);
+        /// color is tested only on pixels reached by the fill
+        return MaskC1( currentImage, pixelCoords, color, tolerance );
     }
 
-    void Analysis::detectEdges() {
-        cv::Mat filter = cv::Mat::zeros( 3, 3, CV_64F );
-
-        /// Laplace filter
-        filter.at<double>(0,0) = -1;
-        filter.at<double>(0,1) = -1;
-        filter.at<double>(0,2) = -1;
+    void Analysis::findRegion(const cv::Point& pixelCoords, const cv::Vec3b& color, const uchar tolerance) {
+        lastResult.invalidate();
+        lastResult = region(pixelCoords, color, tolerance);
+    }
 
-        filter.at<double>(1,0) = -1;
-        filter.at<double>(1,1) =  8;
-        filter.at<double>(1,2) = -1;
+    MaskC1 Analysis::region(const std::vector<RegionQuery>& queries, const bool labelled) const {
+        if (currentImage.empty() || queries.empty()) {
+            return MaskC1();
+        }
+        if (queries.size() == 1 && labelled == false) {
+            /// single region can use index and cache
+            const RegionQuery& query = queries[0];
+            return region(query.seed, query.color, query.tolerance);
+        }
+        return findRegions(currentImage, queries, labelled);
+    }
 
-        filter.at<double>(2,0) = -1;
-        filter.at<double>(2,1) = -1;
-        filter.at<double>(2,2) = -1;
+    void Analysis::findRegion(const std::vector<RegionQuery>& queries, const bool labelled) {
+        lastResult.invalidate();
+        lastResult = region(queries, labelled);
+    }
 
-//        filter.at<double>(0,1) = -1;
-//        filter.at<double>(1,0) = -1;
-//        filter.at<double>(1,1) =  4;
-//        filter.at<double>(1,2) = -1;
-//        filter.at<double>(2,1) = -1;
+    RleMask Analysis::findRegionRle(const cv::Point& pixelCoords, const cv::Vec3b& color, const uchar tolerance) const {
+        if (currentImage.empty()) {
+            return RleMask();
+        }
+        IAS_PROFILE_SCOPE("Analysis::findRegionRle", currentImage.total());
+        if (regionIndex.matches(color, tolerance)) {
+            return regionIndex.regionRle(pixelCoords);
+        }
+        return RleMask::fill(currentImage, pixelCoords, color, tolerance);
+    }
 
-        lastResult.applyFilter(filter);
+    RegionStats Analysis::regionStats(const cv::Point& pixelCoords, const cv::Vec3b& color, const uchar tolerance) const {
+        IAS_PROFILE_SCOPE("Analysis::regionStats", currentImage.total());
+        return RegionStats( findRegionRle(pixelCoords, color, tolerance) );
     }
 
-    void Analysis::findPerimeter() {
-        const cv::Mat mask = *lastResult;           /// copy
-        findPerimeter(mask);
+    void Analysis::setMaskCacheBudget(const std::size_t bytes) {
+        binarizedCache.setBudget(bytes);
     }
 
-    void Analysis::findSmoothPerimeter(const cv::Mat& regionsMask) {
+    void Analysis::indexRegions(const cv::Vec3b& color, const uchar tolerance) {
         if (currentImage.empty()) {
-            lastResult.invalidate();
+            regionIndex = RegionIndex();
             return ;
         }
-        if (regionsMask.empty()) {
-            lastResult.invalidate();
-            return ;
+        IAS_PROFILE_SCOPE("Analysis::indexRegions", currentImage.total());
+        regionIndex = RegionIndex(currentImage, color, tolerance);
+    }
+
+    /// check if mask can be processed with loaded image
+    static bool validMask(const cv::Mat& image, const cv::Size& maskSize) {
+        if (image.empty()) {
+            return false;
+        }
+        if (maskSize.area() < 1) {
+            return false;
         }
+        return (image.size() == maskSize);
+    }
 
-        const int nRows = currentImage.rows;
-        const int nCols = currentImage.cols;
-        if (nRows != regionsMask.rows || nCols != regionsMask.cols) {
-            lastResult.invalidate();
-            return ;
+    MaskC1 Analysis::perimeter(const cv::Mat& regionsMask, const int connectivity) const {
+        return perimeter( MaskC1(regionsMask), connectivity );
+    }
+
+    MaskC1 Analysis::perimeter(const MaskC1& regionsMask, const int connectivity) const {
+        if (validMask(currentImage, regionsMask.size()) == false) {
+            return MaskC1();
         }
+        IAS_PROFILE_SCOPE("Analysis::perimeter", regionsMask.size().area());
 
-        lastResult = MaskC1(regionsMask);
+        /// binary mask: boundary pixels are found directly on packed bits, other masks by Laplace filter
+        MaskC1 result(regionsMask);
+        result.pack();
+        result.perimeter(connectivity);
+        return result;
+    }
 
-        /// remove small artifacts
-        lastResult.erode();
-        lastResult.dilate();
-        lastResult.dilate();
-        lastResult.erode();
+    void Analysis::findPerimeter(const cv::Mat& regionsMask, const int connectivity) {
+        lastResult = perimeter(regionsMask, connectivity);
+    }
 
-        cv::Mat filter = cv::Mat::zeros( 3, 3, CV_64F );
+    void Analysis::findPerimeter(const int connectivity) {
+        /// previous result is released after new one is calculated
+        lastResult = perimeter(lastResult, connectivity);
+    }
+
+    MaskC1 Analysis::smoothPerimeter(const cv::Mat& regionsMask) const {
+        if (validMask(currentImage, regionsMask.size()) == false) {
+            return MaskC1();
+        }
+        IAS_PROFILE_SCOPE("Analysis::smoothPerimeter", regionsMask.total());
+
+        /// all steps are executed in one pass over rows of mask
+        RowPipeline pipeline;
+
+        /// remove small artifacts
+        pipeline.addStage( RowPipeline::ERODE );
+        pipeline.addStage( RowPipeline::DILATE );
+        pipeline.addStage( RowPipeline::DILATE );
+        pipeline.addStage( RowPipeline::ERODE );
 
         /// Gausian blur
-        filter.at<double>(0,0) = 1;
-        filter.at<double>(0,1) = 2;
-        filter.at<double>(0,2) = 1;
-        filter.at<double>(1,0) = 2;
-        filter.at<double>(1,1) = 4;
-        filter.at<double>(1,2) = 2;
-        filter.at<double>(2,0) = 1;
-        filter.at<double>(2,1) = 2;
-        filter.at<double>(2,2) = 1;
-        filter /= 16;
+        pipeline.addStage( RowPipeline::GAUSSIAN_BLUR, 100 );
 
-        lastResult.applyFilter(filter);
-        lastResult.threshold( 100 );
+        /// Laplace filter
+        pipeline.addStage( RowPipeline::LAPLACE, 64 );
 
-        detectEdges();
-        lastResult.threshold(64);
+        cv::Mat result = BufferPool::global().acquire( regionsMask.rows, regionsMask.cols, CV_8UC1 );
+        pipeline.run(regionsMask, result);
+        return MaskC1(result);
+    }
+
+    MaskC1 Analysis::smoothPerimeter(const MaskC1& regionsMask) const {
+        /// pipeline works on rows of bytes, unpacked matrix is returned to BufferPool
+        MaskC1 source(regionsMask);
+        source.unpack();
+        return smoothPerimeter(*source);
+    }
+
+    void Analysis::findSmoothPerimeter(const cv::Mat& regionsMask) {
+        lastResult = smoothPerimeter(regionsMask);
     }
 
     void Analysis::findSmoothPerimeter() {
-        const cv::Mat mask = *lastResult;       /// copy
-        findSmoothPerimeter(mask);
+        /// previous result is released after new one is calculated
+        lastResult = smoothPerimeter(lastResult);
     }
 
     static void show_mat(const cv::Mat &image, std::string const &win_name) {
@@ -217,32 +286,45 @@ namespace ias {
             return ;
         }
 
-        cv::Mat result;
-        cvtColor(*lastResult, result, CV_GRAY2RGB);
+        const cv::Mat result = *lastResult;
 
         const Size size1 = currentImage.size();
         const Size size2 = result.size();
         cv::Mat joinImage(size1.height, size1.width+size2.width, CV_8UC3);
-        cv::Mat left(joinImage, Rect(0, 0, size1.width, size1.height));
-        currentImage.copyTo(left);
-        cv::Mat right(joinImage, Rect(size1.width, 0, size2.width, size2.height));
-        result.copyTo(right);
+
+        /// image on left side, gray result on right side
+        parallelRows(size1.height, joinImage.cols, [&](const int begin, const int end) {
+            for (int y = begin; y < end; ++y) {
+                const Vec3b* imageRow = currentImage.ptr<Vec3b>(y);
+                Vec3b* out = joinImage.ptr<Vec3b>(y);
+                std::copy( imageRow, imageRow + size1.width, out );
+
+                if (y >= size2.height)
+                    continue;
+                const uchar* resultRow = result.ptr<uchar>(y);
+                out += size1.width;
+                for (int x = 0; x < size2.width; ++x) {
+                    const uchar value = resultRow[x];
+                    out[x] = Vec3b(value, value, value);
+                }
+            }
+        });
 
         show_mat(joinImage, "Result");
     }
 
-    void Analysis::storeResult(const std::string& outputPath) const {
-        storeMat(*lastResult, outputPath);
+    void Analysis::storeResult(const std::string& outputPath, const int compression) const {
+        storeMat(*lastResult, outputPath, compression);
     }
 
     void Analysis::displayMat(const cv::Mat& matrix) {
         show_mat(matrix, "Matrix");
     }
 
-    void Analysis::storeMat(const cv::Mat& matrix, const std::string& outputPath) {
+    void Analysis::storeMat(const cv::Mat& matrix, const std::string& outputPath, const int compression) {
         if (matrix.empty())
             return;
-        imwrite(outputPath, matrix);
+        storeImage(matrix, outputPath, compression);
     }
 
 } /* namespace ias */
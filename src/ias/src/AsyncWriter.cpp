@@ -0,0 +1,75 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "ias/AsyncWriter.h"
+
+#include <exception>
+
+#include "ias/ImageIO.h"
+
+
+namespace ias {
+
+    AsyncWriter::AsyncWriter(const std::size_t capacity): queue(capacity), failures(0), thread() {
+        thread = std::thread( &AsyncWriter::run, this );
+    }
+
+    AsyncWriter::~AsyncWriter() {
+        close();
+    }
+
+    void AsyncWriter::write(const cv::Mat& matrix, const std::string& path, const int compression, const bool copy) {
+        Job job;
+        job.matrix = copy ? matrix.clone() : matrix;
+        job.path = path;
+        job.compression = compression;
+        if (queue.push(job) == false) {
+            /// writer already closed
+            ++failures;
+        }
+    }
+
+    std::size_t AsyncWriter::close() {
+        queue.close();
+        if (thread.joinable()) {
+            thread.join();
+        }
+        return failures;
+    }
+
+    void AsyncWriter::run() {
+        Job job;
+        while (queue.pop(job)) {
+            try {
+                if ( job.matrix.empty() || storeImage(job.matrix, job.path, job.compression) == false ) {
+                    ++failures;
+                }
+            } catch (const std::exception&) {
+                /// e.g. unsupported extension, reported by close()
+                ++failures;
+            }
+            job.matrix = cv::Mat();
+        }
+    }
+
+} /* namespace ias */
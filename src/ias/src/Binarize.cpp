@@ -0,0 +1,213 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "ias/Binarize.h"
+
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+    #define IAS_SIMD_SSE2
+    #include <emmintrin.h>
+
+    /// AVX2 code is compiled with function target attribute and selected at runtime
+    #if defined(__clang__)
+        #if (__clang_major__ > 3) || (__clang_major__ == 3 && __clang_minor__ >= 8)
+            #define IAS_SIMD_AVX2
+        #endif
+    #elif (__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)
+        #define IAS_SIMD_AVX2
+    #endif
+
+    #ifdef IAS_SIMD_AVX2
+        #include <immintrin.h>
+    #endif
+#endif
+
+
+using namespace cv;
+
+
+namespace ias {
+
+    void binarizeRowScalar(const cv::Vec3b* row, uchar* out, const int width, const cv::Vec3b& color, const uchar tolerance) {
+        for (int x = 0; x < width; ++x) {
+            if (isColorSame(color, row[x], tolerance)) {
+                out[x] = 255;
+            } else {
+                out[x] = 0;
+            }
+        }
+    }
+
+#ifdef IAS_SIMD_SSE2
+
+    static inline __m128i absDiff(const __m128i a, const __m128i b) {
+        return _mm_or_si128( _mm_subs_epu8(a, b), _mm_subs_epu8(b, a) );
+    }
+
+    /// split 16 interleaved BGR pixels into planes (using only SSE2 unpack instructions)
+    static inline void deinterleave(__m128i& b, __m128i& g, __m128i& r) {
+        __m128i t0 = _mm_unpacklo_epi8( b, _mm_unpackhi_epi64(g, g) );
+        __m128i t1 = _mm_unpacklo_epi8( _mm_unpackhi_epi64(b, b), r );
+        __m128i t2 = _mm_unpacklo_epi8( g, _mm_unpackhi_epi64(r, r) );
+
+        for (int i = 0; i < 3; ++i) {
+            const __m128i u0 = _mm_unpacklo_epi8( t0, _mm_unpackhi_epi64(t1, t1) );
+            const __m128i u1 = _mm_unpacklo_epi8( _mm_unpackhi_epi64(t0, t0), t2 );
+            const __m128i u2 = _mm_unpacklo_epi8( t1, _mm_unpackhi_epi64(t2, t2) );
+            t0 = u0;
+            t1 = u1;
+            t2 = u2;
+        }
+
+        b = t0;
+        g = t1;
+        r = t2;
+    }
+
+    static void binarizeRowSSE2(const cv::Vec3b* row, uchar* out, const int width, const cv::Vec3b& color, const uchar tolerance) {
+        const __m128i vb = _mm_set1_epi8( (char)color(0) );
+        const __m128i vg = _mm_set1_epi8( (char)color(1) );
+        const __m128i vr = _mm_set1_epi8( (char)color(2) );
+        const __m128i vtol = _mm_set1_epi8( (char)tolerance );
+        const __m128i zero = _mm_setzero_si128();
+
+        const uchar* in = row->val;
+        int x = 0;
+        for (; x + 16 <= width; x += 16) {
+            const uchar* data = in + 3 * x;
+            __m128i b = _mm_loadu_si128( (const __m128i*)(data) );
+            __m128i g = _mm_loadu_si128( (const __m128i*)(data + 16) );
+            __m128i r = _mm_loadu_si128( (const __m128i*)(data + 32) );
+            deinterleave(b, g, r);
+
+            /// pixel is accepted if greatest component difference does not exceed tolerance
+            const __m128i diff = _mm_max_epu8( _mm_max_epu8( absDiff(b, vb), absDiff(g, vg) ), absDiff(r, vr) );
+            const __m128i result = _mm_cmpeq_epi8( _mm_subs_epu8(diff, vtol), zero );
+            _mm_storeu_si128( (__m128i*)(out + x), result );
+        }
+
+        binarizeRowScalar(row + x, out + x, width - x, color, tolerance);
+    }
+
+#endif
+
+#ifdef IAS_SIMD_AVX2
+
+    __attribute__((target("avx2")))
+    static inline __m256i absDiff(const __m256i a, const __m256i b) {
+        return _mm256_or_si256( _mm256_subs_epu8(a, b), _mm256_subs_epu8(b, a) );
+    }
+
+    /// each 128-bit lane holds 16 pixels, so the SSE2 unpack sequence works lane-wise
+    __attribute__((target("avx2")))
+    static inline void deinterleave(__m256i& b, __m256i& g, __m256i& r) {
+        __m256i t0 = _mm256_unpacklo_epi8( b, _mm256_unpackhi_epi64(g, g) );
+        __m256i t1 = _mm256_unpacklo_epi8( _mm256_unpackhi_epi64(b, b), r );
+        __m256i t2 = _mm256_unpacklo_epi8( g, _mm256_unpackhi_epi64(r, r) );
+
+        for (int i = 0; i < 3; ++i) {
+            const __m256i u0 = _mm256_unpacklo_epi8( t0, _mm256_unpackhi_epi64(t1, t1) );
+            const __m256i u1 = _mm256_unpacklo_epi8( _mm256_unpackhi_epi64(t0, t0), t2 );
+            const __m256i u2 = _mm256_unpacklo_epi8( t1, _mm256_unpackhi_epi64(t2, t2) );
+            t0 = u0;
+            t1 = u1;
+            t2 = u2;
+        }
+
+        b = t0;
+        g = t1;
+        r = t2;
+    }
+
+    __attribute__((target("avx2")))
+    static inline __m256i loadLanes(const uchar* low, const uchar* high) {
+        const __m256i lowLane = _mm256_castsi128_si256( _mm_loadu_si128( (const __m128i*)low ) );
+        return _mm256_inserti128_si256( lowLane, _mm_loadu_si128( (const __m128i*)high ), 1 );
+    }
+
+    __attribute__((target("avx2")))
+    static void binarizeRowAVX2(const cv::Vec3b* row, uchar* out, const int width, const cv::Vec3b& color, const uchar tolerance) {
+        const __m256i vb = _mm256_set1_epi8( (char)color(0) );
+        const __m256i vg = _mm256_set1_epi8( (char)color(1) );
+        const __m256i vr = _mm256_set1_epi8( (char)color(2) );
+        const __m256i vtol = _mm256_set1_epi8( (char)tolerance );
+        const __m256i zero = _mm256_setzero_si256();
+
+        const uchar* in = row->val;
+        int x = 0;
+        for (; x + 32 <= width; x += 32) {
+            /// lower lane: pixels [x, x+16), upper lane: pixels [x+16, x+32)
+            const uchar* data = in + 3 * x;
+            __m256i b = loadLanes( data,      data + 48 );
+            __m256i g = loadLanes( data + 16, data + 64 );
+            __m256i r = loadLanes( data + 32, data + 80 );
+            deinterleave(b, g, r);
+
+            const __m256i diff = _mm256_max_epu8( _mm256_max_epu8( absDiff(b, vb), absDiff(g, vg) ), absDiff(r, vr) );
+            const __m256i result = _mm256_cmpeq_epi8( _mm256_subs_epu8(diff, vtol), zero );
+            _mm256_storeu_si256( (__m256i*)(out + x), result );
+        }
+
+        binarizeRowSSE2(row + x, out + x, width - x, color, tolerance);
+    }
+
+#endif
+
+    typedef void (*BinarizeKernel)(const cv::Vec3b*, uchar*, const int, const cv::Vec3b&, const uchar);
+
+    struct KernelInfo {
+        BinarizeKernel kernel;
+        const char* name;
+    };
+
+    static KernelInfo selectKernel() {
+#ifdef IAS_SIMD_AVX2
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            const KernelInfo info = { binarizeRowAVX2, "avx2" };
+            return info;
+        }
+#endif
+#ifdef IAS_SIMD_SSE2
+        const KernelInfo info = { binarizeRowSSE2, "sse2" };
+        return info;
+#else
+        const KernelInfo info = { binarizeRowScalar, "scalar" };
+        return info;
+#endif
+    }
+
+    static const KernelInfo& kernelInfo() {
+        static const KernelInfo info = selectKernel();
+        return info;
+    }
+
+    void binarizeRow(const cv::Vec3b* row, uchar* out, const int width, const cv::Vec3b& color, const uchar tolerance) {
+        kernelInfo().kernel(row, out, width, color, tolerance);
+    }
+
+    const char* binarizeInstructionSet() {
+        return kernelInfo().name;
+    }
+
+} /* namespace ias */
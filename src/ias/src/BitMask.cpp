@@ -0,0 +1,357 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "ias/BitMask.h"
+
+#include "ias/Morphology.h"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+
+using namespace cv;
+
+
+namespace ias {
+
+    struct OrOp {
+        static inline uint64_t apply(const uint64_t a, const uint64_t b) {
+            return a | b;
+        }
+    };
+
+    struct AndOp {
+        static inline uint64_t apply(const uint64_t a, const uint64_t b) {
+            return a & b;
+        }
+    };
+
+    /// pack row of bytes into bits, "binary" is cleared if row contains value other than 0 or 255
+    static void packRow(const uchar* in, uint64_t* out, const int nCols, bool& binary) {
+        int x = 0;
+#if defined(__SSE2__)
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i full = _mm_set1_epi8( (char)255 );
+        for (; x + 64 <= nCols; x += 64) {
+            uint64_t word = 0;
+            for (int i = 0; i < 4; ++i) {
+                const __m128i data = _mm_loadu_si128( (const __m128i*)(in + x + 16 * i) );
+                const __m128i isZero = _mm_cmpeq_epi8(data, zero);
+                const __m128i isFull = _mm_cmpeq_epi8(data, full);
+                const uint64_t setBits = (~_mm_movemask_epi8(isZero)) & 0xFFFF;
+                word |= setBits << (16 * i);
+                if ( _mm_movemask_epi8( _mm_or_si128(isZero, isFull) ) != 0xFFFF )
+                    binary = false;
+            }
+            out[x / 64] = word;
+        }
+#endif
+        for (; x < nCols; x += 64) {
+            const int end = std::min(x + 64, nCols);
+            uint64_t word = 0;
+            for (int i = x; i < end; ++i) {
+                const uchar value = in[i];
+                if (value != 0) {
+                    word |= (uint64_t)1 << (i - x);
+                    if (value != 255)
+                        binary = false;
+                }
+            }
+            out[x / 64] = word;
+        }
+    }
+
+    /// result bit "x" is input bit "x + shift", bits after end of row are zeros
+    static void shiftDown(const uint64_t* in, uint64_t* out, const int nWords, const int shift) {
+        const int q = shift / 64;
+        const int r = shift % 64;
+        for (int i = 0; i < nWords; ++i) {
+            const uint64_t low = (i + q < nWords) ? in[i + q] : 0;
+            if (r == 0) {
+                out[i] = low;
+                continue;
+            }
+            const uint64_t high = (i + q + 1 < nWords) ? in[i + q + 1] : 0;
+            out[i] = (low >> r) | (high << (64 - r));
+        }
+    }
+
+    /// result bit "x" is input bit "x - shift", bits before start of row are zeros
+    static void shiftUp(const uint64_t* in, uint64_t* out, const int nWords, const int shift) {
+        const int q = shift / 64;
+        const int r = shift % 64;
+        for (int i = 0; i < nWords; ++i) {
+            const uint64_t high = (i - q >= 0) ? in[i - q] : 0;
+            if (r == 0) {
+                out[i] = high;
+                continue;
+            }
+            const uint64_t low = (i - q - 1 >= 0) ? in[i - q - 1] : 0;
+            out[i] = (high << r) | (low >> (64 - r));
+        }
+    }
+
+    /**
+     * Combine bits over window of "length" pixels by doubling window size in each step,
+     * so cost is logarithmic in length. "Shift" defines direction of window.
+     */
+    template<typename Op>
+    static void windowBits(uint64_t* data, uint64_t* scratch, const int nWords, const int length,
+                           void (*shift)(const uint64_t*, uint64_t*, const int, const int))
+    {
+        int covered = 1;
+        while (covered < length) {
+            const int step = std::min(covered, length - covered);
+            shift(data, scratch, nWords, step);
+            for (int i = 0; i < nWords; ++i) {
+                data[i] = Op::apply(data[i], scratch[i]);
+            }
+            covered += step;
+        }
+    }
+
+    /// the same as "windowBits" working on rows, "direction" is +1 for rows below and -1 for rows above
+    template<typename Op>
+    static void windowRows(std::vector<uint64_t>& data, const int nRows, const int nWords, const int length, const int direction) {
+        const uint64_t zero = Op::apply(0, 0);
+        int covered = 1;
+        while (covered < length) {
+            const int step = std::min(covered, length - covered);
+            for (int i = 0; i < nRows; ++i) {
+                const int y = (direction > 0) ? i : (nRows - 1 - i);
+                const int other = y + direction * step;
+                uint64_t* out = &data[ (std::size_t)y * nWords ];
+                if (other < 0 || other >= nRows) {
+                    for (int w = 0; w < nWords; ++w) {
+                        out[w] = Op::apply(out[w], zero);
+                    }
+                    continue;
+                }
+                const uint64_t* in = &data[ (std::size_t)other * nWords ];
+                for (int w = 0; w < nWords; ++w) {
+                    out[w] = Op::apply(out[w], in[w]);
+                }
+            }
+            covered += step;
+        }
+    }
+
+
+    BitMask::BitMask(const int width, const int height, const uchar value): nRows(height), nCols(width), nWords( (width + 63) / 64 ), bits() {
+        bits.assign( (std::size_t)nRows * nWords, 0 );
+        if (value != 0) {
+            fill(true);
+        }
+    }
+
+    BitMask::BitMask(const cv::Mat& matrix): nRows(0), nCols(0), nWords(0), bits() {
+        load(matrix);
+    }
+
+    bool BitMask::load(const cv::Mat& matrix) {
+        CV_Assert( matrix.empty() || matrix.type() == CV_8UC1 );
+
+        nRows = matrix.rows;
+        nCols = matrix.cols;
+        nWords = (nCols + 63) / 64;
+        bits.assign( (std::size_t)nRows * nWords, 0 );
+
+        bool binary = true;
+        for (int y = 0; y < nRows; ++y) {
+            packRow( matrix.ptr<uchar>(y), row(y), nCols, binary );
+        }
+        return binary;
+    }
+
+    cv::Mat BitMask::toMat() const {
+        if (empty()) {
+            return cv::Mat();
+        }
+        cv::Mat matrix( nRows, nCols, CV_8UC1 );
+        toMat(matrix);
+        return matrix;
+    }
+
+    void BitMask::toMat(cv::Mat& matrix) const {
+        CV_Assert( matrix.type() == CV_8UC1 && matrix.rows == nRows && matrix.cols == nCols );
+
+        for (int y = 0; y < nRows; ++y) {
+            const uint64_t* in = row(y);
+            uchar* out = matrix.ptr<uchar>(y);
+            for (int x = 0; x < nCols; ++x) {
+                /// set bit gives 255 without branch
+                out[x] = (uchar)( 0 - ( (in[x / 64] >> (x % 64)) & 1 ) );
+            }
+        }
+    }
+
+    void BitMask::setRun(const int y, const int left, const int right) {
+        uint64_t* data = row(y);
+        const int first = left / 64;
+        const int last = right / 64;
+        const uint64_t head = ~(uint64_t)0 << (left % 64);
+        const uint64_t tail = ~(uint64_t)0 >> (63 - right % 64);
+        if (first == last) {
+            data[first] |= head & tail;
+            return ;
+        }
+        data[first] |= head;
+        std::fill( data + first + 1, data + last, ~(uint64_t)0 );
+        data[last] |= tail;
+    }
+
+    std::size_t BitMask::count() const {
+        std::size_t sum = 0;
+        for (std::size_t i = 0; i < bits.size(); ++i) {
+            sum += __builtin_popcountll( bits[i] );
+        }
+        return sum;
+    }
+
+    uint64_t BitMask::lastWordMask() const {
+        const int used = nCols % 64;
+        if (used == 0)
+            return ~(uint64_t)0;
+        return ((uint64_t)1 << used) - 1;
+    }
+
+    void BitMask::fill(const bool value) {
+        if (value == false) {
+            std::fill(bits.begin(), bits.end(), 0);
+            return ;
+        }
+        std::fill(bits.begin(), bits.end(), ~(uint64_t)0);
+        const uint64_t last = lastWordMask();
+        for (int y = 0; y < nRows; ++y) {
+            row(y)[nWords - 1] &= last;
+        }
+    }
+
+    void BitMask::changeColor(const uchar from, const uchar to) {
+        /// pixels have only 0 or 255 values
+        if (from != 0 && from != 255)
+            return ;
+        const bool fromBit = (from != 0);
+        const bool toBit = (to != 0);
+        if (fromBit == toBit)
+            return ;
+        fill( toBit );
+    }
+
+    void BitMask::threshold(const uchar thresh) {
+        if (thresh == 0) {
+            /// zeros are not below threshold
+            fill(true);
+        }
+    }
+
+    void BitMask::dilate(const int size, const std::size_t repeats) {
+        dilate( cv::Size(size, size), repeats );
+    }
+
+    void BitMask::dilate(const cv::Size& element, const std::size_t repeats) {
+        morphology<OrOp>(element, repeats);
+    }
+
+    void BitMask::erode(const int size, const std::size_t repeats) {
+        erode( cv::Size(size, size), repeats );
+    }
+
+    void BitMask::erode(const cv::Size& element, const std::size_t repeats) {
+        morphology<AndOp>(element, repeats);
+    }
+
+    /// bit "x" of result is bit "x - 1" of row
+    static inline uint64_t leftNeighbour(const uint64_t* data, const int i) {
+        const uint64_t carry = (i > 0) ? (data[i - 1] >> 63) : 0;
+        return (data[i] << 1) | carry;
+    }
+
+    /// bit "x" of result is bit "x + 1" of row
+    static inline uint64_t rightNeighbour(const uint64_t* data, const int i, const int nWords) {
+        const uint64_t carry = (i + 1 < nWords) ? (data[i + 1] << 63) : 0;
+        return (data[i] >> 1) | carry;
+    }
+
+    void BitMask::perimeter(const int connectivity) {
+        if (empty()) {
+            return ;
+        }
+
+        const std::vector<uint64_t> zeros(nWords, 0);
+        std::vector<uint64_t> result( bits.size() );
+
+        for (int y = 0; y < nRows; ++y) {
+            const uint64_t* above = (y > 0) ? row(y - 1) : zeros.data();
+            const uint64_t* current = row(y);
+            const uint64_t* below = (y < nRows - 1) ? row(y + 1) : zeros.data();
+            uint64_t* out = &result[ (std::size_t)y * nWords ];
+
+            for (int i = 0; i < nWords; ++i) {
+                /// pixels with all neighbours set
+                uint64_t inner = current[i] & above[i] & below[i] &
+                                 leftNeighbour(current, i) & rightNeighbour(current, i, nWords);
+                if (connectivity != 4) {
+                    inner &= leftNeighbour(above, i) & rightNeighbour(above, i, nWords) &
+                             leftNeighbour(below, i) & rightNeighbour(below, i, nWords);
+                }
+                out[i] = current[i] & ~inner;
+            }
+        }
+
+        bits.swap(result);
+    }
+
+    template<typename Op>
+    void BitMask::morphology(const cv::Size& size, const std::size_t repeats) {
+        if (empty() || size.width < 1 || size.height < 1 || repeats < 1) {
+            return ;
+        }
+        const StructuringElement element = StructuringElement(size).repeated(repeats);
+
+        /// horizontal: combine window [x, x + right] with window [x - left, x]
+        std::vector<uint64_t> forward(nWords);
+        std::vector<uint64_t> scratch(nWords);
+        const uint64_t last = lastWordMask();
+        for (int y = 0; y < nRows; ++y) {
+            uint64_t* data = row(y);
+            std::copy(data, data + nWords, forward.begin());
+            windowBits<Op>(forward.data(), scratch.data(), nWords, element.right + 1, shiftDown);
+            windowBits<Op>(data, scratch.data(), nWords, element.left + 1, shiftUp);
+            for (int i = 0; i < nWords; ++i) {
+                data[i] = Op::apply(data[i], forward[i]);
+            }
+            data[nWords - 1] &= last;
+        }
+
+        /// vertical: the same with rows
+        std::vector<uint64_t> below(bits);
+        windowRows<Op>(below, nRows, nWords, element.bottom + 1, +1);
+        windowRows<Op>(bits, nRows, nWords, element.top + 1, -1);
+        for (std::size_t i = 0; i < bits.size(); ++i) {
+            bits[i] = Op::apply(bits[i], below[i]);
+        }
+    }
+
+} /* namespace ias */
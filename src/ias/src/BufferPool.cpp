@@ -0,0 +1,157 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include "ias/BufferPool.h"
+
+#include "ias/Profiler.h"
+
+
+namespace ias {
+
+    static std::size_t matrixBytes(const cv::Mat& matrix) {
+        return matrix.total() * matrix.elemSize();
+    }
+
+
+    BufferPool::BufferPool(const std::size_t budget): mutex(), buffers(), budgetBytes(budget), usedBytes(0),
+                                                      acquireCount(0), allocationCount(0), releaseCount(0)
+    {
+    }
+
+    BufferPool& BufferPool::global() {
+        static BufferPool pool;
+        return pool;
+    }
+
+    bool BufferPool::exclusive(const cv::Mat& matrix) {
+        if (matrix.empty())
+            return false;
+        if (matrix.isContinuous() == false)
+            return false;
+        if (matrix.data != matrix.datastart)
+            return false;
+        /// user data (e.g. mapped file) has no reference counter
+#if CV_MAJOR_VERSION < 3
+        return (matrix.refcount != NULL) && (*matrix.refcount == 1);
+#else
+        return (matrix.u != NULL) && (matrix.u->refcount == 1);
+#endif
+    }
+
+    std::size_t BufferPool::budget() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return budgetBytes;
+    }
+
+    void BufferPool::setBudget(const std::size_t budget) {
+        std::lock_guard<std::mutex> lock(mutex);
+        budgetBytes = budget;
+        evict(budgetBytes);
+    }
+
+    cv::Mat BufferPool::acquire(const int rows, const int cols, const int type) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++acquireCount;
+            for (std::list<cv::Mat>::iterator item = buffers.begin(); item != buffers.end(); ++item) {
+                if (item->rows != rows || item->cols != cols || item->type() != type)
+                    continue;
+                cv::Mat matrix = *item;
+                buffers.erase(item);
+                usedBytes -= matrixBytes(matrix);
+                return matrix;
+            }
+            ++allocationCount;
+        }
+        /// allocate outside of lock, reused buffers are not reported to profiler
+        cv::Mat matrix( rows, cols, type );
+        IAS_PROFILE_ALLOCATION( matrixBytes(matrix) );
+        return matrix;
+    }
+
+    bool BufferPool::release(cv::Mat& matrix) {
+        if (exclusive(matrix) == false) {
+            matrix = cv::Mat();
+            return false;
+        }
+
+        const std::size_t matrixSize = matrixBytes(matrix);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (matrixSize > budgetBytes) {
+            matrix = cv::Mat();
+            return false;
+        }
+        evict(budgetBytes - matrixSize);
+        buffers.push_front( matrix );
+        usedBytes += matrixSize;
+        ++releaseCount;
+        matrix = cv::Mat();
+        return true;
+    }
+
+    std::size_t BufferPool::size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return buffers.size();
+    }
+
+    std::size_t BufferPool::bytes() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return usedBytes;
+    }
+
+    std::size_t BufferPool::acquires() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return acquireCount;
+    }
+
+    std::size_t BufferPool::allocations() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return allocationCount;
+    }
+
+    std::size_t BufferPool::releases() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return releaseCount;
+    }
+
+    void BufferPool::clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        evict(0);
+    }
+
+    void BufferPool::resetStats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        acquireCount = 0;
+        allocationCount = 0;
+        releaseCount = 0;
+    }
+
+    void BufferPool::evict(const std::size_t budget) {
+        while (usedBytes > budget && buffers.empty() == false) {
+            usedBytes -= matrixBytes( buffers.back() );
+            buffers.pop_back();
+        }
+    }
+
+} /* namespace ias */
@@ -0,0 +1,366 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "ias/Convolution.h"
+
+#include <cmath>
+#include <cstdlib>
+
+#include "ias/ThreadPool.h"
+
+
+using namespace cv;
+
+
+namespace ias {
+
+    /// greatest allowed scale of fixed-point coefficients (2^shift)
+    static const int MAX_SHIFT = 12;
+
+    /// limit of sum of absolute coefficients, so 255 * sum fits into int
+    static const double MAX_ABS_SUM = 8388608.0;
+
+
+    static inline uchar saturate(const int sum, const int shift) {
+        if (sum < 0)
+            return 0;
+        const int value = sum >> shift;
+        if (value > 255)
+            return 255;
+        return value;
+    }
+
+    static inline uchar saturate(const double sum, const int /*shift*/) {
+        if (sum < 0)
+            return 0;
+        else if (sum > 255)
+            return 255;
+        else
+            return sum;
+    }
+
+    static int gcd(int a, int b) {
+        a = std::abs(a);
+        b = std::abs(b);
+        while (b != 0) {
+            const int r = a % b;
+            a = b;
+            b = r;
+        }
+        return a;
+    }
+
+    /// sum of taps with bounds checking, used for border pixels
+    template<typename Taps, typename Sum>
+    static inline Sum sumBounded(const cv::Mat& source, const Taps& taps, const int y, const int x, const Sum zero) {
+        const int nRows = source.rows;
+        const int nCols = source.cols;
+        Sum sum = zero;
+        const std::size_t nTaps = taps.size();
+        for (std::size_t i = 0; i < nTaps; ++i) {
+            const int my = y + taps[i].dy;
+            if (my < 0 || my >= nRows)
+                continue;
+            const int mx = x + taps[i].dx;
+            if (mx < 0 || mx >= nCols)
+                continue;
+            sum += source.ptr<uchar>(my)[mx] * taps[i].coeff;
+        }
+        return sum;
+    }
+
+    /// horizontal 1-D convolution with bounds checking, used for border pixels
+    static inline int sumRowBounded(const uchar* row, const int nCols, const int x, const std::vector<int>& kernel, const int anchor) {
+        const int fSize = kernel.size();
+        const int fBegin = std::max(0, anchor - x);
+        const int fEnd = std::min(fSize, nCols - x + anchor);
+        int sum = 0;
+        for (int f = fBegin; f < fEnd; ++f) {
+            sum += row[x + f - anchor] * kernel[f];
+        }
+        return sum;
+    }
+
+    /**
+     * Generic 2-D convolution with list of taps (in row-major order).
+     * Only "rows" of target are calculated.
+     * "interiorY" and "interiorX" are ranges of pixels having all taps inside of matrix.
+     */
+    template<typename Taps, typename Sum>
+    static void convolveTaps(const cv::Mat& source, cv::Mat& target, const Taps& taps, const int shift, const cv::Range& rows,
+                             const cv::Range& interiorY, const cv::Range& interiorX, const Sum zero)
+    {
+        const int nCols = source.cols;
+        const std::size_t step = source.step[0];
+
+        const std::size_t nTaps = taps.size();
+        std::vector<std::ptrdiff_t> offsets(nTaps);
+        std::vector<Sum> coeffs(nTaps);
+        for (std::size_t i = 0; i < nTaps; ++i) {
+            offsets[i] = (std::ptrdiff_t)taps[i].dy * (std::ptrdiff_t)step + taps[i].dx;
+            coeffs[i] = taps[i].coeff;
+        }
+        const std::ptrdiff_t* offset = offsets.data();
+        const Sum* coeff = coeffs.data();
+
+        for (int y = rows.start; y < rows.end; ++y) {
+            uchar* out = target.ptr<uchar>(y);
+
+            if (y < interiorY.start || y >= interiorY.end) {
+                for (int x = 0; x < nCols; ++x) {
+                    out[x] = saturate( sumBounded(source, taps, y, x, zero), shift );
+                }
+                continue;
+            }
+
+            for (int x = 0; x < interiorX.start; ++x) {
+                out[x] = saturate( sumBounded(source, taps, y, x, zero), shift );
+            }
+
+            const uchar* row = source.ptr<uchar>(y);
+            for (int x = interiorX.start; x < interiorX.end; ++x) {
+                const uchar* pixel = row + x;
+                Sum sum = zero;
+                for (std::size_t i = 0; i < nTaps; ++i) {
+                    sum += pixel[ offset[i] ] * coeff[i];
+                }
+                out[x] = saturate( sum, shift );
+            }
+
+            for (int x = std::max(interiorX.start, interiorX.end); x < nCols; ++x) {
+                out[x] = saturate( sumBounded(source, taps, y, x, zero), shift );
+            }
+        }
+    }
+
+    /// range of positions having whole filter inside of "size" elements
+    static cv::Range interiorRange(const int size, const int fSize, const int anchor) {
+        const int start = std::min(anchor, size);
+        const int end = std::max(start, size - fSize + anchor + 1);
+        return cv::Range(start, end);
+    }
+
+
+    Convolution::Convolution(const cv::Mat& filter): fRows(0), fCols(0), anchorY(0), anchorX(0),
+                                                     integer(false), shift(0), intTaps(), realTaps(),
+                                                     separable(false), rowKernel(), colKernel()
+    {
+        if (filter.empty()) {
+            return ;
+        }
+
+        cv::Mat kernel;
+        filter.convertTo(kernel, CV_64F);
+
+        fRows = kernel.rows;
+        fCols = kernel.cols;
+        anchorY = fRows / 2;
+        anchorX = fCols / 2;
+
+        for (int fy = 0; fy < fRows; ++fy) {
+            for (int fx = 0; fx < fCols; ++fx) {
+                const double value = kernel.at<double>(fy, fx);
+                if (value == 0.0)
+                    continue;
+                const Tap<double> tap = { fy - anchorY, fx - anchorX, value };
+                realTaps.push_back( tap );
+            }
+        }
+
+        detectInteger();
+        if (integer) {
+            detectSeparable();
+        }
+    }
+
+    void Convolution::detectInteger() {
+        for (int s = 0; s <= MAX_SHIFT; ++s) {
+            const double scale = (double)(1 << s);
+            double absSum = 0.0;
+            bool valid = true;
+            for (std::size_t i = 0; i < realTaps.size(); ++i) {
+                const double value = realTaps[i].coeff * scale;
+                if (value != std::floor(value)) {
+                    valid = false;
+                    break;
+                }
+                absSum += std::fabs(value);
+            }
+            if (valid == false)
+                continue;
+            if (absSum >= MAX_ABS_SUM)
+                return ;
+
+            integer = true;
+            shift = s;
+            for (std::size_t i = 0; i < realTaps.size(); ++i) {
+                const Tap<int> tap = { realTaps[i].dy, realTaps[i].dx, (int)(realTaps[i].coeff * scale) };
+                intTaps.push_back( tap );
+            }
+            return ;
+        }
+    }
+
+    void Convolution::detectSeparable() {
+        if (fRows < 2 || fCols < 2 || intTaps.empty()) {
+            return ;
+        }
+
+        std::vector<int> dense(fRows * fCols, 0);
+        for (std::size_t i = 0; i < intTaps.size(); ++i) {
+            dense[ (intTaps[i].dy + anchorY) * fCols + intTaps[i].dx + anchorX ] = intTaps[i].coeff;
+        }
+
+        /// first non-zero coefficient
+        const int pivot = (intTaps[0].dy + anchorY) * fCols + intTaps[0].dx + anchorX;
+        const int pivotRow = pivot / fCols;
+        const int pivotCol = pivot % fCols;
+
+        /// row of pivot divided by its gcd is the horizontal kernel
+        int divisor = 0;
+        for (int fx = 0; fx < fCols; ++fx) {
+            divisor = gcd(divisor, dense[pivotRow * fCols + fx]);
+        }
+        std::vector<int> row(fCols);
+        for (int fx = 0; fx < fCols; ++fx) {
+            row[fx] = dense[pivotRow * fCols + fx] / divisor;
+        }
+
+        /// every row has to be integer multiple of horizontal kernel
+        std::vector<int> col(fRows);
+        for (int fy = 0; fy < fRows; ++fy) {
+            const int value = dense[fy * fCols + pivotCol];
+            if (value % row[pivotCol] != 0)
+                return ;
+            col[fy] = value / row[pivotCol];
+            for (int fx = 0; fx < fCols; ++fx) {
+                if (dense[fy * fCols + fx] != col[fy] * row[fx])
+                    return ;
+            }
+        }
+
+        double rowSum = 0.0;
+        for (int fx = 0; fx < fCols; ++fx) {
+            rowSum += std::abs(row[fx]);
+        }
+        double colSum = 0.0;
+        for (int fy = 0; fy < fRows; ++fy) {
+            colSum += std::abs(col[fy]);
+        }
+        if (rowSum * colSum >= MAX_ABS_SUM) {
+            return ;
+        }
+
+        separable = true;
+        rowKernel = row;
+        colKernel = col;
+    }
+
+    void Convolution::apply(const cv::Mat& source, cv::Mat& target) const {
+        CV_Assert( source.type() == CV_8UC1 );
+        CV_Assert( source.data != target.data );
+
+        target.create( source.rows, source.cols, CV_8UC1 );
+
+        /// bands of rows read source rows of neighbour bands (halo), but write only own rows
+        parallelRows(source.rows, source.cols, [&](const int begin, const int end) {
+            const cv::Range rows(begin, end);
+            if (separable) {
+                applySeparable(source, target, rows);
+            } else if (integer) {
+                applyTaps(source, target, rows);
+            } else {
+                applyReal(source, target, rows);
+            }
+        });
+    }
+
+    void Convolution::applyTaps(const cv::Mat& source, cv::Mat& target, const cv::Range& rows) const {
+        const cv::Range interiorY = interiorRange(source.rows, fRows, anchorY);
+        const cv::Range interiorX = interiorRange(source.cols, fCols, anchorX);
+        convolveTaps(source, target, intTaps, shift, rows, interiorY, interiorX, 0);
+    }
+
+    void Convolution::applyReal(const cv::Mat& source, cv::Mat& target, const cv::Range& rows) const {
+        const cv::Range interiorY = interiorRange(source.rows, fRows, anchorY);
+        const cv::Range interiorX = interiorRange(source.cols, fCols, anchorX);
+        convolveTaps(source, target, realTaps, 0, rows, interiorY, interiorX, 0.0);
+    }
+
+    void Convolution::applySeparable(const cv::Mat& source, cv::Mat& target, const cv::Range& rows) const {
+        const int nRows = source.rows;
+        const int nCols = source.cols;
+        const cv::Range interiorX = interiorRange(nCols, fCols, anchorX);
+
+        /// rows of horizontal pass, row "r" is kept in slot "r % fRows"
+        std::vector<int> ring( fRows * nCols );
+        std::vector<int> sum( nCols );
+        const int* row = rowKernel.data();
+        int nextRow = std::max(0, rows.start - anchorY);
+
+        for (int y = rows.start; y < rows.end; ++y) {
+            const int firstRow = std::max(0, y - anchorY);
+            const int lastRow = std::min(nRows, y - anchorY + fRows);
+
+            /// horizontal pass of missing rows
+            for (; nextRow < lastRow; ++nextRow) {
+                const uchar* in = source.ptr<uchar>(nextRow);
+                int* out = &ring[ (nextRow % fRows) * nCols ];
+
+                for (int x = 0; x < interiorX.start; ++x) {
+                    out[x] = sumRowBounded(in, nCols, x, rowKernel, anchorX);
+                }
+                for (int x = interiorX.start; x < interiorX.end; ++x) {
+                    const uchar* pixel = in + x - anchorX;
+                    int value = 0;
+                    for (int fx = 0; fx < fCols; ++fx) {
+                        value += pixel[fx] * row[fx];
+                    }
+                    out[x] = value;
+                }
+                for (int x = std::max(interiorX.start, interiorX.end); x < nCols; ++x) {
+                    out[x] = sumRowBounded(in, nCols, x, rowKernel, anchorX);
+                }
+            }
+
+            /// vertical pass
+            std::fill(sum.begin(), sum.end(), 0);
+            int* acc = sum.data();
+            for (int r = firstRow; r < lastRow; ++r) {
+                const int coeff = colKernel[ r - y + anchorY ];
+                if (coeff == 0)
+                    continue;
+                const int* in = &ring[ (r % fRows) * nCols ];
+                for (int x = 0; x < nCols; ++x) {
+                    acc[x] += coeff * in[x];
+                }
+            }
+
+            uchar* out = target.ptr<uchar>(y);
+            for (int x = 0; x < nCols; ++x) {
+                out[x] = saturate( acc[x], shift );
+            }
+        }
+    }
+
+} /* namespace ias */
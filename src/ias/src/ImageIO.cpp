@@ -0,0 +1,384 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "ias/ImageIO.h"
+
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <opencv2/highgui/highgui.hpp>
+
+#include "ias/MaskCodec.h"
+#include "ias/Profiler.h"
+#include "ias/ThreadPool.h"
+
+
+namespace ias {
+
+    static const char RAW_MAGIC[4] = { 'I', 'A', 'S', 'R' };
+    static const std::size_t RAW_HEADER_SIZE = 16;
+
+
+    static uint32_t readLE32(const uchar* data) {
+        return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+    }
+
+    static void writeLE32(uchar* data, const uint32_t value) {
+        data[0] = value & 0xFF;
+        data[1] = (value >> 8) & 0xFF;
+        data[2] = (value >> 16) & 0xFF;
+        data[3] = (value >> 24) & 0xFF;
+    }
+
+    static bool isSpace(const uchar c) {
+        return (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f');
+    }
+
+    /// read header number of PNM file, skipping whitespaces and comments
+    static bool readPnmNumber(const uchar* data, const std::size_t size, std::size_t& pos, int& value) {
+        while (pos < size) {
+            if (data[pos] == '#') {
+                while (pos < size && data[pos] != '\n')
+                    ++pos;
+            } else if (isSpace(data[pos])) {
+                ++pos;
+            } else {
+                break;
+            }
+        }
+        if (pos >= size || data[pos] < '0' || data[pos] > '9') {
+            return false;
+        }
+        long number = 0;
+        while (pos < size && data[pos] >= '0' && data[pos] <= '9') {
+            number = number * 10 + (data[pos] - '0');
+            if (number > 1000000000)
+                return false;
+            ++pos;
+        }
+        value = number;
+        return true;
+    }
+
+
+    bool ImageLayout::parse(const uchar* data, const std::size_t size) {
+        format = UNKNOWN;
+        maxValue = 255;
+        if (size >= RAW_HEADER_SIZE && std::memcmp(data, RAW_MAGIC, 4) == 0) {
+            width = readLE32(data + 4);
+            height = readLE32(data + 8);
+            channels = readLE32(data + 12);
+            offset = RAW_HEADER_SIZE;
+            if (channels != 1 && channels != 3)
+                return false;
+            format = RAW;
+        } else if (size >= 2 && data[0] == 'P' && (data[1] == '4' || data[1] == '5' || data[1] == '6')) {
+            std::size_t pos = 2;
+            maxValue = 1;
+            if ( !readPnmNumber(data, size, pos, width) || !readPnmNumber(data, size, pos, height) )
+                return false;
+            if ( data[1] != '4' && !readPnmNumber(data, size, pos, maxValue) )
+                return false;
+            /// only 8-bit images, single whitespace before data
+            if (maxValue < 1 || maxValue > 255 || pos >= size || isSpace(data[pos]) == false)
+                return false;
+            offset = pos + 1;
+            channels = (data[1] == '6') ? 3 : 1;
+            format = (data[1] == '6') ? PPM : ( (data[1] == '5') ? PGM : PBM );
+        } else {
+            return false;
+        }
+
+        if (width < 1 || height < 1) {
+            format = UNKNOWN;
+            return false;
+        }
+        if (offset + rowSize() * height > size) {
+            format = UNKNOWN;
+            return false;
+        }
+        return true;
+    }
+
+    void ImageLayout::convertRow(const uchar* row, cv::Vec3b* out) const {
+        if (format == PBM) {
+            for (int x = 0; x < width; ++x) {
+                const uchar value = (row[x >> 3] & (0x80 >> (x & 7))) ? 0 : 255;
+                out[x] = cv::Vec3b(value, value, value);
+            }
+        } else if (maxValue != 255) {
+            /// scale samples from [0, maxValue] to [0, 255], larger samples saturate
+            uchar scale[256];
+            for (int i = 0; i < 256; ++i) {
+                scale[i] = (i >= maxValue) ? 255 : (uchar)( (i * 255 + maxValue / 2) / maxValue );
+            }
+            for (int x = 0; x < width; ++x) {
+                const uchar* pixel = row + channels * x;
+                if (channels == 1) {
+                    out[x] = cv::Vec3b(scale[pixel[0]], scale[pixel[0]], scale[pixel[0]]);
+                } else {
+                    out[x] = cv::Vec3b(scale[pixel[2]], scale[pixel[1]], scale[pixel[0]]);
+                }
+            }
+        } else if (channels == 1) {
+            for (int x = 0; x < width; ++x) {
+                out[x] = cv::Vec3b(row[x], row[x], row[x]);
+            }
+        } else if (format == PPM) {
+            for (int x = 0; x < width; ++x) {
+                const uchar* pixel = row + 3 * x;
+                out[x] = cv::Vec3b(pixel[2], pixel[1], pixel[0]);
+            }
+        } else {
+            std::memcpy(out, row, rowSize());
+        }
+    }
+
+
+    bool ImageFile::load(const std::string& path) {
+        IAS_PROFILE_SCOPE("ImageFile::load", 0);
+        const bool loaded = decode(path);
+        if (loaded && mapped() == false) {
+            /// mapped image does not allocate pixels
+            IAS_PROFILE_ALLOCATION( matrix.dataend - matrix.datastart );
+        }
+        IAS_PROFILE_COUNT( matrix.total() );
+        return loaded;
+    }
+
+    bool ImageFile::decode(const std::string& path) {
+        release();
+
+        std::shared_ptr<MappedFile> file( new MappedFile() );
+        ImageLayout layout;
+        /// writable, because matrix can point to mapped memory
+        if ( file->open(path, true) == false ) {
+            matrix = cv::imread(path, 1);                                   /// BGR format
+            return !matrix.empty();
+        }
+        if ( layout.parse(file->data(), file->size()) == false ) {
+            cv::Mat mask;
+            if ( decodeRle(file->data(), file->size(), mask) ) {
+                IAS_PROFILE_ALLOCATION( mask.dataend - mask.datastart );
+                matrix.create( mask.rows, mask.cols, CV_8UC3 );
+                layout.width = mask.cols;
+                layout.channels = 1;
+                for (int y = 0; y < mask.rows; ++y) {
+                    layout.convertRow( mask.ptr<uchar>(y), matrix.ptr<cv::Vec3b>(y) );
+                }
+                return true;
+            }
+            matrix = cv::imread(path, 1);                                   /// BGR format
+            return !matrix.empty();
+        }
+
+        uchar* pixels = file->writableData() + layout.offset;
+        if (layout.format == ImageLayout::RAW && layout.channels == 3) {
+            /// no copy, matrix points to mapped memory
+            matrix = cv::Mat( layout.height, layout.width, CV_8UC3, pixels, layout.rowSize() );
+            mapping = file;
+            return true;
+        }
+
+        matrix.create( layout.height, layout.width, CV_8UC3 );
+        parallelRows(layout.height, layout.width, [&](const int begin, const int end) {
+            for (int y = begin; y < end; ++y) {
+                layout.convertRow( pixels + y * layout.rowSize(), matrix.ptr<cv::Vec3b>(y) );
+            }
+        });
+        return true;
+    }
+
+    void ImageFile::release() {
+        matrix = cv::Mat();
+        mapping.reset();
+    }
+
+
+    static bool hasExtension(const std::string& path, const std::string& extension) {
+        if (path.size() < extension.size())
+            return false;
+        std::string suffix = path.substr( path.size() - extension.size() );
+        for (std::size_t i = 0; i < suffix.size(); ++i) {
+            suffix[i] = std::tolower( suffix[i] );
+        }
+        return (suffix == extension);
+    }
+
+    bool RowWriter::open(const std::string& path, const int width, const int height, const int channels) {
+        close();
+
+        layout = ImageLayout();
+        if ( hasExtension(path, ".raw") ) {
+            layout.format = ImageLayout::RAW;
+        } else if ( hasExtension(path, ".pgm") && channels == 1 ) {
+            layout.format = ImageLayout::PGM;
+        } else if ( hasExtension(path, ".ppm") && channels == 3 ) {
+            layout.format = ImageLayout::PPM;
+        } else if ( hasExtension(path, ".pbm") && channels == 1 ) {
+            layout.format = ImageLayout::PBM;
+        } else if ( hasExtension(path, ".rle") && channels == 1 ) {
+            layout.format = ImageLayout::RLE;
+        } else {
+            return false;
+        }
+        if ( (channels != 1 && channels != 3) || width < 1 || height < 1 ) {
+            return false;
+        }
+
+        file = std::fopen(path.c_str(), "wb");
+        if (file == NULL) {
+            return false;
+        }
+        layout.width = width;
+        layout.height = height;
+        layout.channels = channels;
+        rowsLeft = height;
+        valid = true;
+
+        switch (layout.format) {
+        case ImageLayout::RAW: {
+            uchar header[RAW_HEADER_SIZE];
+            std::memcpy(header, RAW_MAGIC, 4);
+            writeLE32(header + 4, width);
+            writeLE32(header + 8, height);
+            writeLE32(header + 12, channels);
+            valid = (std::fwrite(header, 1, RAW_HEADER_SIZE, file) == RAW_HEADER_SIZE);
+            break;
+        }
+        case ImageLayout::RLE: {
+            std::vector<uchar> header;
+            encodeRleHeader(width, height, header);
+            valid = (std::fwrite(header.data(), 1, header.size(), file) == header.size());
+            break;
+        }
+        case ImageLayout::PBM:
+            valid = (std::fprintf(file, "P4\n%d %d\n", width, height) > 0);
+            break;
+        default:
+            valid = (std::fprintf(file, "P%c\n%d %d\n255\n", (channels == 1 ? '5' : '6'), width, height) > 0);
+            break;
+        }
+        buffer.resize( layout.rowSize() );
+        return true;
+    }
+
+    bool RowWriter::write(const uchar* row) {
+        if (file == NULL || valid == false || rowsLeft < 1) {
+            valid = false;
+            return false;
+        }
+        switch (layout.format) {
+        case ImageLayout::PPM:
+            for (std::size_t i = 0; i < buffer.size(); i += 3) {
+                buffer[i] = row[i + 2];
+                buffer[i + 1] = row[i + 1];
+                buffer[i + 2] = row[i];
+            }
+            row = buffer.data();
+            break;
+        case ImageLayout::PBM:
+            /// zero pixels are black (bit set)
+            std::fill(buffer.begin(), buffer.end(), 0);
+            for (int x = 0; x < layout.width; ++x) {
+                if (row[x] == 0)
+                    buffer[x >> 3] |= 0x80 >> (x & 7);
+            }
+            row = buffer.data();
+            break;
+        case ImageLayout::RLE:
+            buffer.clear();
+            encodeRleRow(row, layout.width, buffer);
+            row = buffer.data();
+            break;
+        default:
+            break;
+        }
+        valid = (std::fwrite(row, 1, buffer.size(), file) == buffer.size());
+        --rowsLeft;
+        return valid;
+    }
+
+    bool RowWriter::close() {
+        if (file == NULL) {
+            return false;
+        }
+        if (std::fclose(file) != 0) {
+            valid = false;
+        }
+        file = NULL;
+        return valid && (rowsLeft == 0);
+    }
+
+    static bool writeFile(const std::string& path, const std::vector<uchar>& data) {
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        if (file == NULL) {
+            return false;
+        }
+        bool valid = (std::fwrite(data.data(), 1, data.size(), file) == data.size());
+        if (std::fclose(file) != 0) {
+            valid = false;
+        }
+        return valid;
+    }
+
+    bool storeImage(const cv::Mat& matrix, const std::string& path, const int compression) {
+        if (matrix.empty()) {
+            return false;
+        }
+        IAS_PROFILE_SCOPE("storeImage", matrix.total());
+        std::vector<int> params;
+        if ( hasExtension(path, ".png") ) {
+            if ( isBinaryMask(matrix) ) {
+                std::vector<uchar> data;
+                encodeBilevelPng(matrix, compression, data);
+                IAS_PROFILE_ALLOCATION( data.capacity() );
+                return writeFile(path, data);
+            }
+            if (compression >= 0) {
+                /// otherwise default level of OpenCV is used
+                params.push_back( CV_IMWRITE_PNG_COMPRESSION );
+                params.push_back( std::min(compression, 9) );
+            }
+        }
+        if (matrix.depth() != CV_8U) {
+            return cv::imwrite(path, matrix, params);
+        }
+
+        RowWriter writer;
+        if (writer.open(path, matrix.cols, matrix.rows, matrix.channels()) == false) {
+            if ( hasExtension(path, ".raw") || hasExtension(path, ".rle") ) {
+                return false;
+            }
+            return cv::imwrite(path, matrix, params);
+        }
+        for (int y = 0; y < matrix.rows; ++y) {
+            writer.write( matrix.ptr<uchar>(y) );
+        }
+        return writer.close();
+    }
+
+} /* namespace ias */
@@ -0,0 +1,73 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "ias/MappedFile.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+namespace ias {
+
+    bool MappedFile::open(const std::string& path, const bool writableCopy) {
+        close();
+
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || info.st_size < 1) {
+            ::close(fd);
+            return false;
+        }
+
+        /// private writable mapping reserves memory for copy of every page
+        const int protection = writableCopy ? (PROT_READ | PROT_WRITE) : PROT_READ;
+        const int flags = writableCopy ? MAP_PRIVATE : MAP_SHARED;
+        void* mapped = ::mmap(NULL, info.st_size, protection, flags, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) {
+            return false;
+        }
+
+        address = (uchar*)mapped;
+        length = info.st_size;
+        writable = writableCopy;
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (address == NULL) {
+            return ;
+        }
+        ::munmap(address, length);
+        address = NULL;
+        length = 0;
+        writable = false;
+    }
+
+} /* namespace ias */
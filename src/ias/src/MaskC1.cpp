@@ -23,195 +23,373 @@
 
 #include "ias/MaskC1.h"
 
+#include <cstdint>
+#include <utility>
+
+#include "ias/Binarize.h"
+#include "ias/Convolution.h"
+#include "ias/Kernels.h"
+#include "ias/Morphology.h"
+#include "ias/Profiler.h"
+#include "ias/RunLabeling.h"
+#include "ias/SpanFill.h"
+#include "ias/ThreadPool.h"
+
 
 using namespace cv;
 
 
 namespace ias {
 
-    /// compare each color component separately
-    inline bool isColorSame(const cv::Vec3b& color, const Vec3b& pixel, const uchar tolerance ) {
-        for (int i = 0; i < 3; ++i) {
-            const uchar diff = std::abs( color(i) - pixel(i) );
-            if (diff > tolerance)
+    MaskC1::MaskC1(const cv::Mat& image, const cv::Vec3b& color, const uchar tolerance): mask(), bits() {
+        IAS_PROFILE_SCOPE("MaskC1::binarize", image.total());
+
+        /// every pixel is written by kernel, so no need to zero the matrix
+        mask = BufferPool::global().acquire( image.rows, image.cols, CV_8UC1 );
+
+        const int nCols = image.cols;
+        parallelRows(image.rows, nCols, [&](const int begin, const int end) {
+            for (int y = begin; y < end; ++y) {
+                const Vec3b* inrow = image.ptr<Vec3b>(y);
+                uchar* outrow = mask.ptr<uchar>(y);
+                binarizeRow(inrow, outrow, nCols, color, tolerance);
+            }
+        });
+    }
+
+    /// claims pixels of image similar to given color, each pixel is compared at most once
+    class RegionClaim {
+        const cv::Mat& image;
+        BitMask& mask;
+        const cv::Vec3b color;
+        const uchar tolerance;
+        std::vector<uint64_t>& visited;
+
+    public:
+
+        RegionClaim(const cv::Mat& source, BitMask& target, const cv::Vec3b& regionColor, const uchar colorTolerance, std::vector<uint64_t>& visitedBits):
+            image(source), mask(target), color(regionColor), tolerance(colorTolerance), visited(visitedBits)
+        {
+        }
+
+        bool operator()(const int x, const int y) {
+            const std::size_t index = (std::size_t)y * image.cols + x;
+            uint64_t& word = visited[ index / 64 ];
+            const uint64_t bit = (uint64_t)1 << (index % 64);
+            if ( (word & bit) != 0 ) {
+                return false;
+            }
+            word |= bit;
+            if ( isColorSame(color, image.ptr<Vec3b>(y)[x], tolerance) == false ) {
                 return false;
+            }
+            mask.row(y)[x / 64] |= (uint64_t)1 << (x % 64);
+            return true;
         }
-        return true;
+    };
+
+    MaskC1::MaskC1(const cv::Mat& image, const cv::Point& seed, const cv::Vec3b& color, const uchar tolerance): mask(), bits() {
+        IAS_PROFILE_SCOPE("MaskC1::fillColor", image.total());
+
+        /// region is binary, so it is stored packed
+        bits = BitMask( image.cols, image.rows );
+        IAS_PROFILE_ALLOCATION( bits.bytes() );
+
+        /// scratch buffers kept between calls
+        static thread_local std::vector<uint64_t> visited;
+        static thread_local std::vector<FillSpan> stack;
+
+        const std::size_t pixels = (std::size_t)image.rows * image.cols;
+        visited.assign( (pixels + 63) / 64, 0 );
+
+        RegionClaim claim(image, bits, color, tolerance, visited);
+        spanFill(seed, image.cols, image.rows, claim, stack);
     }
 
-    MaskC1::MaskC1(const cv::Mat& image, const cv::Vec3b& color, const uchar tolerance): mask() {
-        mask = cv::Mat::zeros( image.rows, image.cols, CV_8UC1 );
+    /// claims pixels of "value" in source mask, result mask is used to mark visited pixels
+    class ValueClaim {
+        const cv::Mat& source;
+        BitMask& mask;
+        const uchar value;
 
-        const int nRows = image.rows;
-        const int nCols = image.cols;
-        for (int y = 0; y < nRows; ++y) {
-            const Vec3b* inrow = image.ptr<Vec3b>(y);
-            uchar* outrow = mask.ptr<uchar>(y);
-            for (int x = 0; x < nCols; ++x) {
-                if (isColorSame(color, inrow[x], tolerance)) {
-                    outrow[x] = 255;
-                }
+    public:
+
+        ValueClaim(const cv::Mat& sourceMask, BitMask& target, const uchar regionValue): source(sourceMask), mask(target), value(regionValue) {
+        }
+
+        bool operator()(const int x, const int y) {
+            uint64_t& word = mask.row(y)[x / 64];
+            const uint64_t bit = (uint64_t)1 << (x % 64);
+            if ( (word & bit) != 0 ) {
+                return false;
             }
+            if ( source.ptr<uchar>(y)[x] != value ) {
+                return false;
+            }
+            word |= bit;
+            return true;
         }
+    };
+
+    MaskC1::MaskC1(const cv::Mat& source, const cv::Point& seed, const uchar value): mask(), bits() {
+        CV_Assert( source.type() == CV_8UC1 );
+        IAS_PROFILE_SCOPE("MaskC1::fillValue", source.total());
+
+        bits = BitMask( source.cols, source.rows );
+        IAS_PROFILE_ALLOCATION( bits.bytes() );
+
+        /// scratch stack kept between calls
+        static thread_local std::vector<FillSpan> stack;
+
+        ValueClaim claim(source, bits, value);
+        spanFill(seed, source.cols, source.rows, claim, stack);
+    }
+
+    bool MaskC1::pack() {
+        if (packed()) {
+            return true;
+        }
+        if (mask.empty()) {
+            return false;
+        }
+        IAS_PROFILE_SCOPE("MaskC1::pack", mask.total());
+
+        BitMask packedMask;
+        if (packedMask.load(mask) == false) {
+            return false;
+        }
+        IAS_PROFILE_ALLOCATION( packedMask.bytes() );
+        bits = std::move(packedMask);
+        BufferPool::global().release(mask);
+        return true;
+    }
+
+    void MaskC1::unpack() {
+        if (packed() == false) {
+            return ;
+        }
+        IAS_PROFILE_SCOPE("MaskC1::unpack", size().area());
+
+        cv::Mat matrix = BufferPool::global().acquire( bits.rows(), bits.cols(), CV_8UC1 );
+        bits.toMat(matrix);
+        bits = BitMask();
+        swapBuffer(matrix);
     }
 
     void MaskC1::changeColor(const uchar from, const uchar to) {
-        const int nRows = mask.rows;
+        if (packed()) {
+            const bool binaryFrom = (from == 0 || from == 255);
+            if (binaryFrom == false || from == to) {
+                /// packed mask has no pixels of "from" value or nothing changes
+                return ;
+            }
+            if (to == 0 || to == 255) {
+                IAS_PROFILE_SCOPE("MaskC1::changeColor", size().area());
+                bits.changeColor(from, to);
+                return ;
+            }
+            unpack();
+        }
+        IAS_PROFILE_SCOPE("MaskC1::changeColor", mask.total());
+
         const int nCols = mask.cols;
-        for (int y = 0; y < nRows; ++y) {
-            for (int x = 0; x < nCols; ++x) {
-                uchar& pixel = mask.at<uchar>(y, x);
-                if (pixel == from) {
-                    pixel = to;
+        parallelRows(mask.rows, nCols, [&](const int begin, const int end) {
+            for (int y = begin; y < end; ++y) {
+                uchar* row = mask.ptr<uchar>(y);
+                for (int x = 0; x < nCols; ++x) {
+                    if (row[x] == from) {
+                        row[x] = to;
+                    }
                 }
             }
-        }
+        });
     }
 
-    static inline bool fillColor(cv::Mat& image, const cv::Point& pixel, const uchar color, const uchar target, const uint zero) {
-        uchar& currColor = image.at<uchar>( pixel );
-        if ( currColor == target ) {
-            /// already changed
-            return false;
-        } else if ( currColor == color ) {
+    /// claims pixels of "color" by changing them to "target"
+    class ColorClaim {
+        cv::Mat& image;
+        const uchar color;
+        const uchar target;
+
+    public:
+
+        ColorClaim(cv::Mat& mask, const uchar fillColor, const uchar targetColor): image(mask), color(fillColor), target(targetColor) {
+        }
+
+        bool operator()(const int x, const int y) {
+            uchar& currColor = image.ptr<uchar>(y)[x];
+            if ( currColor != color ) {
+                /// other color or already changed
+                return false;
+            }
             currColor = target;
             return true;
-        } else {
-            currColor = zero;
-            return false;
         }
-    }
+    };
 
     void MaskC1::floodFill(const cv::Point& startCoords, const uchar color, const uchar target, const uint zero) {
         if (color == target) {
             return;
         }
+        unpack();
+        IAS_PROFILE_SCOPE("MaskC1::floodFill", mask.total());
 
-        const int nRows = mask.rows;
-        const int nCols = mask.cols;
+        /// scratch stack kept between calls
+        static thread_local std::vector<FillSpan> stack;
 
-        std::vector<cv::Point> queue;
-        queue.push_back( startCoords );
-        while( !queue.empty() ) {
-            const cv::Point node = queue.back();
-            queue.pop_back();
-
-            /// going west
-            for( int x=node.x-1; x>=0; --x ) {
-                const cv::Point pixel( x, node.y );
-                if( fillColor(mask, pixel, color, target, zero) ) {
-                    if (node.y > 0)
-                        queue.push_back( cv::Point(x, node.y-1) );
-                    if (node.y < (nRows-1) )
-                        queue.push_back( cv::Point(x, node.y+1) );
-                } else {
-                    break;
-                }
-            }
+        ColorClaim claim(mask, color, target);
+        spanFill(startCoords, mask.cols, mask.rows, claim, stack);
 
-            /// going east
-            for( int x=node.x; x<nCols; ++x ) {
-                const cv::Point pixel( x, node.y );
-                if( fillColor(mask, pixel, color, target, zero) ) {
-                    if (node.y > 0)
-                        queue.push_back( cv::Point(x, node.y-1) );
-                    if (node.y < (nRows-1) )
-                        queue.push_back( cv::Point(x, node.y+1) );
-                } else {
-                    break;
+        changeColor(color, zero);
+    }
+
+    void MaskC1::floodFillParallel(const cv::Point& startCoords, const uchar color, const uchar target, const uint zero) {
+        if (color == target) {
+            return;
+        }
+        unpack();
+        IAS_PROFILE_SCOPE("MaskC1::floodFillParallel", mask.total());
+
+        RunLabeling labeling;
+        labeling.label(mask, color);
+
+        const long seedRun = labeling.findRun(startCoords);
+        const long seedLabel = (seedRun < 0) ? -1 : (long)labeling.runLabel(seedRun);
+
+        parallelRows(mask.rows, mask.cols, [&](const int begin, const int end) {
+            for (int y = begin; y < end; ++y) {
+                uchar* row = mask.ptr<uchar>(y);
+                for (std::size_t i = labeling.rowBegin(y); i < labeling.rowEnd(y); ++i) {
+                    const RowRun& run = labeling.run(i);
+                    const uchar value = ( (long)labeling.runLabel(i) == seedLabel ) ? target : zero;
+                    std::fill( row + run.left, row + run.right + 1, value );
                 }
             }
-        }
-
-        changeColor(color, zero);
+        });
     }
 
     void MaskC1::applyFilter(const cv::Mat& filter) {
-        if (mask.empty()) {
+        if (empty()) {
             return ;
         }
         if (filter.empty()) {
             return ;
         }
+        unpack();
+        IAS_PROFILE_SCOPE("MaskC1::applyFilter", mask.total());
 
-        const int nRows = mask.rows;
-        const int nCols = mask.cols;
+        const Convolution convolution(filter);
 
-        cv::Mat result = cv::Mat::zeros( nRows, nCols, CV_8UC1 );
-
-        for (int y = 0; y < nRows; ++y) {
-            for (int x = 0; x < nCols; ++x) {
-                const double sum = apply(filter, y, x);
-                if (sum < 0)
-                    result.at<uchar>( y, x ) = 0;
-                else if (sum > 255)
-                    result.at<uchar>( y, x ) = 255;
-                else
-                    result.at<uchar>( y, x ) = sum;
-            }
+        cv::Mat result = BufferPool::global().acquire( mask.rows, mask.cols, CV_8UC1 );
+        convolution.apply(mask, result);
+
+        swapBuffer(result);
+    }
+
+    template<typename Kernel>
+    void MaskC1::applyFilter() {
+        if (empty()) {
+            return ;
         }
+        unpack();
+        IAS_PROFILE_SCOPE("MaskC1::applyKernel", mask.total());
 
-        mask = result;
+        cv::Mat result = BufferPool::global().acquire( mask.rows, mask.cols, CV_8UC1 );
+        parallelRows(mask.rows, mask.cols, [&](const int begin, const int end) {
+            convolve3x3<Kernel>(mask, result, cv::Range(begin, end));
+        });
+
+        swapBuffer(result);
     }
 
+    template void MaskC1::applyFilter<LaplaceKernel>();
+    template void MaskC1::applyFilter<Laplace4Kernel>();
+    template void MaskC1::applyFilter<GaussianKernel>();
+    template void MaskC1::applyFilter<BoxKernel>();
+
     void MaskC1::threshold(const uchar thresh) {
-        const int nRows = mask.rows;
+        if (packed()) {
+            bits.threshold(thresh);
+            return ;
+        }
+        IAS_PROFILE_SCOPE("MaskC1::threshold", mask.total());
+
         const int nCols = mask.cols;
-        for (int y = 0; y < nRows; ++y) {
-            for (int x = 0; x < nCols; ++x) {
-                uchar& value = mask.at<uchar>( y, x );
-                if (value < thresh) {
-                    value = 0;
-                } else {
-                    value = 255;
+        parallelRows(mask.rows, nCols, [&](const int begin, const int end) {
+            for (int y = begin; y < end; ++y) {
+                uchar* row = mask.ptr<uchar>(y);
+                for (int x = 0; x < nCols; ++x) {
+                    if (row[x] < thresh) {
+                        row[x] = 0;
+                    } else {
+                        row[x] = 255;
+                    }
                 }
             }
-        }
+        });
     }
 
     void MaskC1::dilate(const int size, const std::size_t repeats) {
-        const cv::Mat filter = cv::Mat::ones( size, size, CV_64F );
-        for(std::size_t i=0; i<repeats; ++i) {
-            applyFilter(filter);
-        }
+        dilate( cv::Size(size, size), repeats );
     }
 
-    void MaskC1::erode(const int size, const std::size_t repeats) {
-        const cv::Mat filter = cv::Mat::ones( size, size, CV_64F ) / 9;
-        for(std::size_t i=0; i<repeats; ++i) {
-            applyFilter(filter);
-            threshold(254);
+    void MaskC1::dilate(const cv::Size& element, const std::size_t repeats) {
+        if (empty() || element.width < 1 || element.height < 1 || repeats < 1) {
+            return ;
         }
+        if (packed()) {
+            IAS_PROFILE_SCOPE("MaskC1::dilate", size().area());
+            bits.dilate(element, repeats);
+            return ;
+        }
+        IAS_PROFILE_SCOPE("MaskC1::dilate", mask.total());
+
+        cv::Mat result = BufferPool::global().acquire( mask.rows, mask.cols, CV_8UC1 );
+        dilateRect( mask, result, StructuringElement(element).repeated(repeats) );
+
+        swapBuffer(result);
     }
 
-    double MaskC1::apply(const cv::Mat& filter, const int y, const int x) {
-        const int fRows = filter.rows;
-        const int fCols = filter.cols;
+    void MaskC1::erode(const int size, const std::size_t repeats) {
+        erode( cv::Size(size, size), repeats );
+    }
 
-        const int fxm = filter.cols / 2;
-        const int fym = filter.rows / 2;
+    void MaskC1::erode(const cv::Size& element, const std::size_t repeats) {
+        if (empty() || element.width < 1 || element.height < 1 || repeats < 1) {
+            return ;
+        }
+        if (packed()) {
+            IAS_PROFILE_SCOPE("MaskC1::erode", size().area());
+            bits.erode(element, repeats);
+            return ;
+        }
+        IAS_PROFILE_SCOPE("MaskC1::erode", mask.total());
 
-        double sum = 0.0;
+        cv::Mat result = BufferPool::global().acquire( mask.rows, mask.cols, CV_8UC1 );
+        erodeRect( mask, result, StructuringElement(element).repeated(repeats) );
 
-        for (int fy = 0; fy < fRows; ++fy) {
-            const int my = y + (fy-fym);
-            if (my<0)
-                continue;
-            else if (my>=mask.rows)
-                continue;
+        swapBuffer(result);
+    }
 
-            for (int fx = 0; fx < fCols; ++fx) {
-                const int mx = x + (fx-fxm);
-                if (mx<0)
-                    continue;
-                else if (mx>=mask.cols)
-                    continue;
+    void MaskC1::perimeter(const int connectivity) {
+        if (packed()) {
+            IAS_PROFILE_SCOPE("MaskC1::perimeter", size().area());
+            bits.perimeter(connectivity);
+            return ;
+        }
 
-                sum += mask.at<uchar>(my, mx) * filter.at<double>(fy, fx);
-            }
+        /// Laplace filter
+        if (connectivity == 4) {
+            applyFilter<Laplace4Kernel>();
+        } else {
+            applyFilter<LaplaceKernel>();
         }
+        threshold(128);
+    }
 
-        return sum;
+    void MaskC1::swapBuffer(cv::Mat& buffer) {
+        std::swap(mask, buffer);
+        BufferPool::global().release(buffer);
     }
 
 } /* namespace ias */
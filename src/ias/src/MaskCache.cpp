@@ -0,0 +1,97 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "ias/MaskCache.h"
+
+
+namespace ias {
+
+    static std::size_t matBytes(const cv::Mat& mask) {
+        return mask.total() * mask.elemSize();
+    }
+
+
+    MaskCache::MaskCache(const std::size_t budget): entries(), budgetBytes(budget), usedBytes(0), hitCount(0), missCount(0) {
+    }
+
+    void MaskCache::setBudget(const std::size_t budget) {
+        budgetBytes = budget;
+        evict(budgetBytes);
+    }
+
+    cv::Mat MaskCache::find(const cv::Vec3b& color, const uchar tolerance) {
+        for (std::list<Entry>::iterator iter = entries.begin(); iter != entries.end(); ++iter) {
+            if (iter->color != color || iter->tolerance != tolerance) {
+                continue;
+            }
+            ++hitCount;
+            /// move to front
+            entries.splice( entries.begin(), entries, iter );
+            return entries.front().mask;
+        }
+        ++missCount;
+        return cv::Mat();
+    }
+
+    void MaskCache::insert(const cv::Vec3b& color, const uchar tolerance, const cv::Mat& mask) {
+        const std::size_t size = matBytes(mask);
+        if (size > budgetBytes) {
+            return ;
+        }
+
+        for (std::list<Entry>::iterator iter = entries.begin(); iter != entries.end(); ++iter) {
+            if (iter->color == color && iter->tolerance == tolerance) {
+                usedBytes -= matBytes(iter->mask);
+                entries.erase(iter);
+                break;
+            }
+        }
+
+        evict(budgetBytes - size);
+
+        Entry entry;
+        entry.color = color;
+        entry.tolerance = tolerance;
+        entry.mask = mask;
+        entries.push_front( entry );
+        usedBytes += size;
+    }
+
+    void MaskCache::clear() {
+        entries.clear();
+        usedBytes = 0;
+    }
+
+    void MaskCache::resetStats() {
+        hitCount = 0;
+        missCount = 0;
+    }
+
+    void MaskCache::evict(const std::size_t budget) {
+        while (usedBytes > budget && entries.empty() == false) {
+            usedBytes -= matBytes(entries.back().mask);
+            entries.pop_back();
+        }
+    }
+
+} /* namespace ias */
@@ -0,0 +1,202 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "ias/MaskCodec.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <zlib.h>
+
+#include "ias/ThreadPool.h"
+
+
+namespace ias {
+
+    static const char RLE_MAGIC[4] = { 'I', 'A', 'S', 'L' };
+
+    static void appendBE32(std::vector<uchar>& out, const uint32_t value) {
+        out.push_back( (value >> 24) & 0xFF );
+        out.push_back( (value >> 16) & 0xFF );
+        out.push_back( (value >> 8) & 0xFF );
+        out.push_back( value & 0xFF );
+    }
+
+    static void appendLE32(std::vector<uchar>& out, const uint32_t value) {
+        out.push_back( value & 0xFF );
+        out.push_back( (value >> 8) & 0xFF );
+        out.push_back( (value >> 16) & 0xFF );
+        out.push_back( (value >> 24) & 0xFF );
+    }
+
+    static uint32_t readLE32(const uchar* data) {
+        return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+    }
+
+    static void appendChunk(std::vector<uchar>& out, const char* type, const uchar* data, const std::size_t size) {
+        appendBE32(out, size);
+        const std::size_t start = out.size();
+        out.insert(out.end(), type, type + 4);
+        if (size > 0)
+            out.insert(out.end(), data, data + size);
+        appendBE32(out, ::crc32(0, out.data() + start, size + 4));
+    }
+
+
+    bool isBinaryMask(const cv::Mat& matrix) {
+        if (matrix.type() != CV_8UC1)
+            return false;
+        for (int y = 0; y < matrix.rows; ++y) {
+            const uchar* row = matrix.ptr<uchar>(y);
+            for (int x = 0; x < matrix.cols; ++x) {
+                if (row[x] != 0 && row[x] != 255)
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    void encodeBilevelPng(const cv::Mat& mask, const int level, std::vector<uchar>& out) {
+        /// each row starts with filter type 0 (none), pixels are packed starting from most significant bit
+        const std::size_t rowBytes = (mask.cols + 7) / 8 + 1;
+        std::vector<uchar> raw( rowBytes * mask.rows, 0 );
+        parallelRows(mask.rows, mask.cols, [&](const int begin, const int end) {
+            for (int y = begin; y < end; ++y) {
+                const uchar* row = mask.ptr<uchar>(y);
+                uchar* packed = raw.data() + y * rowBytes + 1;
+                for (int x = 0; x < mask.cols; ++x) {
+                    if (row[x] != 0)
+                        packed[x >> 3] |= 0x80 >> (x & 7);
+                }
+            }
+        });
+
+        uLongf compressedSize = compressBound(raw.size());
+        std::vector<uchar> compressed( compressedSize );
+        const int compression = (level < 0) ? DEFAULT_COMPRESSION : std::min(level, 9);
+        if (compress2(compressed.data(), &compressedSize, raw.data(), raw.size(), compression) != Z_OK) {
+            throw std::runtime_error( "unable to compress mask" );
+        }
+        compressed.resize( compressedSize );
+
+        static const uchar SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        out.insert(out.end(), SIGNATURE, SIGNATURE + 8);
+
+        std::vector<uchar> header;
+        appendBE32(header, mask.cols);
+        appendBE32(header, mask.rows);
+        header.push_back( 1 );                              /// bit depth
+        header.push_back( 0 );                              /// grayscale
+        header.push_back( 0 );                              /// deflate
+        header.push_back( 0 );                              /// adaptive filtering
+        header.push_back( 0 );                              /// no interlace
+        appendChunk(out, "IHDR", header.data(), header.size());
+        appendChunk(out, "IDAT", compressed.data(), compressed.size());
+        appendChunk(out, "IEND", NULL, 0);
+    }
+
+    void encodeRleHeader(const int width, const int height, std::vector<uchar>& out) {
+        out.insert(out.end(), RLE_MAGIC, RLE_MAGIC + 4);
+        appendLE32(out, width);
+        appendLE32(out, height);
+    }
+
+    bool decodeRleHeader(const uchar* data, const std::size_t size, int& width, int& height) {
+        if (size < RLE_HEADER_SIZE || std::memcmp(data, RLE_MAGIC, 4) != 0) {
+            return false;
+        }
+        const uint32_t w = readLE32(data + 4);
+        const uint32_t h = readLE32(data + 8);
+        if (w < 1 || h < 1 || w > 0x7FFFFFFF || h > 0x7FFFFFFF) {
+            return false;
+        }
+        width = w;
+        height = h;
+        return true;
+    }
+
+    void appendVarint(std::vector<uchar>& out, uint32_t value) {
+        while (value >= 0x80) {
+            out.push_back( (value & 0x7F) | 0x80 );
+            value >>= 7;
+        }
+        out.push_back( value );
+    }
+
+    bool readVarint(const uchar* data, const std::size_t size, std::size_t& pos, uint32_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            if (pos >= size)
+                return false;
+            const uchar byte = data[pos++];
+            value |= (uint32_t)(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    void encodeRleRow(const uchar* row, const int width, std::vector<uchar>& out) {
+        int x = 0;
+        bool value = false;
+        while (x < width) {
+            const int start = x;
+            while (x < width && (row[x] != 0) == value)
+                ++x;
+            appendVarint(out, x - start);
+            value = !value;
+        }
+    }
+
+    bool decodeRle(const uchar* data, const std::size_t size, cv::Mat& mask) {
+        int width = 0;
+        int height = 0;
+        if (decodeRleHeader(data, size, width, height) == false) {
+            return false;
+        }
+        if (size - RLE_HEADER_SIZE < (std::size_t)height) {
+            /// every row takes at least one byte, do not allocate mask for forged header
+            return false;
+        }
+
+        mask = cv::Mat::zeros( height, width, CV_8UC1 );
+        std::size_t pos = RLE_HEADER_SIZE;
+        for (int y = 0; y < height; ++y) {
+            uchar* row = mask.ptr<uchar>(y);
+            uint32_t x = 0;
+            bool value = false;
+            while (x < (uint32_t)width) {
+                uint32_t length = 0;
+                if (readVarint(data, size, pos, length) == false || length > width - x)
+                    return false;
+                if (value)
+                    std::memset(row + x, 255, length);
+                x += length;
+                value = !value;
+            }
+        }
+        return (pos == size);
+    }
+
+} /* namespace ias */
@@ -0,0 +1,151 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "ias/Morphology.h"
+
+#include <vector>
+
+#include "ias/BufferPool.h"
+
+
+using namespace cv;
+
+
+namespace ias {
+
+    template<typename Op>
+    static inline void applyRows(const uchar* a, const uchar* b, uchar* out, const int nCols) {
+        for (int x = 0; x < nCols; ++x) {
+            out[x] = Op::apply(a[x], b[x]);
+        }
+    }
+
+    /**
+     * Running extremum of window [x - before, x + after] over single row.
+     *
+     * Padded row is split into blocks of window size. For every element prefix "g"
+     * and suffix "h" inside of its block are calculated, then window starting at "i"
+     * is op(h[i], g[i + size - 1]).
+     */
+    template<typename Op>
+    static void runningExtremum(const uchar* in, uchar* out, const int n, const int before, const int after, std::vector<uchar>& scratch) {
+        const int size = before + after + 1;
+        const int padded = n + size - 1;
+        scratch.resize( 3 * padded );
+        uchar* p = scratch.data();
+        uchar* g = p + padded;
+        uchar* h = g + padded;
+
+        std::fill(p, p + before, 0);
+        std::copy(in, in + n, p + before);
+        std::fill(p + before + n, p + padded, 0);
+
+        for (int i = 0; i < padded; ++i) {
+            g[i] = (i % size == 0) ? p[i] : Op::apply(g[i-1], p[i]);
+        }
+        for (int i = padded - 1; i >= 0; --i) {
+            h[i] = (i == padded - 1 || (i + 1) % size == 0) ? p[i] : Op::apply(h[i+1], p[i]);
+        }
+        for (int x = 0; x < n; ++x) {
+            out[x] = Op::apply(h[x], g[x + size - 1]);
+        }
+    }
+
+    template<typename Op>
+    static void horizontalPass(const cv::Mat& source, cv::Mat& target, const int before, const int after) {
+        std::vector<uchar> scratch;
+        for (int y = 0; y < source.rows; ++y) {
+            runningExtremum<Op>(source.ptr<uchar>(y), target.ptr<uchar>(y), source.cols, before, after, scratch);
+        }
+    }
+
+    /**
+     * The same algorithm as "runningExtremum" working on whole rows. Only two blocks
+     * of rows are kept in memory: suffixes of current block and prefixes of next block.
+     */
+    template<typename Op>
+    static void verticalPass(const cv::Mat& source, cv::Mat& target, const int before, const int after) {
+        const int nRows = source.rows;
+        const int nCols = source.cols;
+        const int size = before + after + 1;
+
+        const std::vector<uchar> zeros(nCols, 0);
+        std::vector<uchar> suffix(size * nCols);
+        std::vector<uchar> prefix(size * nCols);
+
+        /// "i"-th row of padded matrix
+        const auto paddedRow = [&](const int i) -> const uchar* {
+            return (i >= before && i < before + nRows) ? source.ptr<uchar>(i - before) : zeros.data();
+        };
+
+        for (int start = 0; start < nRows; start += size) {
+            /// suffixes of block [start, start + size)
+            const int blockEnd = start + size - 1;
+            std::copy( paddedRow(blockEnd), paddedRow(blockEnd) + nCols, &suffix[(size - 1) * nCols] );
+            for (int i = size - 2; i >= 0; --i) {
+                applyRows<Op>( &suffix[(i + 1) * nCols], paddedRow(start + i), &suffix[i * nCols], nCols );
+            }
+
+            /// prefixes of next block, only rows used by current block's windows
+            const int next = start + size;
+            const int nextEnd = std::min(next + size - 1, nRows + size - 1);
+            if (next < nextEnd) {
+                std::copy( paddedRow(next), paddedRow(next) + nCols, &prefix[0] );
+                for (int i = next + 1; i < nextEnd; ++i) {
+                    applyRows<Op>( &prefix[(i - next - 1) * nCols], paddedRow(i), &prefix[(i - next) * nCols], nCols );
+                }
+            }
+
+            const int outEnd = std::min(start + size, nRows);
+            std::copy( &suffix[0], &suffix[0] + nCols, target.ptr<uchar>(start) );
+            for (int x = start + 1; x < outEnd; ++x) {
+                applyRows<Op>( &suffix[(x - start) * nCols], &prefix[(x - 1 - start) * nCols], target.ptr<uchar>(x), nCols );
+            }
+        }
+    }
+
+    template<typename Op>
+    static void morphology(const cv::Mat& source, cv::Mat& target, const StructuringElement& element) {
+        CV_Assert( source.type() == CV_8UC1 );
+        CV_Assert( source.data != target.data );
+
+        target.create( source.rows, source.cols, CV_8UC1 );
+        if (source.empty()) {
+            return ;
+        }
+
+        cv::Mat horizontal = BufferPool::global().acquire( source.rows, source.cols, CV_8UC1 );
+        horizontalPass<Op>(source, horizontal, element.left, element.right);
+        verticalPass<Op>(horizontal, target, element.top, element.bottom);
+        BufferPool::global().release(horizontal);
+    }
+
+    void dilateRect(const cv::Mat& source, cv::Mat& target, const StructuringElement& element) {
+        morphology<MaxOp>(source, target, element);
+    }
+
+    void erodeRect(const cv::Mat& source, cv::Mat& target, const StructuringElement& element) {
+        morphology<MinOp>(source, target, element);
+    }
+
+} /* namespace ias */
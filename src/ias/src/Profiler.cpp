@@ -0,0 +1,123 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include "ias/Profiler.h"
+
+#include <cstring>
+
+
+namespace ias {
+
+    /// bytes allocated by thread while profiler was enabled
+    static thread_local uint64_t threadAllocated = 0;
+
+
+    double ProfileStage::megapixelsPerSecond() const {
+        if (nanoseconds == 0)
+            return 0.0;
+        return pixels * 1000.0 / nanoseconds;
+    }
+
+
+    Profiler::Profiler(): active(false), mutex(), stageList() {
+    }
+
+    Profiler& Profiler::global() {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    bool Profiler::compiled() {
+#ifdef IAS_PROFILING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void Profiler::setEnabled(const bool enabled) {
+        active.store(enabled, std::memory_order_relaxed);
+    }
+
+    void Profiler::countAllocation(const uint64_t bytes) {
+        if (global().enabled())
+            threadAllocated += bytes;
+    }
+
+    uint64_t Profiler::allocatedBytes() {
+        return threadAllocated;
+    }
+
+    void Profiler::record(const char* stage, const uint64_t nanoseconds, const uint64_t pixels, const uint64_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<ProfileStage>::iterator item = stageList.begin();
+        for (; item != stageList.end(); ++item) {
+            if (std::strcmp(item->name.c_str(), stage) == 0)
+                break;
+        }
+        if (item == stageList.end()) {
+            stageList.push_back( ProfileStage(stage) );
+            item = stageList.end() - 1;
+        }
+        item->calls += 1;
+        item->nanoseconds += nanoseconds;
+        item->pixels += pixels;
+        item->bytes += bytes;
+    }
+
+    std::vector<ProfileStage> Profiler::stages() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stageList;
+    }
+
+    void Profiler::reset() {
+        std::lock_guard<std::mutex> lock(mutex);
+        stageList.clear();
+    }
+
+    void Profiler::writeText(std::ostream& output) const {
+        const std::vector<ProfileStage> list = stages();
+        for (std::size_t i = 0; i < list.size(); ++i) {
+            const ProfileStage& stage = list[i];
+            output << stage.name << ": calls=" << stage.calls << " time=" << stage.milliseconds() << "ms"
+                   << " pixels=" << stage.pixels << " bytes=" << stage.bytes
+                   << " throughput=" << stage.megapixelsPerSecond() << "MP/s" << std::endl;
+        }
+    }
+
+    void Profiler::writeJson(std::ostream& output) const {
+        const std::vector<ProfileStage> list = stages();
+        output << "{\"stages\": [";
+        for (std::size_t i = 0; i < list.size(); ++i) {
+            const ProfileStage& stage = list[i];
+            if (i > 0)
+                output << ",";
+            output << "\n  {\"stage\": \"" << stage.name << "\", \"calls\": " << stage.calls
+                   << ", \"time_ms\": " << stage.milliseconds() << ", \"pixels\": " << stage.pixels
+                   << ", \"bytes\": " << stage.bytes << ", \"megapixels_per_s\": " << stage.megapixelsPerSecond() << "}";
+        }
+        output << "\n]}" << std::endl;
+    }
+
+} /* namespace ias */
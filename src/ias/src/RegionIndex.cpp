@@ -0,0 +1,148 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "ias/RegionIndex.h"
+
+
+namespace ias {
+
+    RegionIndex::RegionIndex(): imageSize(), regionColor(), regionTolerance(0), labeling(), runRegion(), regionStart(), regionRuns(), boxes() {
+    }
+
+    RegionIndex::RegionIndex(const cv::Mat& image, const cv::Vec3b& color, const uchar tolerance):
+            imageSize(image.cols, image.rows), regionColor(color), regionTolerance(tolerance),
+            labeling(), runRegion(), regionStart(), regionRuns(), boxes()
+    {
+        {
+            const MaskC1 binarized(image, color, tolerance);
+            labeling.label( binarized.data(), 255 );
+        }
+
+        /// root run of component is its first run, so regions are numbered in order of first pixel
+        const std::size_t nRuns = labeling.size();
+        runRegion.resize( nRuns );
+        uint32_t nRegions = 0;
+        for (std::size_t i = 0; i < nRuns; ++i) {
+            const uint32_t label = labeling.runLabel(i);
+            if (label == i) {
+                runRegion[i] = nRegions++;
+            } else {
+                runRegion[i] = runRegion[label];
+            }
+        }
+
+        /// group runs by region (counting sort keeps row-major order inside region)
+        regionStart.assign( nRegions + 1, 0 );
+        for (std::size_t i = 0; i < nRuns; ++i) {
+            ++regionStart[ runRegion[i] + 1 ];
+        }
+        for (uint32_t r = 0; r < nRegions; ++r) {
+            regionStart[r + 1] += regionStart[r];
+        }
+
+        std::vector<std::size_t> next( regionStart.begin(), regionStart.end() - 1 );
+        regionRuns.resize( nRuns );
+        std::vector<cv::Point> minPoint( nRegions, cv::Point(image.cols, image.rows) );
+        std::vector<cv::Point> maxPoint( nRegions, cv::Point(-1, -1) );
+        for (int y = 0; y < labeling.rows(); ++y) {
+            for (std::size_t i = labeling.rowBegin(y); i < labeling.rowEnd(y); ++i) {
+                const RowRun& run = labeling.run(i);
+                const uint32_t region = runRegion[i];
+                regionRuns[ next[region]++ ] = FillSpan(y, run.left, run.right);
+
+                cv::Point& minP = minPoint[region];
+                cv::Point& maxP = maxPoint[region];
+                minP.x = std::min(minP.x, run.left);
+                minP.y = std::min(minP.y, y);
+                maxP.x = std::max(maxP.x, run.right);
+                maxP.y = std::max(maxP.y, y);
+            }
+        }
+
+        boxes.resize( nRegions );
+        for (uint32_t r = 0; r < nRegions; ++r) {
+            boxes[r] = cv::Rect( minPoint[r].x, minPoint[r].y, maxPoint[r].x - minPoint[r].x + 1, maxPoint[r].y - minPoint[r].y + 1 );
+        }
+    }
+
+    long RegionIndex::regionAt(const cv::Point& pixel) const {
+        if (pixel.x < 0 || pixel.x >= imageSize.width) {
+            return -1;
+        }
+        const long run = labeling.findRun(pixel);
+        if (run < 0) {
+            return -1;
+        }
+        return runRegion[run];
+    }
+
+    std::size_t RegionIndex::area(const std::size_t region) const {
+        std::size_t sum = 0;
+        for (std::size_t i = regionStart[region]; i < regionStart[region + 1]; ++i) {
+            sum += regionRuns[i].right - regionRuns[i].left + 1;
+        }
+        return sum;
+    }
+
+    void RegionIndex::drawRegion(const std::size_t region, cv::Mat& mask, const uchar value) const {
+        CV_Assert( mask.type() == CV_8UC1 && mask.cols == imageSize.width && mask.rows == imageSize.height );
+
+        for (std::size_t i = regionStart[region]; i < regionStart[region + 1]; ++i) {
+            const FillSpan& span = regionRuns[i];
+            uchar* row = mask.ptr<uchar>(span.y);
+            std::fill( row + span.left, row + span.right + 1, value );
+        }
+    }
+
+    void RegionIndex::drawRegion(const std::size_t region, BitMask& mask) const {
+        CV_Assert( mask.cols() == imageSize.width && mask.rows() == imageSize.height );
+
+        for (std::size_t i = regionStart[region]; i < regionStart[region + 1]; ++i) {
+            const FillSpan& span = regionRuns[i];
+            mask.setRun( span.y, span.left, span.right );
+        }
+    }
+
+    MaskC1 RegionIndex::regionMask(const cv::Point& seed) const {
+        if (empty()) {
+            return MaskC1();
+        }
+
+        BitMask mask( imageSize.width, imageSize.height );
+        const long region = regionAt(seed);
+        if (region >= 0) {
+            drawRegion(region, mask);
+        }
+        return MaskC1( std::move(mask) );
+    }
+
+    RleMask RegionIndex::regionRle(const cv::Point& seed) const {
+        const long region = regionAt(seed);
+        if (region < 0) {
+            return RleMask(imageSize.height, imageSize.width);
+        }
+        const std::vector<FillSpan> spans( regionRuns.begin() + regionStart[region], regionRuns.begin() + regionStart[region + 1] );
+        return RleMask(imageSize.height, imageSize.width, spans);
+    }
+
+} /* namespace ias */
@@ -0,0 +1,196 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include "ias/RegionQuery.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "ias/Binarize.h"
+#include "ias/BufferPool.h"
+#include "ias/Profiler.h"
+#include "ias/SpanFill.h"
+#include "ias/ThreadPool.h"
+
+
+namespace ias {
+
+    void classifyColors(const cv::Mat& image, const std::vector<cv::Vec3b>& colors, const std::vector<uchar>& tolerances, cv::Mat& classes) {
+        CV_Assert( image.type() == CV_8UC3 );
+        CV_Assert( colors.size() == tolerances.size() );
+        CV_Assert( colors.size() <= MAX_COLOR_CLASSES );
+        IAS_PROFILE_SCOPE("classifyColors", image.total());
+
+        classes.create( image.rows, image.cols, CV_8UC1 );
+
+        const int nCols = image.cols;
+        parallelRows(image.rows, nCols, [&](const int begin, const int end) {
+            /// row stays in cache while it is compared with all colors
+            std::vector<uchar> match( nCols );
+            for (int y = begin; y < end; ++y) {
+                const cv::Vec3b* inrow = image.ptr<cv::Vec3b>(y);
+                uchar* outrow = classes.ptr<uchar>(y);
+                std::fill( outrow, outrow + nCols, 0 );
+                for (std::size_t i = 0; i < colors.size(); ++i) {
+                    binarizeRow( inrow, match.data(), nCols, colors[i], tolerances[i] );
+                    const uchar bit = (uchar)(1 << i);
+                    for (int x = 0; x < nCols; ++x) {
+                        outrow[x] |= (match[x] & bit);
+                    }
+                }
+            }
+        });
+    }
+
+
+    /// claims pixels of class by clearing class bit, so fills of other classes can still pass the pixel
+    class ClassClaim {
+        cv::Mat& classes;
+        cv::Mat& mask;
+        const uchar bit;
+        const uchar value;
+
+    public:
+
+        ClassClaim(cv::Mat& classMask, cv::Mat& target, const uchar classBit, const uchar regionValue):
+            classes(classMask), mask(target), bit(classBit), value(regionValue)
+        {
+        }
+
+        bool operator()(const int x, const int y) {
+            uchar& pixelClasses = classes.ptr<uchar>(y)[x];
+            if ( (pixelClasses & bit) == 0 ) {
+                return false;
+            }
+            pixelClasses &= ~bit;
+            /// lower label wins, so result does not depend on order of classification passes
+            uchar& pixel = mask.ptr<uchar>(y)[x];
+            if (pixel == 0 || pixel > value) {
+                pixel = value;
+            }
+            return true;
+        }
+    };
+
+    /// claims pixels of class for union of regions, mask is written by spans of fill
+    class UnionClaim {
+        cv::Mat& classes;
+        const uchar bit;
+
+    public:
+
+        UnionClaim(cv::Mat& classMask, const uchar classBit): classes(classMask), bit(classBit) {
+        }
+
+        bool operator()(const int x, const int y) {
+            uchar& pixelClasses = classes.ptr<uchar>(y)[x];
+            if ( (pixelClasses & bit) == 0 ) {
+                return false;
+            }
+            pixelClasses &= ~bit;
+            return true;
+        }
+    };
+
+    /// sets filled spans in packed mask
+    struct BitSpanOutput {
+        BitMask& mask;
+
+        explicit BitSpanOutput(BitMask& target): mask(target) {
+        }
+
+        void operator()(const FillSpan& span) {
+            mask.setRun( span.y, span.left, span.right );
+        }
+    };
+
+
+    MaskC1 findRegions(const cv::Mat& image, const std::vector<RegionQuery>& queries, const bool labelled) {
+        if (image.empty()) {
+            return MaskC1();
+        }
+        if (labelled && queries.size() > MAX_REGION_LABELS) {
+            return MaskC1();
+        }
+        IAS_PROFILE_SCOPE("findRegions", image.total());
+
+        /// distinct colors
+        std::vector<cv::Vec3b> colors;
+        std::vector<uchar> tolerances;
+        std::vector<std::size_t> queryClass( queries.size() );
+        for (std::size_t q = 0; q < queries.size(); ++q) {
+            std::size_t c = 0;
+            while (c < colors.size() && (colors[c] != queries[q].color || tolerances[c] != queries[q].tolerance)) {
+                ++c;
+            }
+            if (c == colors.size()) {
+                colors.push_back( queries[q].color );
+                tolerances.push_back( queries[q].tolerance );
+            }
+            queryClass[q] = c;
+        }
+
+        /// union is packed, so only filled spans are written
+        cv::Mat mask;
+        BitMask bits;
+        if (labelled) {
+            mask = BufferPool::global().acquire( image.rows, image.cols, CV_8UC1 );
+            mask.setTo( cv::Scalar(0) );
+        } else {
+            bits = BitMask( image.cols, image.rows );
+        }
+        cv::Mat classes = BufferPool::global().acquire( image.rows, image.cols, CV_8UC1 );
+
+        /// scratch stack kept between calls
+        static thread_local std::vector<FillSpan> stack;
+
+        for (std::size_t first = 0; first < colors.size(); first += MAX_COLOR_CLASSES) {
+            const std::size_t last = std::min( first + MAX_COLOR_CLASSES, colors.size() );
+            const std::vector<cv::Vec3b> passColors( colors.begin() + first, colors.begin() + last );
+            const std::vector<uchar> passTolerances( tolerances.begin() + first, tolerances.begin() + last );
+            classifyColors(image, passColors, passTolerances, classes);
+
+            for (std::size_t q = 0; q < queries.size(); ++q) {
+                if (queryClass[q] < first || queryClass[q] >= last)
+                    continue;
+                const uchar bit = (uchar)(1 << (queryClass[q] - first));
+                if (labelled) {
+                    ClassClaim claim(classes, mask, bit, (uchar)(q + 1));
+                    spanFill(queries[q].seed, image.cols, image.rows, claim, stack);
+                } else {
+                    UnionClaim claim(classes, bit);
+                    BitSpanOutput output(bits);
+                    spanFill(queries[q].seed, image.cols, image.rows, claim, stack, output);
+                }
+            }
+        }
+
+        BufferPool::global().release(classes);
+        if (labelled) {
+            return MaskC1(mask);
+        }
+        return MaskC1( std::move(bits) );
+    }
+
+} /* namespace ias */
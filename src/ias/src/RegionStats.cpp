@@ -0,0 +1,74 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "ias/RegionStats.h"
+
+#include <algorithm>
+
+
+namespace ias {
+
+    RegionStats::RegionStats(): area(0), boundingBox(), centroid(), perimeter(0), touchesBorder(false) {
+    }
+
+    RegionStats::RegionStats(const RleMask& region, const int connectivity): area(0), boundingBox(), centroid(), perimeter(0), touchesBorder(false) {
+        const int lastRow = region.rows() - 1;
+        const int lastCol = region.cols() - 1;
+        int minX = region.cols();
+        int maxX = -1;
+        int minY = -1;
+        int maxY = -1;
+        uint64_t sumX2 = 0;                 /// doubled sum of x coordinates
+        uint64_t sumY = 0;
+        for (int y = 0; y <= lastRow; ++y) {
+            const std::size_t begin = region.rowBegin(y);
+            const std::size_t end = region.rowEnd(y);
+            if (begin == end)
+                continue;
+            if (minY < 0)
+                minY = y;
+            maxY = y;
+            for (std::size_t i = begin; i < end; ++i) {
+                const RowRun& run = region.run(i);
+                const uint64_t length = run.right - run.left + 1;
+                area += length;
+                sumX2 += (uint64_t)(run.left + run.right) * length;
+                sumY += (uint64_t)y * length;
+            }
+            const int left = region.run(begin).left;
+            const int right = region.run(end - 1).right;
+            minX = std::min(minX, left);
+            maxX = std::max(maxX, right);
+            if (y == 0 || y == lastRow || left == 0 || right == lastCol)
+                touchesBorder = true;
+        }
+        if (area < 1) {
+            return ;
+        }
+
+        boundingBox = cv::Rect(minX, minY, maxX - minX + 1, maxY - minY + 1);
+        centroid = cv::Point2d( (double)sumX2 / (2.0 * area), (double)sumY / area );
+        perimeter = region.perimeter(connectivity).area();
+    }
+
+} /* namespace ias */
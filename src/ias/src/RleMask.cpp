@@ -0,0 +1,439 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "ias/RleMask.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+
+#include "ias/Binarize.h"
+#include "ias/BufferPool.h"
+#include "ias/MappedFile.h"
+#include "ias/MaskCodec.h"
+
+
+namespace ias {
+
+    struct UniteOperation {
+        bool operator()(const bool a, const bool b) const {
+            return a || b;
+        }
+    };
+
+    struct IntersectOperation {
+        bool operator()(const bool a, const bool b) const {
+            return a && b;
+        }
+    };
+
+    struct SubtractOperation {
+        bool operator()(const bool a, const bool b) const {
+            return a && !b;
+        }
+    };
+
+    /// boundary "k" of runs: left of run k/2 or position after right of run k/2
+    static inline int runBoundary(const RowRun* runs, const std::size_t k) {
+        const RowRun& run = runs[k / 2];
+        return (k % 2 == 0) ? run.left : run.right + 1;
+    }
+
+    /**
+     * Combine two rows of maximal runs by sweeping over run boundaries,
+     * append maximal runs of result to "out".
+     */
+    template<typename Operation>
+    static void combineRows(const RowRun* a, const std::size_t na, const RowRun* b, const std::size_t nb, const Operation& operation, std::vector<RowRun>& out) {
+        std::size_t ka = 0;
+        std::size_t kb = 0;
+        bool inA = false;
+        bool inB = false;
+        int start = -1;
+        while (ka < 2 * na || kb < 2 * nb) {
+            const int xa = (ka < 2 * na) ? runBoundary(a, ka) : INT_MAX;
+            const int xb = (kb < 2 * nb) ? runBoundary(b, kb) : INT_MAX;
+            const int x = std::min(xa, xb);
+            if (xa == x) {
+                inA = !inA;
+                ++ka;
+            }
+            if (xb == x) {
+                inB = !inB;
+                ++kb;
+            }
+            const bool inside = operation(inA, inB);
+            if (inside && start < 0) {
+                start = x;
+            } else if (!inside && start >= 0) {
+                const RowRun run = { start, x - 1 };
+                out.push_back( run );
+                start = -1;
+            }
+        }
+    }
+
+    /// shrink each run by one pixel from both sides
+    static void shrinkRow(const RowRun* runs, const std::size_t count, std::vector<RowRun>& out) {
+        out.clear();
+        for (std::size_t i = 0; i < count; ++i) {
+            if (runs[i].right - runs[i].left >= 2) {
+                const RowRun run = { runs[i].left + 1, runs[i].right - 1 };
+                out.push_back( run );
+            }
+        }
+    }
+
+
+    RleMask::RleMask(): nRows(0), nCols(0), runs(), rowStart(1, 0) {
+    }
+
+    RleMask::RleMask(const int rows, const int cols): nRows(rows), nCols(cols), runs(), rowStart(rows + 1, 0) {
+    }
+
+    RleMask::RleMask(const cv::Mat& mask): nRows(mask.rows), nCols(mask.cols), runs(), rowStart() {
+        CV_Assert( mask.type() == CV_8UC1 );
+
+        rowStart.reserve( nRows + 1 );
+        rowStart.push_back( 0 );
+        for (int y = 0; y < nRows; ++y) {
+            const uchar* row = mask.ptr<uchar>(y);
+            int x = 0;
+            while (x < nCols) {
+                if (row[x] == 0) {
+                    ++x;
+                    continue;
+                }
+                const int start = x;
+                while (x < nCols && row[x] != 0)
+                    ++x;
+                const RowRun run = { start, x - 1 };
+                runs.push_back( run );
+            }
+            rowStart.push_back( runs.size() );
+        }
+    }
+
+    RleMask::RleMask(const int rows, const int cols, std::vector<FillSpan> spans): nRows(rows), nCols(cols), runs(), rowStart() {
+        std::sort(spans.begin(), spans.end(), [](const FillSpan& a, const FillSpan& b) {
+            return (a.y < b.y) || (a.y == b.y && a.left < b.left);
+        });
+
+        /// merge touching spans of the same row into maximal runs
+        rowStart.assign( nRows + 1, 0 );
+        runs.reserve( spans.size() );
+        int lastRow = -1;
+        for (std::size_t i = 0; i < spans.size(); ++i) {
+            const FillSpan& span = spans[i];
+            if (span.y == lastRow && runs.back().right + 1 >= span.left) {
+                runs.back().right = std::max( runs.back().right, span.right );
+                continue;
+            }
+            const RowRun run = { span.left, span.right };
+            runs.push_back( run );
+            ++rowStart[ span.y + 1 ];
+            lastRow = span.y;
+        }
+        for (int y = 0; y < nRows; ++y) {
+            rowStart[y + 1] += rowStart[y];
+        }
+    }
+
+    /// claims pixels of image similar to given color, visited pixels are marked in bitset
+    class RunClaim {
+        const cv::Mat& image;
+        const cv::Vec3b color;
+        const uchar tolerance;
+        std::vector<uint64_t>& visited;
+
+    public:
+
+        RunClaim(const cv::Mat& source, const cv::Vec3b& regionColor, const uchar colorTolerance, std::vector<uint64_t>& visitedBits):
+            image(source), color(regionColor), tolerance(colorTolerance), visited(visitedBits)
+        {
+        }
+
+        bool operator()(const int x, const int y) {
+            const std::size_t index = (std::size_t)y * image.cols + x;
+            uint64_t& word = visited[ index / 64 ];
+            const uint64_t bit = (uint64_t)1 << (index % 64);
+            if ( (word & bit) != 0 ) {
+                return false;
+            }
+            word |= bit;
+            return isColorSame(color, image.ptr<cv::Vec3b>(y)[x], tolerance);
+        }
+    };
+
+    /// collects filled spans
+    struct SpanCollector {
+        std::vector<FillSpan>& spans;
+
+        SpanCollector(std::vector<FillSpan>& output): spans(output) {
+        }
+
+        void operator()(const FillSpan& span) {
+            spans.push_back( span );
+        }
+    };
+
+    RleMask RleMask::fill(const cv::Mat& image, const cv::Point& seed, const cv::Vec3b& color, const uchar tolerance) {
+        /// scratch buffers kept between calls
+        static thread_local std::vector<uint64_t> visited;
+        static thread_local std::vector<FillSpan> stack;
+
+        const std::size_t pixels = (std::size_t)image.rows * image.cols;
+        visited.assign( (pixels + 63) / 64, 0 );
+
+        std::vector<FillSpan> spans;
+        RunClaim claim(image, color, tolerance, visited);
+        SpanCollector collector(spans);
+        spanFill(seed, image.cols, image.rows, claim, stack, collector);
+        return RleMask(image.rows, image.cols, spans);
+    }
+
+    std::size_t RleMask::area() const {
+        std::size_t sum = 0;
+        for (std::size_t i = 0; i < runs.size(); ++i) {
+            sum += runs[i].right - runs[i].left + 1;
+        }
+        return sum;
+    }
+
+    cv::Rect RleMask::boundingBox() const {
+        int minX = INT_MAX;
+        int maxX = -1;
+        int minY = -1;
+        int maxY = -1;
+        for (int y = 0; y < nRows; ++y) {
+            const std::size_t begin = rowStart[y];
+            const std::size_t end = rowStart[y + 1];
+            if (begin == end)
+                continue;
+            if (minY < 0)
+                minY = y;
+            maxY = y;
+            minX = std::min( minX, runs[begin].left );
+            maxX = std::max( maxX, runs[end - 1].right );
+        }
+        if (minY < 0) {
+            return cv::Rect();
+        }
+        return cv::Rect(minX, minY, maxX - minX + 1, maxY - minY + 1);
+    }
+
+    bool RleMask::contains(const cv::Point& pixel) const {
+        if (pixel.y < 0 || pixel.y >= nRows) {
+            return false;
+        }
+        const RowRun* begin = runs.data() + rowStart[pixel.y];
+        const RowRun* end = runs.data() + rowStart[pixel.y + 1];
+        const RowRun* found = std::lower_bound(begin, end, pixel.x, [](const RowRun& run, const int x) {
+            return run.right < x;
+        });
+        return (found != end && found->left <= pixel.x);
+    }
+
+    bool RleMask::operator==(const RleMask& other) const {
+        if (nRows != other.nRows || nCols != other.nCols || runs.size() != other.runs.size()) {
+            return false;
+        }
+        if (rowStart != other.rowStart) {
+            return false;
+        }
+        for (std::size_t i = 0; i < runs.size(); ++i) {
+            if (runs[i].left != other.runs[i].left || runs[i].right != other.runs[i].right)
+                return false;
+        }
+        return true;
+    }
+
+    template<typename Operation>
+    RleMask RleMask::combine(const RleMask& other, const Operation& operation) const {
+        CV_Assert( nRows == other.nRows && nCols == other.nCols );
+
+        RleMask result(nRows, nCols);
+        result.runs.reserve( std::max(runs.size(), other.runs.size()) );
+        for (int y = 0; y < nRows; ++y) {
+            combineRows( runs.data() + rowStart[y], rowStart[y + 1] - rowStart[y],
+                         other.runs.data() + other.rowStart[y], other.rowStart[y + 1] - other.rowStart[y],
+                         operation, result.runs );
+            result.rowStart[y + 1] = result.runs.size();
+        }
+        return result;
+    }
+
+    RleMask RleMask::unite(const RleMask& other) const {
+        return combine(other, UniteOperation());
+    }
+
+    RleMask RleMask::intersect(const RleMask& other) const {
+        return combine(other, IntersectOperation());
+    }
+
+    RleMask RleMask::subtract(const RleMask& other) const {
+        return combine(other, SubtractOperation());
+    }
+
+    RleMask RleMask::perimeter(const int connectivity) const {
+        RleMask result(nRows, nCols);
+        result.runs.reserve( runs.size() );
+
+        /// perimeter is mask without its erosion (3x3 square or cross)
+        std::vector<RowRun> shrunk[3];              /// shrunk rows y-1, y, y+1
+        std::vector<RowRun> eroded;
+        std::vector<RowRun> partial;
+        const auto shrink = [&](const int y, std::vector<RowRun>& out) {
+            out.clear();
+            if (y >= 0 && y < nRows)
+                shrinkRow(runs.data() + rowStart[y], rowStart[y + 1] - rowStart[y], out);
+        };
+        shrink(-1, shrunk[0]);
+        shrink(0, shrunk[1]);
+
+        for (int y = 0; y < nRows; ++y) {
+            shrink(y + 1, shrunk[2]);
+
+            const RowRun* row = runs.data() + rowStart[y];
+            const std::size_t count = rowStart[y + 1] - rowStart[y];
+            eroded.clear();
+            if (y > 0 && y < nRows - 1) {
+                partial.clear();
+                if (connectivity == 4) {
+                    combineRows( runs.data() + rowStart[y - 1], rowStart[y] - rowStart[y - 1],
+                                 runs.data() + rowStart[y + 1], rowStart[y + 2] - rowStart[y + 1],
+                                 IntersectOperation(), partial );
+                } else {
+                    combineRows( shrunk[0].data(), shrunk[0].size(), shrunk[2].data(), shrunk[2].size(), IntersectOperation(), partial );
+                }
+                combineRows( partial.data(), partial.size(), shrunk[1].data(), shrunk[1].size(), IntersectOperation(), eroded );
+            }
+            combineRows( row, count, eroded.data(), eroded.size(), SubtractOperation(), result.runs );
+            result.rowStart[y + 1] = result.runs.size();
+
+            shrunk[0].swap( shrunk[1] );
+            shrunk[1].swap( shrunk[2] );
+        }
+        return result;
+    }
+
+    void RleMask::draw(cv::Mat& mask, const uchar value) const {
+        CV_Assert( mask.type() == CV_8UC1 && mask.rows == nRows && mask.cols == nCols );
+
+        for (int y = 0; y < nRows; ++y) {
+            uchar* row = mask.ptr<uchar>(y);
+            for (std::size_t i = rowStart[y]; i < rowStart[y + 1]; ++i) {
+                std::fill( row + runs[i].left, row + runs[i].right + 1, value );
+            }
+        }
+    }
+
+    MaskC1 RleMask::toMask() const {
+        cv::Mat mask = BufferPool::global().acquire( nRows, nCols, CV_8UC1 );
+        mask.setTo( cv::Scalar(0) );
+        draw(mask, 255);
+        return MaskC1(mask);
+    }
+
+    void RleMask::serialize(std::vector<uchar>& out) const {
+        encodeRleHeader(nCols, nRows, out);
+        for (int y = 0; y < nRows; ++y) {
+            int x = 0;
+            for (std::size_t i = rowStart[y]; i < rowStart[y + 1]; ++i) {
+                appendVarint(out, runs[i].left - x);
+                appendVarint(out, runs[i].right - runs[i].left + 1);
+                x = runs[i].right + 1;
+            }
+            if (x < nCols) {
+                appendVarint(out, nCols - x);
+            }
+        }
+    }
+
+    bool RleMask::deserialize(const uchar* data, const std::size_t size) {
+        int width = 0;
+        int height = 0;
+        if (decodeRleHeader(data, size, width, height) == false) {
+            return false;
+        }
+        if (size - RLE_HEADER_SIZE < (std::size_t)height) {
+            /// every row takes at least one byte, do not reserve rows of forged header
+            return false;
+        }
+
+        RleMask mask;
+        mask.nRows = height;
+        mask.nCols = width;
+        mask.rowStart.reserve( height + 1 );
+        std::size_t pos = RLE_HEADER_SIZE;
+        for (int y = 0; y < height; ++y) {
+            uint32_t x = 0;
+            bool value = false;
+            while (x < (uint32_t)width) {
+                uint32_t length = 0;
+                if (readVarint(data, size, pos, length) == false || length > width - x)
+                    return false;
+                if (value && length > 0) {
+                    if (mask.runs.size() > mask.rowStart.back() && mask.runs.back().right + 1 == (int)x) {
+                        /// empty gap between runs
+                        mask.runs.back().right += length;
+                    } else {
+                        const RowRun run = { (int)x, (int)(x + length - 1) };
+                        mask.runs.push_back( run );
+                    }
+                }
+                x += length;
+                value = !value;
+            }
+            mask.rowStart.push_back( mask.runs.size() );
+        }
+        if (pos != size) {
+            return false;
+        }
+        *this = mask;
+        return true;
+    }
+
+    bool RleMask::store(const std::string& path) const {
+        std::vector<uchar> data;
+        serialize(data);
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        if (file == NULL) {
+            return false;
+        }
+        bool valid = (std::fwrite(data.data(), 1, data.size(), file) == data.size());
+        if (std::fclose(file) != 0) {
+            valid = false;
+        }
+        return valid;
+    }
+
+    bool RleMask::load(const std::string& path) {
+        MappedFile file;
+        if (file.open(path) == false) {
+            return false;
+        }
+        return deserialize(file.data(), file.size());
+    }
+
+} /* namespace ias */
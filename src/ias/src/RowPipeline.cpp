@@ -0,0 +1,154 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "ias/RowPipeline.h"
+
+#include "ias/Kernels.h"
+#include "ias/Morphology.h"
+
+
+using namespace cv;
+
+
+namespace ias {
+
+    /// 3x3 minimum or maximum of row, pixels outside of row are zeros
+    template<typename Op>
+    static void morphologyRow3x3(const uchar* above, const uchar* row, const uchar* below, uchar* out, const int nCols) {
+        if (nCols < 1) {
+            return ;
+        }
+
+        uchar previous = 0;
+        uchar current = Op::apply( Op::apply(above[0], row[0]), below[0] );
+        for (int x = 0; x < nCols; ++x) {
+            const uchar next = (x + 1 < nCols) ? Op::apply( Op::apply(above[x+1], row[x+1]), below[x+1] ) : 0;
+            out[x] = Op::apply( Op::apply(previous, current), next );
+            previous = current;
+            current = next;
+        }
+    }
+
+    void RowPipeline::addStage(const Operation operation, const int threshold) {
+        Stage stage;
+        stage.operation = operation;
+        stage.threshold = threshold;
+        stage.received = 0;
+        stages.push_back( stage );
+    }
+
+    void RowPipeline::start(const int width, const int height, const RowSink& output) {
+        nCols = width;
+        nRows = height;
+        sink = output;
+        zeros.assign( nCols, 0 );
+        for (std::size_t i = 0; i < stages.size(); ++i) {
+            Stage& stage = stages[i];
+            stage.rows.assign( 3 * nCols, 0 );
+            stage.output.assign( nCols, 0 );
+            stage.received = 0;
+        }
+    }
+
+    void RowPipeline::push(const uchar* row) {
+        feed(0, row);
+    }
+
+    void RowPipeline::run(const cv::Mat& source, cv::Mat& target) {
+        CV_Assert( source.type() == CV_8UC1 );
+        CV_Assert( source.data != target.data );
+
+        target.create( source.rows, source.cols, CV_8UC1 );
+
+        int outRow = 0;
+        start( source.cols, source.rows, [&target, &outRow](const uchar* row) {
+            std::copy( row, row + target.cols, target.ptr<uchar>(outRow) );
+            ++outRow;
+        });
+        for (int y = 0; y < source.rows; ++y) {
+            push( source.ptr<uchar>(y) );
+        }
+    }
+
+    void RowPipeline::feed(const std::size_t index, const uchar* row) {
+        if (index >= stages.size()) {
+            sink(row);
+            return ;
+        }
+
+        Stage& stage = stages[index];
+        const int y = stage.received;
+        std::copy( row, row + nCols, &stage.rows[ (y % 3) * nCols ] );
+        ++stage.received;
+
+        /// row "y - 1" has both neighbours now
+        if (y > 0) {
+            emit(index, y - 1);
+        }
+        /// last row has zeros below
+        if (y == nRows - 1) {
+            emit(index, y);
+        }
+    }
+
+    void RowPipeline::emit(const std::size_t index, const int y) {
+        Stage& stage = stages[index];
+        const uchar* above = (y > 0) ? &stage.rows[ ((y - 1) % 3) * nCols ] : zeros.data();
+        const uchar* current = &stage.rows[ (y % 3) * nCols ];
+        const uchar* below = (y + 1 < nRows) ? &stage.rows[ ((y + 1) % 3) * nCols ] : zeros.data();
+        uchar* out = stage.output.data();
+
+        switch(stage.operation) {
+        case ERODE: {
+            morphologyRow3x3<MinOp>(above, current, below, out, nCols);
+            break;
+        }
+        case DILATE: {
+            morphologyRow3x3<MaxOp>(above, current, below, out, nCols);
+            break;
+        }
+        case GAUSSIAN_BLUR: {
+            convolveRow3x3<GaussianKernel>(above, current, below, out, nCols);
+            break;
+        }
+        case LAPLACE: {
+            convolveRow3x3<LaplaceKernel>(above, current, below, out, nCols);
+            break;
+        }
+        case LAPLACE4: {
+            convolveRow3x3<Laplace4Kernel>(above, current, below, out, nCols);
+            break;
+        }
+        }
+
+        if (stage.threshold >= 0) {
+            const int thresh = stage.threshold;
+            for (int x = 0; x < nCols; ++x) {
+                out[x] = (out[x] < thresh) ? 0 : 255;
+            }
+        }
+
+        feed(index + 1, out);
+    }
+
+} /* namespace ias */
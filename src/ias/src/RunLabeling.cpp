@@ -0,0 +1,252 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "ias/RunLabeling.h"
+
+#include <atomic>
+#include <memory>
+
+#include "ias/ThreadPool.h"
+
+
+namespace ias {
+
+    /// minimal number of pixels labeled by one band
+    static const int MIN_BAND_PIXELS = 1 << 18;
+
+
+    /// runs and local union-find of one band of rows
+    struct BandRuns {
+        int firstRow;
+        int endRow;
+        std::vector<RowRun> runs;
+        std::vector<std::size_t> rowStart;
+        std::vector<uint32_t> parent;
+
+        uint32_t find(uint32_t index) {
+            while (parent[index] != index) {
+                parent[index] = parent[ parent[index] ];
+                index = parent[index];
+            }
+            return index;
+        }
+
+        void unite(uint32_t a, uint32_t b) {
+            a = find(a);
+            b = find(b);
+            if (a < b) {
+                parent[b] = a;
+            } else if (b < a) {
+                parent[a] = b;
+            }
+        }
+    };
+
+    /// union-find safe for concurrent unions, smaller index is always the root
+    class ConcurrentForest {
+        std::unique_ptr< std::atomic<uint32_t>[] > parent;
+
+    public:
+
+        explicit ConcurrentForest(const std::size_t size): parent( new std::atomic<uint32_t>[size] ) {
+        }
+
+        void set(const std::size_t index, const uint32_t value) {
+            parent[index].store(value, std::memory_order_relaxed);
+        }
+
+        uint32_t find(uint32_t index) {
+            while (true) {
+                uint32_t up = parent[index].load();
+                if (up == index) {
+                    return index;
+                }
+                const uint32_t upper = parent[up].load();
+                if (upper != up) {
+                    /// path halving, failure only means other thread changed the link
+                    parent[index].compare_exchange_weak(up, upper);
+                }
+                index = upper;
+            }
+        }
+
+        void unite(uint32_t a, uint32_t b) {
+            while (true) {
+                a = find(a);
+                b = find(b);
+                if (a == b) {
+                    return ;
+                }
+                if (a < b) {
+                    std::swap(a, b);
+                }
+                /// link greater root to smaller one, retry if "a" stopped being root
+                uint32_t expected = a;
+                if ( parent[a].compare_exchange_strong(expected, b) ) {
+                    return ;
+                }
+            }
+        }
+    };
+
+    /// find runs of row and join them with overlapping runs of previous row
+    static void scanRow(const uchar* row, const int nCols, const uchar value, BandRuns& band, const std::size_t prevBegin, const std::size_t prevEnd) {
+        std::size_t prev = prevBegin;
+        int x = 0;
+        while (x < nCols) {
+            if (row[x] != value) {
+                ++x;
+                continue;
+            }
+            const int left = x;
+            while (x < nCols && row[x] == value) {
+                ++x;
+            }
+            const RowRun current = { left, x - 1 };
+            const uint32_t index = band.runs.size();
+            band.runs.push_back( current );
+            band.parent.push_back( index );
+
+            /// skip runs of previous row ending before current one
+            while (prev < prevEnd && band.runs[prev].right < current.left) {
+                ++prev;
+            }
+            std::size_t p = prev;
+            while (p < prevEnd && band.runs[p].left <= current.right) {
+                band.unite( p, index );
+                ++p;
+            }
+        }
+    }
+
+    void RunLabeling::label(const cv::Mat& mask, const uchar value) {
+        CV_Assert( mask.type() == CV_8UC1 );
+
+        nRows = mask.rows;
+        const int nCols = mask.cols;
+
+        ThreadPool& pool = ThreadPool::global();
+        const int grain = std::max(1, MIN_BAND_PIXELS / std::max(1, nCols));
+        const int nBands = std::max(1, std::min( (int)pool.size(), nRows / grain ));
+
+        /// label bands independently
+        std::vector<BandRuns> bands(nBands);
+        pool.parallelFor(nBands, [&](const int begin, const int end) {
+            for (int b = begin; b < end; ++b) {
+                BandRuns& band = bands[b];
+                band.firstRow = (int)( (long long)nRows * b / nBands );
+                band.endRow = (int)( (long long)nRows * (b + 1) / nBands );
+                band.rowStart.push_back( 0 );
+                for (int y = band.firstRow; y < band.endRow; ++y) {
+                    const std::size_t prevBegin = (y > band.firstRow) ? band.rowStart[ band.rowStart.size() - 2 ] : 0;
+                    const std::size_t prevEnd = band.runs.size();
+                    scanRow( mask.ptr<uchar>(y), nCols, value, band, prevBegin, prevEnd );
+                    band.rowStart.push_back( band.runs.size() );
+                }
+            }
+        });
+
+        std::vector<std::size_t> offsets(nBands + 1, 0);
+        for (int b = 0; b < nBands; ++b) {
+            offsets[b + 1] = offsets[b] + bands[b].runs.size();
+        }
+        const std::size_t nRuns = offsets[nBands];
+        CV_Assert( nRuns < (std::size_t)UINT32_MAX );
+
+        runs.resize( nRuns );
+        rowStart.resize( nRows + 1 );
+        rowStart[nRows] = nRuns;
+        labels.resize( nRuns );
+
+        /// move bands into global arrays
+        ConcurrentForest forest( nRuns );
+        pool.parallelFor(nBands, [&](const int begin, const int end) {
+            for (int b = begin; b < end; ++b) {
+                BandRuns& band = bands[b];
+                const std::size_t offset = offsets[b];
+                std::copy( band.runs.begin(), band.runs.end(), runs.begin() + offset );
+                for (int y = band.firstRow; y < band.endRow; ++y) {
+                    rowStart[y] = offset + band.rowStart[ y - band.firstRow ];
+                }
+                const uint32_t bandRuns = band.runs.size();
+                for (uint32_t i = 0; i < bandRuns; ++i) {
+                    forest.set( offset + i, offset + band.find(i) );
+                }
+                band = BandRuns();
+            }
+        });
+
+        /// merge runs on seams
+        pool.parallelFor(nBands - 1, [&](const int begin, const int end) {
+            for (int b = begin; b < end; ++b) {
+                const int y = (int)( (long long)nRows * (b + 1) / nBands );
+                std::size_t prev = rowStart[y - 1];
+                const std::size_t prevEnd = rowStart[y];
+                for (std::size_t i = rowStart[y]; i < rowStart[y + 1]; ++i) {
+                    const RowRun& current = runs[i];
+                    while (prev < prevEnd && runs[prev].right < current.left) {
+                        ++prev;
+                    }
+                    for (std::size_t p = prev; p < prevEnd && runs[p].left <= current.right; ++p) {
+                        forest.unite( p, i );
+                    }
+                }
+            }
+        });
+
+        /// final labels
+        pool.parallelFor(nBands, [&](const int begin, const int end) {
+            const std::size_t first = offsets[begin];
+            const std::size_t last = offsets[end];
+            for (std::size_t i = first; i < last; ++i) {
+                labels[i] = forest.find(i);
+            }
+        });
+    }
+
+    long RunLabeling::findRun(const cv::Point& pixel) const {
+        if (pixel.y < 0 || pixel.y >= nRows) {
+            return -1;
+        }
+        /// runs of row are sorted, find last run starting at or before pixel
+        std::size_t first = rowStart[pixel.y];
+        std::size_t last = rowStart[pixel.y + 1];
+        while (first < last) {
+            const std::size_t middle = first + (last - first) / 2;
+            if (runs[middle].left <= pixel.x) {
+                first = middle + 1;
+            } else {
+                last = middle;
+            }
+        }
+        if (first == rowStart[pixel.y]) {
+            return -1;
+        }
+        const std::size_t index = first - 1;
+        if (pixel.x > runs[index].right) {
+            return -1;
+        }
+        return index;
+    }
+
+} /* namespace ias */
@@ -0,0 +1,276 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "ias/StripProcessor.h"
+
+#include <vector>
+
+#include "ias/Binarize.h"
+#include "ias/Profiler.h"
+#include "ias/RunLabeling.h"
+#include "ias/ThreadPool.h"
+
+
+namespace ias {
+
+    /// components of labeled strip, components touching strip border (or containing seed) are marked
+    struct StripComponents {
+        std::vector<uint32_t> runComponent;             /// component of each run
+        std::vector<int> boundaryIndex;                 /// index among marked components or -1
+        int boundaryCount;
+
+        StripComponents(const RunLabeling& labeling, const long seedRun): runComponent(), boundaryIndex(), boundaryCount(0) {
+            const std::size_t nRuns = labeling.size();
+            runComponent.resize( nRuns );
+            uint32_t nComponents = 0;
+            for (std::size_t i = 0; i < nRuns; ++i) {
+                const uint32_t label = labeling.runLabel(i);
+                runComponent[i] = (label == i) ? nComponents++ : runComponent[label];
+            }
+
+            std::vector<bool> marked( nComponents, false );
+            const int lastRow = labeling.rows() - 1;
+            for (std::size_t i = labeling.rowBegin(0); i < labeling.rowEnd(0); ++i) {
+                marked[ runComponent[i] ] = true;
+            }
+            for (std::size_t i = labeling.rowBegin(lastRow); i < labeling.rowEnd(lastRow); ++i) {
+                marked[ runComponent[i] ] = true;
+            }
+            if (seedRun >= 0) {
+                marked[ runComponent[seedRun] ] = true;
+            }
+
+            boundaryIndex.assign( nComponents, -1 );
+            for (uint32_t c = 0; c < nComponents; ++c) {
+                if (marked[c]) {
+                    boundaryIndex[c] = boundaryCount++;
+                }
+            }
+        }
+
+        int boundary(const std::size_t run) const {
+            return boundaryIndex[ runComponent[run] ];
+        }
+    };
+
+    /// union-find of global labels, smaller label is root
+    class GlobalLabels {
+        std::vector<uint32_t> parent;
+
+    public:
+
+        uint32_t size() const {
+            return parent.size();
+        }
+
+        uint32_t add() {
+            const uint32_t label = parent.size();
+            parent.push_back( label );
+            return label;
+        }
+
+        uint32_t find(uint32_t label) {
+            while (parent[label] != label) {
+                parent[label] = parent[ parent[label] ];
+                label = parent[label];
+            }
+            return label;
+        }
+
+        void unite(uint32_t a, uint32_t b) {
+            a = find(a);
+            b = find(b);
+            if (a < b) {
+                parent[b] = a;
+            } else if (b < a) {
+                parent[a] = b;
+            }
+        }
+    };
+
+
+    StripProcessor::StripProcessor(const int rowsPerStrip): stripRows( std::max(1, rowsPerStrip) ), file(), layout(), pipeline() {
+    }
+
+    bool StripProcessor::open(const std::string& imagePath) {
+        layout = ImageLayout();
+        if (file.open(imagePath) == false) {
+            return false;
+        }
+        if (layout.parse(file.data(), file.size()) == false) {
+            file.close();
+            return false;
+        }
+        return true;
+    }
+
+    void StripProcessor::addPerimeter(const int connectivity) {
+        /// region mask is binary, so Laplace filter gives the same result as Analysis::findPerimeter
+        pipeline.addStage( (connectivity == 4) ? RowPipeline::LAPLACE4 : RowPipeline::LAPLACE, 128 );
+    }
+
+    void StripProcessor::addSmoothPerimeter() {
+        pipeline.addStage( RowPipeline::ERODE );
+        pipeline.addStage( RowPipeline::DILATE );
+        pipeline.addStage( RowPipeline::DILATE );
+        pipeline.addStage( RowPipeline::ERODE );
+        pipeline.addStage( RowPipeline::GAUSSIAN_BLUR, 100 );
+        pipeline.addStage( RowPipeline::LAPLACE, 64 );
+    }
+
+    void StripProcessor::clearOperations() {
+        pipeline = RowPipeline();
+    }
+
+    void StripProcessor::binarizeStrip(const int firstRow, const cv::Vec3b& color, const uchar tolerance, cv::Mat& mask, cv::Mat& converted) const {
+        const int nCols = layout.width;
+        const uchar* pixels = file.data() + layout.offset;
+        const bool direct = (layout.format == ImageLayout::RAW && layout.channels == 3);
+        if (direct == false) {
+            converted.create( mask.rows, nCols, CV_8UC3 );
+        }
+
+        parallelRows(mask.rows, nCols, [&](const int begin, const int end) {
+            for (int y = begin; y < end; ++y) {
+                const uchar* row = pixels + (std::size_t)(firstRow + y) * layout.rowSize();
+                const cv::Vec3b* bgr = (const cv::Vec3b*)row;
+                if (direct == false) {
+                    layout.convertRow( row, converted.ptr<cv::Vec3b>(y) );
+                    bgr = converted.ptr<cv::Vec3b>(y);
+                }
+                binarizeRow( bgr, mask.ptr<uchar>(y), nCols, color, tolerance );
+            }
+        });
+    }
+
+    bool StripProcessor::findRegion(const cv::Point& seed, const cv::Vec3b& color, const uchar tolerance, const RowPipeline::RowSink& output) {
+        if (file.empty()) {
+            return false;
+        }
+        IAS_PROFILE_SCOPE("StripProcessor::findRegion", (uint64_t)layout.width * layout.height);
+
+        const int nRows = layout.height;
+        const int nCols = layout.width;
+        const int nStrips = (nRows + stripRows - 1) / stripRows;
+
+        cv::Mat mask;
+        cv::Mat converted;
+        RunLabeling labeling;
+        GlobalLabels global;
+        std::vector<uint32_t> firstLabel( nStrips, 0 );
+
+        /// first pass: join labels of components touching strip borders
+        std::vector<RowRun> previousRuns;
+        std::vector<uint32_t> previousLabels;
+        long seedLabel = -1;
+        for (int s = 0; s < nStrips; ++s) {
+            const int firstRow = s * stripRows;
+            const int rows = std::min(stripRows, nRows - firstRow);
+            mask.create( rows, nCols, CV_8UC1 );
+            binarizeStrip(firstRow, color, tolerance, mask, converted);
+            labeling.label(mask, 255);
+
+            const long seedRun = (seed.y >= firstRow && seed.y < firstRow + rows) ? labeling.findRun( cv::Point(seed.x, seed.y - firstRow) ) : -1;
+            const StripComponents components(labeling, seedRun);
+            firstLabel[s] = global.size();
+            for (int c = 0; c < components.boundaryCount; ++c) {
+                global.add();
+            }
+            if (seedRun >= 0) {
+                seedLabel = firstLabel[s] + components.boundary(seedRun);
+            }
+
+            /// join with last row of previous strip
+            std::size_t prev = 0;
+            for (std::size_t i = labeling.rowBegin(0); i < labeling.rowEnd(0); ++i) {
+                const RowRun& current = labeling.run(i);
+                while (prev < previousRuns.size() && previousRuns[prev].right < current.left) {
+                    ++prev;
+                }
+                for (std::size_t p = prev; p < previousRuns.size() && previousRuns[p].left <= current.right; ++p) {
+                    global.unite( previousLabels[p], firstLabel[s] + components.boundary(i) );
+                }
+            }
+
+            previousRuns.clear();
+            previousLabels.clear();
+            const int lastRow = rows - 1;
+            for (std::size_t i = labeling.rowBegin(lastRow); i < labeling.rowEnd(lastRow); ++i) {
+                previousRuns.push_back( labeling.run(i) );
+                previousLabels.push_back( firstLabel[s] + components.boundary(i) );
+            }
+        }
+
+        /// second pass: label strips again and write rows of region
+        const long seedRoot = (seedLabel < 0) ? -1 : (long)global.find(seedLabel);
+        pipeline.start(nCols, nRows, output);
+        cv::Mat region;
+        for (int s = 0; s < nStrips; ++s) {
+            const int firstRow = s * stripRows;
+            const int rows = std::min(stripRows, nRows - firstRow);
+            mask.create( rows, nCols, CV_8UC1 );
+            region = cv::Mat::zeros( rows, nCols, CV_8UC1 );
+
+            if (seedRoot >= 0) {
+                binarizeStrip(firstRow, color, tolerance, mask, converted);
+                labeling.label(mask, 255);
+
+                const long seedRun = (seed.y >= firstRow && seed.y < firstRow + rows) ? labeling.findRun( cv::Point(seed.x, seed.y - firstRow) ) : -1;
+                const StripComponents components(labeling, seedRun);
+                for (int y = 0; y < rows; ++y) {
+                    uchar* row = region.ptr<uchar>(y);
+                    for (std::size_t i = labeling.rowBegin(y); i < labeling.rowEnd(y); ++i) {
+                        const int boundary = components.boundary(i);
+                        if (boundary < 0)
+                            continue;
+                        if ( (long)global.find(firstLabel[s] + boundary) != seedRoot )
+                            continue;
+                        const RowRun& run = labeling.run(i);
+                        std::fill( row + run.left, row + run.right + 1, 255 );
+                    }
+                }
+            }
+
+            for (int y = 0; y < rows; ++y) {
+                pipeline.push( region.ptr<uchar>(y) );
+            }
+        }
+        return true;
+    }
+
+    bool StripProcessor::findRegion(const cv::Point& seed, const cv::Vec3b& color, const uchar tolerance, const std::string& outputPath) {
+        if (file.empty()) {
+            return false;
+        }
+
+        RowWriter writer;
+        if (writer.open(outputPath, layout.width, layout.height, 1) == false) {
+            return false;
+        }
+        findRegion(seed, color, tolerance, [&writer](const uchar* row) {
+            writer.write(row);
+        });
+        return writer.close();
+    }
+
+} /* namespace ias */
@@ -0,0 +1,188 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "ias/ThreadPool.h"
+
+#include <algorithm>
+
+
+namespace ias {
+
+    /// minimal number of pixels processed by one band
+    static const int MIN_BAND_PIXELS = 1 << 16;
+
+    /// set while thread executes body of loop
+    static thread_local bool insideLoop = false;
+
+
+    ThreadPool::ThreadPool(const std::size_t threads): workers(), threadsNum(1), mutex(), wakeUp(), finished(), loopMutex(),
+                                                       function(NULL), rangeSize(0), nBands(0), nextBand(0), active(0),
+                                                       generation(0), stopping(false), error()
+    {
+        start(threads);
+    }
+
+    ThreadPool::~ThreadPool() {
+        stop();
+    }
+
+    ThreadPool& ThreadPool::global() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    void ThreadPool::resize(std::size_t threads) {
+        if (threads < 1) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        std::lock_guard<std::mutex> loopLock(loopMutex);
+        if (threads == size()) {
+            return ;
+        }
+        stop();
+        start(threads);
+    }
+
+    void ThreadPool::start(const std::size_t threads) {
+        stopping = false;
+        for (std::size_t i = 1; i < threads; ++i) {
+            workers.push_back( std::thread(&ThreadPool::work, this) );
+        }
+        threadsNum = workers.size() + 1;
+    }
+
+    void ThreadPool::stop() {
+        threadsNum = 1;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeUp.notify_all();
+        for (std::size_t i = 0; i < workers.size(); ++i) {
+            workers[i].join();
+        }
+        workers.clear();
+    }
+
+    void ThreadPool::parallelFor(const int count, const BandFunction& body, const int grain) {
+        if (count < 1) {
+            return ;
+        }
+
+        const int maxBands = count / std::max(1, grain);
+        const int bands = std::min( (int)size(), maxBands );
+        if (bands < 2 || insideLoop) {
+            body(0, count);
+            return ;
+        }
+
+        std::unique_lock<std::mutex> loopLock(loopMutex, std::try_to_lock);
+        if (loopLock.owns_lock() == false) {
+            /// pool is busy with other loop
+            body(0, count);
+            return ;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            function = &body;
+            rangeSize = count;
+            nBands = bands;
+            nextBand = 0;
+            error = std::exception_ptr();
+            ++generation;
+        }
+        wakeUp.notify_all();
+
+        runBands(body, count, bands);
+
+        std::exception_ptr loopError;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            finished.wait(lock, [this]() { return active == 0; });
+            function = NULL;
+            loopError = error;
+        }
+
+        if (loopError) {
+            std::rethrow_exception(loopError);
+        }
+    }
+
+    void ThreadPool::work() {
+        unsigned long seen = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wakeUp.wait(lock, [this, &seen]() { return stopping || generation != seen; });
+            if (stopping) {
+                return ;
+            }
+            seen = generation;
+            if (function == NULL) {
+                /// loop already finished
+                continue;
+            }
+
+            const BandFunction* body = function;
+            const int loopCount = rangeSize;
+            const int loopBands = nBands;
+            ++active;
+            lock.unlock();
+
+            runBands(*body, loopCount, loopBands);
+
+            lock.lock();
+            --active;
+            if (active == 0) {
+                finished.notify_all();
+            }
+        }
+    }
+
+    void ThreadPool::runBands(const BandFunction& body, const int loopCount, const int loopBands) {
+        insideLoop = true;
+        while (true) {
+            const int band = nextBand.fetch_add(1);
+            if (band >= loopBands) {
+                break;
+            }
+            const int begin = (int)( (long long)loopCount * band / loopBands );
+            const int end = (int)( (long long)loopCount * (band + 1) / loopBands );
+            try {
+                body(begin, end);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+        insideLoop = false;
+    }
+
+    void parallelRows(const int nRows, const int nCols, const ThreadPool::BandFunction& body) {
+        const int grain = std::max(1, MIN_BAND_PIXELS / std::max(1, nCols));
+        ThreadPool::global().parallelFor(nRows, body, grain);
+    }
+
+} /* namespace ias */
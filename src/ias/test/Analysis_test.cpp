@@ -22,6 +22,11 @@
 ///
 
 #include "ias/Analysis.h"
+#include "ias/ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
 
 #include <boost/test/unit_test.hpp>
 
@@ -29,6 +34,18 @@
 using namespace ias;
 
 
+static bool sameMat(const cv::Mat& first, const cv::Mat& second) {
+    if (first.size() != second.size() || first.type() != second.type())
+        return false;
+    for (int y = 0; y < first.rows; ++y) {
+        const uchar* row = first.ptr<uchar>(y);
+        if (std::equal( row, row + first.cols * first.elemSize(), second.ptr<uchar>(y) ) == false)
+            return false;
+    }
+    return true;
+}
+
+
 BOOST_AUTO_TEST_SUITE( AnalysisSuite )
 
     BOOST_AUTO_TEST_CASE( loadImage_not_found ) {
@@ -136,6 +153,198 @@ BOOST_AUTO_TEST_SUITE( AnalysisSuite )
         BOOST_CHECK_EQUAL( region.at<uchar>(220, 220), 255 );       /// second red rectangle
     }
 
+    BOOST_AUTO_TEST_CASE( findRegion_threads ) {
+        Analysis object;
+
+        const bool loaded = object.loadImage("data/test1.png");
+        BOOST_REQUIRE_EQUAL( loaded, true );
+
+        object.findRegion( cv::Point(200, 200), cv::Vec3b(0, 0, 255), 20 );
+        const cv::Mat expected = object.result().clone();
+
+        BOOST_CHECK_EQUAL( object.parallelFillEnabled(), false );
+        object.setParallelFill(true);
+        ThreadPool::global().resize(3);
+        object.findRegion( cv::Point(200, 200), cv::Vec3b(0, 0, 255), 20 );
+        ThreadPool::global().resize(1);
+
+        const cv::Mat& region = object.result();
+        BOOST_REQUIRE_EQUAL( region.empty(), false );
+        for (int y = 0; y < region.rows; ++y) {
+            for (int x = 0; x < region.cols; ++x) {
+                BOOST_REQUIRE_EQUAL( region.at<uchar>(y, x), expected.at<uchar>(y, x) );
+            }
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE( findRegion_indexed ) {
+        Analysis object;
+
+        const bool loaded = object.loadImage("data/test1.png");
+        BOOST_REQUIRE_EQUAL( loaded, true );
+
+        object.findRegion( cv::Point(200, 200), cv::Vec3b(0, 0, 255), 20 );
+        const cv::Mat expected = object.result().clone();
+
+        object.indexRegions( cv::Vec3b(0, 0, 255), 20 );
+        BOOST_CHECK_EQUAL( object.regions().matches( cv::Vec3b(0, 0, 255), 20 ), true );
+        object.findRegion( cv::Point(200, 200), cv::Vec3b(0, 0, 255), 20 );
+
+        const cv::Mat& region = object.result();
+        BOOST_REQUIRE_EQUAL( region.empty(), false );
+        for (int y = 0; y < region.rows; ++y) {
+            for (int x = 0; x < region.cols; ++x) {
+                BOOST_REQUIRE_EQUAL( region.at<uchar>(y, x), expected.at<uchar>(y, x) );
+            }
+        }
+
+        object.loadImage("data/test1.png");
+        BOOST_CHECK_EQUAL( object.regions().empty(), true );
+    }
+
+    BOOST_AUTO_TEST_CASE( regionStats_valid ) {
+        Analysis object;
+
+        const bool loaded = object.loadImage("data/test1.png");
+        BOOST_REQUIRE_EQUAL( loaded, true );
+
+        const RegionStats stats = object.regionStats( cv::Point(200, 200), cv::Vec3b(0, 0, 255), 20 );
+        BOOST_CHECK_EQUAL( object.result().empty(), true );
+
+        object.findRegion( cv::Point(200, 200), cv::Vec3b(0, 0, 255), 20 );
+        const cv::Mat region = object.result().clone();
+        std::size_t area = 0;
+        double sumX = 0.0;
+        double sumY = 0.0;
+        cv::Rect box(region.cols, region.rows, 0, 0);
+        int maxX = -1;
+        int maxY = -1;
+        for (int y = 0; y < region.rows; ++y) {
+            for (int x = 0; x < region.cols; ++x) {
+                if (region.at<uchar>(y, x) == 0)
+                    continue;
+                ++area;
+                sumX += x;
+                sumY += y;
+                box.x = std::min(box.x, x);
+                box.y = std::min(box.y, y);
+                maxX = std::max(maxX, x);
+                maxY = std::max(maxY, y);
+            }
+        }
+        BOOST_REQUIRE_GT( area, 0 );
+        BOOST_CHECK_EQUAL( stats.area, area );
+        BOOST_CHECK_EQUAL( stats.boundingBox, cv::Rect(box.x, box.y, maxX - box.x + 1, maxY - box.y + 1) );
+        BOOST_CHECK_CLOSE( stats.centroid.x, sumX / area, 0.0001 );
+        BOOST_CHECK_CLOSE( stats.centroid.y, sumY / area, 0.0001 );
+        BOOST_CHECK_EQUAL( stats.touchesBorder, false );
+
+        object.findPerimeter();
+        const cv::Mat& perimeter = object.result();
+        std::size_t perimeterArea = 0;
+        for (int y = 0; y < perimeter.rows; ++y) {
+            for (int x = 0; x < perimeter.cols; ++x) {
+                if (perimeter.at<uchar>(y, x) != 0)
+                    ++perimeterArea;
+            }
+        }
+        BOOST_CHECK_EQUAL( stats.perimeter, perimeterArea );
+
+        /// background touches border
+        BOOST_CHECK_EQUAL( object.regionStats( cv::Point(0, 0), object.color(0, 0), 20 ).touchesBorder, true );
+    }
+
+    BOOST_AUTO_TEST_CASE( findRegion_cached ) {
+        Analysis object;
+        object.setMaskCacheBudget( 16 * 1024 * 1024 );
+
+        const bool loaded = object.loadImage("data/test1.png");
+        BOOST_REQUIRE_EQUAL( loaded, true );
+
+        object.findRegion( cv::Point(0, 30), cv::Vec3b(0, 0, 255), 20 );
+        const cv::Mat first = object.result().clone();
+        object.findRegion( cv::Point(200, 200), cv::Vec3b(0, 0, 255), 20 );
+        BOOST_CHECK_EQUAL( object.maskCache().misses(), 1 );
+        BOOST_CHECK_EQUAL( object.maskCache().hits(), 1 );
+
+        const cv::Mat& region = object.result();
+        BOOST_REQUIRE_EQUAL( region.empty(), false );
+        BOOST_CHECK_EQUAL( region.at<uchar>(40, 10), 0 );           /// first red rectangle
+        BOOST_CHECK_EQUAL( region.at<uchar>(220, 220), 255 );       /// second red rectangle
+        BOOST_CHECK_EQUAL( first.at<uchar>(40, 10), 255 );
+        BOOST_CHECK_EQUAL( first.at<uchar>(220, 220), 0 );
+
+        object.loadImage("data/test1.png");
+        BOOST_CHECK_EQUAL( object.maskCache().size(), 0 );
+    }
+
+
+    BOOST_AUTO_TEST_CASE( region_const_query ) {
+        Analysis object;
+
+        const bool loaded = object.loadImage("data/test1.png");
+        BOOST_REQUIRE_EQUAL( loaded, true );
+
+        object.findRegion( cv::Point(0, 30), cv::Vec3b(0, 0, 255), 20 );
+        const cv::Mat expectedRegion = object.result().clone();
+        object.findPerimeter();
+        const cv::Mat expectedPerimeter = object.result().clone();
+        object.findRegion( cv::Point(0, 30), cv::Vec3b(0, 0, 255), 20 );
+        object.findSmoothPerimeter();
+        const cv::Mat expectedSmooth = object.result().clone();
+
+        const Analysis& query = object;
+        const MaskC1 region = query.region( cv::Point(0, 30), cv::Vec3b(0, 0, 255), 20 );
+        BOOST_REQUIRE_EQUAL( region.empty(), false );
+        BOOST_CHECK_EQUAL( region.get(10, 40), 255 );
+        BOOST_CHECK( sameMat( *region, expectedRegion ) );
+        BOOST_CHECK( sameMat( *query.perimeter( *region ), expectedPerimeter ) );
+        BOOST_CHECK( sameMat( *query.smoothPerimeter( *region ), expectedSmooth ) );
+
+        /// last result is not changed by queries
+        BOOST_CHECK( sameMat( object.result(), expectedSmooth ) );
+
+        BOOST_CHECK_EQUAL( query.perimeter( cv::Mat() ).empty(), true );
+        BOOST_CHECK_EQUAL( Analysis().region( cv::Point(0, 30), cv::Vec3b(0, 0, 255), 20 ).empty(), true );
+    }
+
+    BOOST_AUTO_TEST_CASE( region_concurrent_queries ) {
+        Analysis object;
+        object.setMaskCacheBudget( 16 * 1024 * 1024 );
+
+        const bool loaded = object.loadImage("data/test1.png");
+        BOOST_REQUIRE_EQUAL( loaded, true );
+
+        const cv::Point seeds[] = { cv::Point(0, 30), cv::Point(200, 200) };
+        const cv::Vec3b colors[] = { cv::Vec3b(0, 0, 255), cv::Vec3b(0, 0, 249) };
+        cv::Mat expected[2];
+        for (int i = 0; i < 2; ++i) {
+            object.findRegion( seeds[i], colors[i], 20 );
+            BOOST_REQUIRE_EQUAL( cv::countNonZero( object.result() ) > 0, true );
+            object.findPerimeter();
+            expected[i] = object.result().clone();
+        }
+
+        const Analysis& query = object;
+        std::atomic<int> failures(0);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.push_back( std::thread( [&, t]() {
+                for (int n = 0; n < 20; ++n) {
+                    const int i = (t + n) % 2;
+                    const MaskC1 region = query.region( seeds[i], colors[i], 20 );
+                    if (sameMat( *query.perimeter( *region ), expected[i] ) == false)
+                        ++failures;
+                }
+            }) );
+        }
+        for (std::size_t t = 0; t < threads.size(); ++t) {
+            threads[t].join();
+        }
+
+        BOOST_CHECK_EQUAL( failures.load(), 0 );
+        BOOST_CHECK_EQUAL( object.maskCache().size(), 2 );
+    }
 
     BOOST_AUTO_TEST_CASE( findPerimeter_invalid_image ) {
         Analysis object;
@@ -0,0 +1,91 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "ias/AsyncWriter.h"
+#include "ias/BufferPool.h"
+#include "ias/ImageIO.h"
+
+#include <cstdio>
+
+#include <boost/test/unit_test.hpp>
+
+
+using namespace ias;
+
+
+BOOST_AUTO_TEST_SUITE( AsyncWriterSuite )
+
+    BOOST_AUTO_TEST_CASE( write_copy ) {
+        cv::Mat mask = cv::Mat::zeros( 4, 5, CV_8UC1 );
+
+        AsyncWriter writer(1);
+        for (int i = 0; i < 3; ++i) {
+            mask.at<uchar>(0, i) = 255;
+            writer.write(mask, "asyncwriter_test" + std::to_string(i) + ".pgm", -1, true);
+        }
+        /// matrix is copied, so modification does not change queued images
+        mask.setTo( cv::Scalar(0) );
+        BOOST_CHECK_EQUAL( writer.close(), 0 );
+
+        for (int i = 0; i < 3; ++i) {
+            const std::string path = "asyncwriter_test" + std::to_string(i) + ".pgm";
+            ImageFile file;
+            BOOST_REQUIRE_EQUAL( file.load(path), true );
+            BOOST_CHECK_EQUAL( file.image().at<cv::Vec3b>(0, i)[0], 255 );
+            BOOST_CHECK_EQUAL( file.image().at<cv::Vec3b>(0, i + 1)[0], 0 );
+            std::remove( path.c_str() );
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE( write_shared ) {
+        cv::Mat mask = cv::Mat::zeros( 4, 5, CV_8UC1 );
+        mask.at<uchar>(1, 2) = 255;
+
+        AsyncWriter writer;
+        writer.write(mask, "asyncwriter_test.pgm");
+        BOOST_CHECK_EQUAL( writer.close(), 0 );
+
+        /// data is not copied, queued reference is dropped after storing, so buffer can be pooled again
+        BufferPool pool;
+        BOOST_CHECK_EQUAL( pool.release(mask), true );
+
+        ImageFile file;
+        BOOST_REQUIRE_EQUAL( file.load("asyncwriter_test.pgm"), true );
+        BOOST_CHECK_EQUAL( file.image().at<cv::Vec3b>(1, 2)[0], 255 );
+        std::remove( "asyncwriter_test.pgm" );
+    }
+
+    BOOST_AUTO_TEST_CASE( write_failed ) {
+        AsyncWriter writer;
+        writer.write(cv::Mat::zeros( 2, 2, CV_8UC1 ), "not_existing_dir/asyncwriter_test.raw");
+        writer.write(cv::Mat(), "asyncwriter_test.raw");
+        /// encoder of unknown format throws
+        writer.write(cv::Mat::zeros( 2, 2, CV_8UC1 ), "asyncwriter_test.xyz");
+        BOOST_CHECK_EQUAL( writer.close(), 3 );
+
+        /// closed writer
+        writer.write(cv::Mat::zeros( 2, 2, CV_8UC1 ), "asyncwriter_test.raw");
+        BOOST_CHECK_EQUAL( writer.close(), 4 );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,150 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "ias/BitMask.h"
+#include "ias/MaskC1.h"
+#include "ias/Kernels.h"
+
+#include <boost/test/unit_test.hpp>
+
+
+using namespace ias;
+
+
+BOOST_AUTO_TEST_SUITE( BitMaskSuite )
+
+    BOOST_AUTO_TEST_CASE( empty_mask ) {
+        BitMask mask;
+
+        BOOST_CHECK_EQUAL( mask.empty(), true );
+        BOOST_CHECK_EQUAL( mask.toMat().empty(), true );
+    }
+
+    BOOST_AUTO_TEST_CASE( get_set ) {
+        BitMask mask(130, 2);
+        mask.set(0, 0, 255);
+        mask.set(129, 1, 127);
+
+        BOOST_CHECK_EQUAL( mask.get(0, 0), 255 );
+        BOOST_CHECK_EQUAL( mask.get(129, 1), 255 );
+        BOOST_CHECK_EQUAL( mask.get(64, 1), 0 );
+        BOOST_CHECK_EQUAL( mask.count(), 2 );
+
+        mask.set(0, 0, 0);
+        BOOST_CHECK_EQUAL( mask.get(0, 0), 0 );
+
+        mask.setRun(0, 3, 3);
+        mask.setRun(0, 60, 129);
+        BOOST_CHECK_EQUAL( mask.count(), 72 );
+        BOOST_CHECK_EQUAL( mask.get(2, 0), 0 );
+        BOOST_CHECK_EQUAL( mask.get(3, 0), 255 );
+        BOOST_CHECK_EQUAL( mask.get(59, 0), 0 );
+        BOOST_CHECK_EQUAL( mask.get(60, 0), 255 );
+        BOOST_CHECK_EQUAL( mask.get(129, 0), 255 );
+    }
+
+    BOOST_AUTO_TEST_CASE( load_store ) {
+        cv::Mat matrix = cv::Mat::zeros( 3, 70, CV_8UC1 );
+        matrix.at<uchar>(1, 65) = 255;
+        matrix.at<uchar>(2, 3) = 255;
+
+        BitMask mask;
+        BOOST_CHECK_EQUAL( mask.load(matrix), true );
+
+        const cv::Mat stored = mask.toMat();
+        BOOST_REQUIRE_EQUAL( stored.rows, 3 );
+        BOOST_REQUIRE_EQUAL( stored.cols, 70 );
+        BOOST_CHECK_EQUAL( stored.at<uchar>(1, 65), 255 );
+        BOOST_CHECK_EQUAL( stored.at<uchar>(2, 3), 255 );
+        BOOST_CHECK_EQUAL( cv::countNonZero(stored), 2 );
+
+        matrix.at<uchar>(0, 0) = 100;
+        BOOST_CHECK_EQUAL( mask.load(matrix), false );
+    }
+
+    BOOST_AUTO_TEST_CASE( changeColor_invert ) {
+        BitMask mask(70, 2);
+
+        mask.changeColor(0, 255);
+        BOOST_CHECK_EQUAL( mask.count(), 140 );
+
+        mask.changeColor(255, 0);
+        BOOST_CHECK_EQUAL( mask.count(), 0 );
+    }
+
+    BOOST_AUTO_TEST_CASE( morphology_as_MaskC1 ) {
+        cv::Mat matrix = cv::Mat::zeros( 20, 150, CV_8UC1 );
+        for (int y = 0; y < matrix.rows; ++y) {
+            for (int x = 0; x < matrix.cols; ++x) {
+                if ( (x * 7 + y * 13) % 11 < 6 )
+                    matrix.at<uchar>(y, x) = 255;
+            }
+        }
+
+        BitMask bits(matrix);
+        MaskC1 mask( matrix.clone() );
+
+        bits.dilate( cv::Size(5, 3) );
+        mask.dilate( cv::Size(5, 3) );
+        bits.erode(3, 2);
+        mask.erode(3, 2);
+
+        const cv::Mat result = bits.toMat();
+        for (int y = 0; y < matrix.rows; ++y) {
+            for (int x = 0; x < matrix.cols; ++x) {
+                BOOST_CHECK_EQUAL( result.at<uchar>(y, x), mask.get(x, y) );
+            }
+        }
+    }
+
+    template<typename Kernel>
+    static void checkPerimeter(const int connectivity) {
+        cv::Mat matrix = cv::Mat::zeros( 12, 140, CV_8UC1 );
+        for (int y = 0; y < matrix.rows; ++y) {
+            for (int x = 0; x < matrix.cols; ++x) {
+                if ( (x / 5 + y / 3) % 3 != 0 )
+                    matrix.at<uchar>(y, x) = 255;
+            }
+        }
+
+        BitMask bits(matrix);
+        bits.perimeter(connectivity);
+
+        MaskC1 expected( matrix.clone() );
+        expected.applyFilter<Kernel>();
+        expected.threshold(128);
+
+        const cv::Mat result = bits.toMat();
+        for (int y = 0; y < matrix.rows; ++y) {
+            for (int x = 0; x < matrix.cols; ++x) {
+                BOOST_CHECK_EQUAL( result.at<uchar>(y, x), expected.get(x, y) );
+            }
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE( perimeter_as_Laplace ) {
+        checkPerimeter<LaplaceKernel>(8);
+        checkPerimeter<Laplace4Kernel>(4);
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
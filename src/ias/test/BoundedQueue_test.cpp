@@ -0,0 +1,80 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "ias/BoundedQueue.h"
+
+#include <thread>
+
+#include <boost/test/unit_test.hpp>
+
+
+using namespace ias;
+
+
+BOOST_AUTO_TEST_SUITE( BoundedQueueSuite )
+
+    BOOST_AUTO_TEST_CASE( fifo_order ) {
+        BoundedQueue<int> queue(3);
+        queue.push(1);
+        queue.push(2);
+        BOOST_CHECK_EQUAL( queue.size(), 2 );
+
+        int item = 0;
+        BOOST_CHECK_EQUAL( queue.pop(item), true );
+        BOOST_CHECK_EQUAL( item, 1 );
+        BOOST_CHECK_EQUAL( queue.pop(item), true );
+        BOOST_CHECK_EQUAL( item, 2 );
+    }
+
+    BOOST_AUTO_TEST_CASE( close_drains ) {
+        BoundedQueue<int> queue(2);
+        queue.push(5);
+        queue.close();
+
+        BOOST_CHECK_EQUAL( queue.push(6), false );
+        int item = 0;
+        BOOST_CHECK_EQUAL( queue.pop(item), true );
+        BOOST_CHECK_EQUAL( item, 5 );
+        BOOST_CHECK_EQUAL( queue.pop(item), false );
+    }
+
+    BOOST_AUTO_TEST_CASE( producer_consumer ) {
+        BoundedQueue<int> queue(2);
+        std::thread producer([&queue]() {
+            for (int i = 0; i < 1000; ++i) {
+                queue.push(i);
+            }
+            queue.close();
+        });
+
+        int expected = 0;
+        int item = 0;
+        while (queue.pop(item)) {
+            BOOST_REQUIRE_EQUAL( item, expected );
+            ++expected;
+        }
+        producer.join();
+        BOOST_CHECK_EQUAL( expected, 1000 );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,163 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include "ias/BufferPool.h"
+
+#include <algorithm>
+
+#include <boost/test/unit_test.hpp>
+
+#include "ias/Analysis.h"
+#include "ias/MaskC1.h"
+
+
+using namespace ias;
+
+
+BOOST_AUTO_TEST_SUITE( BufferPoolSuite )
+
+    BOOST_AUTO_TEST_CASE( reuse_buffer ) {
+        BufferPool pool(1000);
+        cv::Mat first = pool.acquire(4, 5, CV_8UC1);
+        BOOST_CHECK_EQUAL( pool.allocations(), 1 );
+        const uchar* data = first.data;
+
+        BOOST_CHECK_EQUAL( pool.release(first), true );
+        BOOST_CHECK_EQUAL( first.empty(), true );
+        BOOST_CHECK_EQUAL( pool.size(), 1 );
+        BOOST_CHECK_EQUAL( pool.bytes(), 20 );
+
+        /// other size or type is allocated
+        cv::Mat other = pool.acquire(5, 4, CV_8UC1);
+        cv::Mat color = pool.acquire(4, 5, CV_8UC3);
+        BOOST_CHECK_EQUAL( pool.allocations(), 3 );
+
+        cv::Mat second = pool.acquire(4, 5, CV_8UC1);
+        BOOST_CHECK( second.data == data );
+        BOOST_CHECK_EQUAL( pool.acquires(), 4 );
+        BOOST_CHECK_EQUAL( pool.allocations(), 3 );
+        BOOST_CHECK_EQUAL( pool.size(), 0 );
+        BOOST_CHECK_EQUAL( pool.bytes(), 0 );
+    }
+
+    BOOST_AUTO_TEST_CASE( shared_not_pooled ) {
+        BufferPool pool(1000);
+        cv::Mat matrix = pool.acquire(4, 5, CV_8UC1);
+        const cv::Mat copy = matrix;
+        BOOST_CHECK_EQUAL( BufferPool::exclusive(matrix), false );
+        BOOST_CHECK_EQUAL( pool.release(matrix), false );
+        BOOST_CHECK_EQUAL( matrix.empty(), true );
+        BOOST_CHECK_EQUAL( pool.size(), 0 );
+
+        /// region of interest and user data
+        cv::Mat parent( 4, 5, CV_8UC1 );
+        cv::Mat roi( parent, cv::Rect(1, 1, 2, 2) );
+        BOOST_CHECK_EQUAL( pool.release(roi), false );
+        uchar data[20];
+        cv::Mat user( 4, 5, CV_8UC1, data );
+        BOOST_CHECK_EQUAL( pool.release(user), false );
+        BOOST_CHECK_EQUAL( pool.releases(), 0 );
+    }
+
+    BOOST_AUTO_TEST_CASE( budget ) {
+        BufferPool pool(50);
+        cv::Mat big( 10, 10, CV_8UC1 );
+        BOOST_CHECK_EQUAL( pool.release(big), false );
+
+        cv::Mat first( 4, 5, CV_8UC1 );
+        cv::Mat second( 5, 4, CV_8UC1 );
+        cv::Mat third( 2, 10, CV_8UC1 );
+        pool.release(first);
+        pool.release(second);
+        pool.release(third);
+
+        /// oldest buffer is freed
+        BOOST_CHECK_EQUAL( pool.size(), 2 );
+        BOOST_CHECK_EQUAL( pool.bytes(), 40 );
+        pool.acquire(4, 5, CV_8UC1);
+        BOOST_CHECK_EQUAL( pool.allocations(), 1 );
+
+        pool.setBudget(0);
+        BOOST_CHECK_EQUAL( pool.size(), 0 );
+        cv::Mat fourth( 2, 2, CV_8UC1 );
+        BOOST_CHECK_EQUAL( pool.release(fourth), false );
+    }
+
+    BOOST_AUTO_TEST_CASE( mask_steady_state ) {
+        BufferPool& pool = BufferPool::global();
+        pool.clear();
+
+        cv::Mat image = cv::Mat::zeros( 30, 40, CV_8UC3 );
+        cv::Mat( image, cv::Rect(10, 10, 10, 10) ).setTo( cv::Scalar(0, 0, 255) );
+
+        Analysis object;
+        object.setImage(image);
+
+        /// first request fills the pool
+        object.findRegion(cv::Point(15, 15), cv::Vec3b(0, 0, 255), 0);
+        object.findSmoothPerimeter();
+        const cv::Mat expected = object.result().clone();
+
+        pool.resetStats();
+        for (int i = 0; i < 5; ++i) {
+            object.findRegion(cv::Point(15, 15), cv::Vec3b(0, 0, 255), 0);
+            object.findSmoothPerimeter();
+        }
+        BOOST_CHECK( pool.acquires() > 0 );
+        BOOST_CHECK_EQUAL( pool.allocations(), 0 );
+
+        const cv::Mat& result = object.result();
+        BOOST_CHECK( std::equal( result.datastart, result.dataend, expected.datastart ) );
+
+        MaskC1 mask( object.result().clone() );
+        mask.dilate(3);
+        pool.resetStats();
+        for (int i = 0; i < 5; ++i) {
+            mask.dilate(3);
+            mask.erode(3);
+        }
+        BOOST_CHECK_EQUAL( pool.allocations(), 0 );
+        pool.clear();
+    }
+
+    BOOST_AUTO_TEST_CASE( shared_mask_kept ) {
+        BufferPool& pool = BufferPool::global();
+        pool.clear();
+
+        cv::Mat data = cv::Mat::zeros( 10, 10, CV_8UC1 );
+        data.at<uchar>(5, 5) = 255;
+        const cv::Mat shared = data;
+
+        MaskC1 mask(data);
+        mask.dilate(3);
+
+        /// data of shared matrix is not reused
+        for (std::size_t i = pool.size(); i > 0; --i) {
+            BOOST_CHECK( pool.acquire(10, 10, CV_8UC1).data != shared.data );
+        }
+        BOOST_CHECK_EQUAL( shared.at<uchar>(4, 4), 0 );
+        BOOST_CHECK_EQUAL( mask.get(4, 4), 255 );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
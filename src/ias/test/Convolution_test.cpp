@@ -0,0 +1,94 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "ias/Convolution.h"
+
+#include <boost/test/unit_test.hpp>
+
+
+using namespace ias;
+
+
+BOOST_AUTO_TEST_SUITE( ConvolutionSuite )
+
+    BOOST_AUTO_TEST_CASE( detect_integer ) {
+        const Convolution ones( cv::Mat::ones( 3, 3, CV_64F ) );
+        BOOST_CHECK_EQUAL( ones.isInteger(), true );
+
+        const Convolution gauss( cv::Mat::ones( 3, 3, CV_64F ) / 16 );
+        BOOST_CHECK_EQUAL( gauss.isInteger(), true );
+
+        const Convolution box( cv::Mat::ones( 3, 3, CV_64F ) / 9 );
+        BOOST_CHECK_EQUAL( box.isInteger(), false );
+    }
+
+    BOOST_AUTO_TEST_CASE( detect_separable ) {
+        cv::Mat gauss = cv::Mat::zeros( 3, 3, CV_64F );
+        gauss.at<double>(0,0) = 1;
+        gauss.at<double>(0,1) = 2;
+        gauss.at<double>(0,2) = 1;
+        gauss.at<double>(1,0) = 2;
+        gauss.at<double>(1,1) = 4;
+        gauss.at<double>(1,2) = 2;
+        gauss.at<double>(2,0) = 1;
+        gauss.at<double>(2,1) = 2;
+        gauss.at<double>(2,2) = 1;
+        gauss /= 16;
+        BOOST_CHECK_EQUAL( Convolution(gauss).isSeparable(), true );
+
+        cv::Mat laplace = cv::Mat::ones( 3, 3, CV_64F ) * -1;
+        laplace.at<double>(1,1) = 8;
+        BOOST_CHECK_EQUAL( Convolution(laplace).isSeparable(), false );
+    }
+
+    BOOST_AUTO_TEST_CASE( apply_separable_border ) {
+        cv::Mat source = cv::Mat::zeros( 3, 4, CV_8UC1 );
+        source.at<uchar>(0, 0) = 255;
+
+        cv::Mat target;
+        const Convolution convolution( cv::Mat::ones( 3, 3, CV_64F ) / 4 );
+        convolution.apply(source, target);
+
+        BOOST_REQUIRE_EQUAL( target.rows, 3 );
+        BOOST_REQUIRE_EQUAL( target.cols, 4 );
+        BOOST_CHECK_EQUAL( target.at<uchar>(0, 0), 63 );
+        BOOST_CHECK_EQUAL( target.at<uchar>(1, 1), 63 );
+        BOOST_CHECK_EQUAL( target.at<uchar>(2, 2), 0 );
+        BOOST_CHECK_EQUAL( target.at<uchar>(0, 3), 0 );
+    }
+
+    BOOST_AUTO_TEST_CASE( apply_saturate ) {
+        cv::Mat source = cv::Mat::zeros( 3, 3, CV_8UC1 );
+        source.at<uchar>(1, 1) = 200;
+
+        cv::Mat laplace = cv::Mat::ones( 3, 3, CV_64F ) * -1;
+        laplace.at<double>(1,1) = 8;
+
+        cv::Mat target;
+        Convolution(laplace).apply(source, target);
+
+        BOOST_CHECK_EQUAL( target.at<uchar>(1, 1), 255 );
+        BOOST_CHECK_EQUAL( target.at<uchar>(0, 0), 0 );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,201 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "ias/ImageIO.h"
+
+#include <cstdio>
+#include <fstream>
+
+#include <boost/test/unit_test.hpp>
+
+
+using namespace ias;
+
+
+BOOST_AUTO_TEST_SUITE( ImageIOSuite )
+
+    static cv::Mat patternImage() {
+        cv::Mat image( 5, 7, CV_8UC3 );
+        for (int y = 0; y < image.rows; ++y) {
+            for (int x = 0; x < image.cols; ++x) {
+                image.at<cv::Vec3b>(y, x) = cv::Vec3b( x * 30, y * 40, x + y );
+            }
+        }
+        return image;
+    }
+
+    static void checkEqual(const cv::Mat& image, const cv::Mat& expected) {
+        BOOST_REQUIRE_EQUAL( image.rows, expected.rows );
+        BOOST_REQUIRE_EQUAL( image.cols, expected.cols );
+        BOOST_REQUIRE_EQUAL( image.type(), CV_8UC3 );
+        for (int y = 0; y < image.rows; ++y) {
+            for (int x = 0; x < image.cols; ++x) {
+                BOOST_CHECK_EQUAL( image.at<cv::Vec3b>(y, x), expected.at<cv::Vec3b>(y, x) );
+            }
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE( load_not_found ) {
+        ImageFile file;
+        BOOST_CHECK_EQUAL( file.load("not_found.raw"), false );
+        BOOST_CHECK_EQUAL( file.empty(), true );
+    }
+
+    BOOST_AUTO_TEST_CASE( raw_mapped ) {
+        const cv::Mat image = patternImage();
+        BOOST_REQUIRE_EQUAL( storeImage(image, "imageio_test.raw"), true );
+
+        ImageFile file;
+        BOOST_REQUIRE_EQUAL( file.load("imageio_test.raw"), true );
+        BOOST_CHECK_EQUAL( file.mapped(), true );
+        checkEqual( file.image(), image );
+
+        /// mapping outlives source object
+        const ImageFile copy = file;
+        file.release();
+        checkEqual( copy.image(), image );
+
+        std::remove("imageio_test.raw");
+    }
+
+    BOOST_AUTO_TEST_CASE( ppm_converted ) {
+        const cv::Mat image = patternImage();
+        BOOST_REQUIRE_EQUAL( storeImage(image, "imageio_test.ppm"), true );
+
+        ImageFile file;
+        BOOST_REQUIRE_EQUAL( file.load("imageio_test.ppm"), true );
+        BOOST_CHECK_EQUAL( file.mapped(), false );
+        checkEqual( file.image(), image );
+
+        std::remove("imageio_test.ppm");
+    }
+
+    BOOST_AUTO_TEST_CASE( pgm_mask ) {
+        cv::Mat mask = cv::Mat::zeros( 3, 4, CV_8UC1 );
+        mask.at<uchar>(1, 2) = 255;
+        BOOST_REQUIRE_EQUAL( storeImage(mask, "imageio_test.pgm"), true );
+
+        ImageFile file;
+        BOOST_REQUIRE_EQUAL( file.load("imageio_test.pgm"), true );
+        const cv::Mat& image = file.image();
+        BOOST_REQUIRE_EQUAL( image.rows, 3 );
+        BOOST_REQUIRE_EQUAL( image.cols, 4 );
+        BOOST_CHECK_EQUAL( image.at<cv::Vec3b>(1, 2), cv::Vec3b(255, 255, 255) );
+        BOOST_CHECK_EQUAL( image.at<cv::Vec3b>(0, 0), cv::Vec3b(0, 0, 0) );
+
+        std::remove("imageio_test.pgm");
+    }
+
+    BOOST_AUTO_TEST_CASE( layout_pnm_comment ) {
+        const std::string data = "P6\n# comment\n2 1\n255\n\x01\x02\x03\x04\x05\x06";
+
+        ImageLayout layout;
+        BOOST_REQUIRE_EQUAL( layout.parse( (const uchar*)data.data(), data.size() ), true );
+        BOOST_CHECK_EQUAL( layout.format, ImageLayout::PPM );
+        BOOST_CHECK_EQUAL( layout.width, 2 );
+        BOOST_CHECK_EQUAL( layout.height, 1 );
+        BOOST_CHECK_EQUAL( layout.offset, data.size() - 6 );
+
+        cv::Vec3b row[2];
+        layout.convertRow( (const uchar*)data.data() + layout.offset, row );
+        BOOST_CHECK_EQUAL( row[0], cv::Vec3b(3, 2, 1) );
+
+        /// data too short
+        BOOST_CHECK_EQUAL( layout.parse( (const uchar*)data.data(), data.size() - 1 ), false );
+    }
+
+    BOOST_AUTO_TEST_CASE( pgm_max_value_scaled ) {
+        const std::string data( "P5\n3 1\n15\n\x00\x07\x0F", 13 );
+        {
+            std::ofstream output( "imageio_test.pgm", std::ios::binary );
+            output.write( data.data(), data.size() );
+        }
+
+        ImageFile file;
+        BOOST_REQUIRE_EQUAL( file.load("imageio_test.pgm"), true );
+        const cv::Mat& image = file.image();
+        BOOST_REQUIRE_EQUAL( image.cols, 3 );
+        BOOST_CHECK_EQUAL( image.at<cv::Vec3b>(0, 0), cv::Vec3b(0, 0, 0) );
+        BOOST_CHECK_EQUAL( image.at<cv::Vec3b>(0, 1), cv::Vec3b(119, 119, 119) );
+        BOOST_CHECK_EQUAL( image.at<cv::Vec3b>(0, 2), cv::Vec3b(255, 255, 255) );
+
+        std::remove("imageio_test.pgm");
+
+        const std::string bilevel( "P6\n1 1\n1\n\x01\x00\x01", 12 );
+        ImageLayout layout;
+        BOOST_REQUIRE_EQUAL( layout.parse( (const uchar*)bilevel.data(), bilevel.size() ), true );
+        BOOST_CHECK_EQUAL( layout.maxValue, 1 );
+        cv::Vec3b row[1];
+        layout.convertRow( (const uchar*)bilevel.data() + layout.offset, row );
+        BOOST_CHECK_EQUAL( row[0], cv::Vec3b(255, 0, 255) );
+    }
+
+    BOOST_AUTO_TEST_CASE( row_writer_incomplete ) {
+        const uchar row[4] = {0, 255, 0, 255};
+
+        RowWriter writer;
+        BOOST_REQUIRE_EQUAL( writer.open("imageio_test.pgm", 4, 2, 1), true );
+        writer.write( row );
+        BOOST_CHECK_EQUAL( writer.close(), false );
+
+        BOOST_REQUIRE_EQUAL( writer.open("imageio_test.pgm", 4, 2, 1), true );
+        writer.write( row );
+        writer.write( row );
+        BOOST_CHECK_EQUAL( writer.close(), true );
+
+        ImageFile file;
+        BOOST_REQUIRE_EQUAL( file.load("imageio_test.pgm"), true );
+        BOOST_CHECK_EQUAL( file.image().at<cv::Vec3b>(1, 3), cv::Vec3b(255, 255, 255) );
+
+        /// PGM requires single channel
+        BOOST_CHECK_EQUAL( writer.open("imageio_test.pgm", 4, 2, 3), false );
+
+        std::remove("imageio_test.pgm");
+    }
+
+    BOOST_AUTO_TEST_CASE( mask_formats ) {
+        cv::Mat mask = cv::Mat::zeros( 3, 11, CV_8UC1 );
+        mask.at<uchar>(0, 0) = 255;
+        mask.at<uchar>(1, 9) = 255;
+        mask.at<uchar>(2, 10) = 255;
+
+        const char* paths[] = { "imageio_test.pbm", "imageio_test.rle" };
+        for (const char* path: paths) {
+            BOOST_REQUIRE_EQUAL( storeImage(mask, path), true );
+
+            ImageFile file;
+            BOOST_REQUIRE_EQUAL( file.load(path), true );
+            const cv::Mat& image = file.image();
+            BOOST_REQUIRE_EQUAL( image.rows, 3 );
+            BOOST_REQUIRE_EQUAL( image.cols, 11 );
+            for (int y = 0; y < mask.rows; ++y) {
+                for (int x = 0; x < mask.cols; ++x) {
+                    const uchar value = mask.at<uchar>(y, x);
+                    BOOST_CHECK_EQUAL( image.at<cv::Vec3b>(y, x), cv::Vec3b(value, value, value) );
+                }
+            }
+            std::remove(path);
+        }
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -22,6 +22,9 @@
 ///
 
 #include "ias/MaskC1.h"
+#include "ias/Binarize.h"
+#include "ias/Kernels.h"
+#include "ias/ThreadPool.h"
 
 #include <boost/test/unit_test.hpp>
 
@@ -60,6 +63,34 @@ BOOST_AUTO_TEST_SUITE( MaskC1Suite )
         BOOST_CHECK_EQUAL( mask.get(1,1), 51 );
     }
 
+    template<typename Kernel>
+    static void checkKernel() {
+        cv::Mat matrix( 5, 7, CV_8UC1 );
+        for (int y = 0; y < matrix.rows; ++y) {
+            for (int x = 0; x < matrix.cols; ++x) {
+                matrix.at<uchar>(y, x) = (x * 37 + y * 101) % 256;
+            }
+        }
+
+        MaskC1 mask( matrix.clone() );
+        mask.applyFilter<Kernel>();
+
+        MaskC1 expected( matrix.clone() );
+        expected.applyFilter( Kernel::matrix() );
+
+        for (int y = 0; y < matrix.rows; ++y) {
+            for (int x = 0; x < matrix.cols; ++x) {
+                BOOST_CHECK_EQUAL( mask.get(x, y), expected.get(x, y) );
+            }
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE( applyFilter_kernels ) {
+        checkKernel<LaplaceKernel>();
+        checkKernel<GaussianKernel>();
+        checkKernel<BoxKernel>();
+    }
+
     BOOST_AUTO_TEST_CASE( threshold_empty ) {
         MaskC1 mask;
 
@@ -86,4 +117,333 @@ BOOST_AUTO_TEST_SUITE( MaskC1Suite )
         BOOST_CHECK_EQUAL( mask.get(1,1), 255 );
     }
 
+    BOOST_AUTO_TEST_CASE( binarize_color ) {
+        cv::Mat image = cv::Mat::zeros( 2, 3, CV_8UC3 );
+        image.at<cv::Vec3b>(0, 0) = cv::Vec3b(10, 20, 30);
+        image.at<cv::Vec3b>(0, 1) = cv::Vec3b(15, 25, 35);
+        image.at<cv::Vec3b>(1, 2) = cv::Vec3b(16, 20, 30);
+
+        const MaskC1 mask(image, cv::Vec3b(10, 20, 30), 5);
+
+        BOOST_CHECK_EQUAL( mask.get(0, 0), 255 );
+        BOOST_CHECK_EQUAL( mask.get(1, 0), 255 );
+        BOOST_CHECK_EQUAL( mask.get(2, 0), 0 );
+        BOOST_CHECK_EQUAL( mask.get(2, 1), 0 );
+    }
+
+    BOOST_AUTO_TEST_CASE( binarize_kernel_scalar ) {
+        /// odd width covers both vectorized body and scalar tail
+        const int nCols = 77;
+        cv::Mat image( 3, nCols, CV_8UC3 );
+        for (int y = 0; y < image.rows; ++y) {
+            for (int x = 0; x < nCols; ++x) {
+                image.at<cv::Vec3b>(y, x) = cv::Vec3b( (x * 7 + y) % 256, (x * 13) % 256, 200 - x );
+            }
+        }
+
+        const cv::Vec3b color(100, 150, 160);
+        const uchar tolerance = 60;
+        const MaskC1 mask(image, color, tolerance);
+
+        std::vector<uchar> expected(nCols);
+        for (int y = 0; y < image.rows; ++y) {
+            binarizeRowScalar(image.ptr<cv::Vec3b>(y), &expected[0], nCols, color, tolerance);
+            for (int x = 0; x < nCols; ++x) {
+                BOOST_CHECK_EQUAL( mask.get(x, y), expected[x] );
+            }
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE( floodFill_region ) {
+        MaskC1 mask(4, 3);
+        mask.set(0, 0, 255);
+        mask.set(1, 0, 255);
+        mask.set(1, 1, 255);
+        mask.set(3, 2, 255);                    /// separate region
+
+        mask.floodFill( cv::Point(0, 0), 255, 127, 0 );
+
+        BOOST_CHECK_EQUAL( mask.get(0, 0), 127 );
+        BOOST_CHECK_EQUAL( mask.get(1, 0), 127 );
+        BOOST_CHECK_EQUAL( mask.get(1, 1), 127 );
+        BOOST_CHECK_EQUAL( mask.get(3, 2), 0 );
+    }
+
+    BOOST_AUTO_TEST_CASE( floodFill_diagonal ) {
+        MaskC1 mask(3, 3);
+        mask.set(1, 1, 255);
+        mask.set(0, 0, 255);                    /// diagonal neighbour is not connected
+        mask.set(0, 1, 255);
+
+        mask.floodFill( cv::Point(1, 1), 255, 127, 0 );
+
+        BOOST_CHECK_EQUAL( mask.get(1, 1), 127 );
+        BOOST_CHECK_EQUAL( mask.get(0, 1), 127 );
+        BOOST_CHECK_EQUAL( mask.get(0, 0), 127 );
+
+        MaskC1 mask2(3, 3);
+        mask2.set(1, 1, 255);
+        mask2.set(0, 0, 255);
+
+        mask2.floodFill( cv::Point(1, 1), 255, 127, 0 );
+
+        BOOST_CHECK_EQUAL( mask2.get(1, 1), 127 );
+        BOOST_CHECK_EQUAL( mask2.get(0, 0), 0 );
+    }
+
+    BOOST_AUTO_TEST_CASE( floodFillParallel_as_floodFill ) {
+        /// big enough to be split into several bands
+        cv::Mat matrix( 1200, 900, CV_8UC1 );
+        unsigned int state = 7;
+        for (int y = 0; y < matrix.rows; ++y) {
+            for (int x = 0; x < matrix.cols; ++x) {
+                state = state * 1103515245u + 12345u;
+                matrix.at<uchar>(y, x) = ( (state >> 16) % 100 < 62 ) ? 255 : 0;
+            }
+        }
+
+        ThreadPool::global().resize(4);
+        const cv::Point seeds[] = { cv::Point(0, 0), cv::Point(450, 600), cv::Point(899, 1199), cv::Point(-1, 3) };
+        for (std::size_t i = 0; i < sizeof(seeds) / sizeof(seeds[0]); ++i) {
+            MaskC1 expected( matrix.clone() );
+            expected.floodFill( seeds[i], 255, 127, 0 );
+            MaskC1 mask( matrix.clone() );
+            mask.floodFillParallel( seeds[i], 255, 127, 0 );
+
+            for (int y = 0; y < matrix.rows; ++y) {
+                for (int x = 0; x < matrix.cols; ++x) {
+                    BOOST_REQUIRE_EQUAL( mask.get(x, y), expected.get(x, y) );
+                }
+            }
+        }
+        ThreadPool::global().resize(1);
+    }
+
+    BOOST_AUTO_TEST_CASE( region_of_mask ) {
+        MaskC1 source(4, 3);
+        source.set(0, 0, 255);
+        source.set(1, 0, 255);
+        source.set(1, 1, 255);
+        source.set(3, 2, 255);
+        source.set(2, 2, 100);
+
+        const MaskC1 region( source.data(), cv::Point(0, 0), 255 );
+        BOOST_CHECK_EQUAL( region.get(0, 0), 255 );
+        BOOST_CHECK_EQUAL( region.get(1, 1), 255 );
+        BOOST_CHECK_EQUAL( region.get(2, 2), 0 );
+        BOOST_CHECK_EQUAL( region.get(3, 2), 0 );
+        BOOST_CHECK_EQUAL( source.get(2, 2), 100 );
+
+        const MaskC1 outside( source.data(), cv::Point(2, 1), 255 );
+        BOOST_CHECK_EQUAL( cv::countNonZero( outside.data() ), 0 );
+    }
+
+    BOOST_AUTO_TEST_CASE( floodFill_seed_outside_color ) {
+        MaskC1 mask(3, 1);
+        mask.set(0, 0, 255);
+
+        mask.floodFill( cv::Point(1, 0), 255, 127, 0 );
+
+        BOOST_CHECK_EQUAL( mask.get(0, 0), 0 );
+        BOOST_CHECK_EQUAL( mask.get(1, 0), 0 );
+    }
+
+    BOOST_AUTO_TEST_CASE( region_color ) {
+        cv::Mat image = cv::Mat::zeros( 3, 4, CV_8UC3 );
+        image.at<cv::Vec3b>(0, 0) = cv::Vec3b(0, 0, 250);
+        image.at<cv::Vec3b>(0, 1) = cv::Vec3b(0, 0, 255);
+        image.at<cv::Vec3b>(1, 1) = cv::Vec3b(0, 0, 255);
+        image.at<cv::Vec3b>(2, 3) = cv::Vec3b(0, 0, 255);          /// separate region
+
+        const MaskC1 region(image, cv::Point(0, 0), cv::Vec3b(0, 0, 255), 10);
+
+        MaskC1 expected(image, cv::Vec3b(0, 0, 255), 10);
+        expected.floodFill( cv::Point(0, 0), 255, 127, 0 );
+        expected.changeColor( 127, 255 );
+
+        for (int y = 0; y < image.rows; ++y) {
+            for (int x = 0; x < image.cols; ++x) {
+                BOOST_CHECK_EQUAL( region.get(x, y), expected.get(x, y) );
+            }
+        }
+        BOOST_CHECK_EQUAL( region.get(1, 1), 255 );
+        BOOST_CHECK_EQUAL( region.get(3, 2), 0 );
+    }
+
+    BOOST_AUTO_TEST_CASE( region_seed_outside ) {
+        const cv::Mat image = cv::Mat::zeros( 2, 2, CV_8UC3 );
+
+        const MaskC1 region(image, cv::Point(5, 5), cv::Vec3b(0, 0, 0), 0);
+
+        BOOST_REQUIRE_EQUAL( region.empty(), false );
+        BOOST_CHECK_EQUAL( region.get(0, 0), 0 );
+    }
+
+    BOOST_AUTO_TEST_CASE( dilate_pixel ) {
+        MaskC1 mask(7, 7);
+        mask.set(3, 3, 255);
+
+        mask.dilate();
+
+        BOOST_CHECK_EQUAL( mask.get(2, 2), 255 );
+        BOOST_CHECK_EQUAL( mask.get(4, 4), 255 );
+        BOOST_CHECK_EQUAL( mask.get(1, 3), 0 );
+    }
+
+    BOOST_AUTO_TEST_CASE( dilate_element ) {
+        MaskC1 mask(9, 9);
+        mask.set(4, 4, 255);
+
+        mask.dilate( cv::Size(5, 1), 2 );             /// equivalent to 9x1 element
+
+        BOOST_CHECK_EQUAL( mask.get(0, 4), 255 );
+        BOOST_CHECK_EQUAL( mask.get(8, 4), 255 );
+        BOOST_CHECK_EQUAL( mask.get(4, 3), 0 );
+    }
+
+    BOOST_AUTO_TEST_CASE( erode_border ) {
+        MaskC1 mask(5, 5, 255);
+
+        mask.erode();
+
+        BOOST_CHECK_EQUAL( mask.get(0, 0), 0 );         /// pixels outside of mask are zeros
+        BOOST_CHECK_EQUAL( mask.get(4, 2), 0 );
+        BOOST_CHECK_EQUAL( mask.get(1, 1), 255 );
+        BOOST_CHECK_EQUAL( mask.get(3, 3), 255 );
+    }
+
+    BOOST_AUTO_TEST_CASE( erode_repeats ) {
+        MaskC1 mask(7, 7, 255);
+        MaskC1 expected(7, 7, 255);
+
+        mask.erode(3, 2);
+        expected.erode();
+        expected.erode();
+
+        for (int y = 0; y < 7; ++y) {
+            for (int x = 0; x < 7; ++x) {
+                BOOST_CHECK_EQUAL( mask.get(x, y), expected.get(x, y) );
+            }
+        }
+        BOOST_CHECK_EQUAL( mask.get(3, 3), 255 );
+        BOOST_CHECK_EQUAL( mask.get(1, 1), 0 );
+    }
+
+    /// binary pattern crossing 64-pixel word boundaries
+    static cv::Mat binaryPattern() {
+        cv::Mat matrix = cv::Mat::zeros( 20, 150, CV_8UC1 );
+        for (int y = 0; y < matrix.rows; ++y) {
+            for (int x = 0; x < matrix.cols; ++x) {
+                if ( (x * 7 + y * 13) % 11 < 6 )
+                    matrix.at<uchar>(y, x) = 255;
+            }
+        }
+        return matrix;
+    }
+
+    static void checkSame(const MaskC1& mask, const MaskC1& expected) {
+        BOOST_REQUIRE( mask.size() == expected.size() );
+        for (int y = 0; y < mask.size().height; ++y) {
+            for (int x = 0; x < mask.size().width; ++x) {
+                BOOST_REQUIRE_EQUAL( mask.get(x, y), expected.get(x, y) );
+            }
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE( pack_unpack ) {
+        const cv::Mat matrix = binaryPattern();
+        MaskC1 mask( matrix.clone() );
+        BOOST_CHECK_EQUAL( mask.packed(), false );
+
+        BOOST_REQUIRE_EQUAL( mask.pack(), true );
+        BOOST_CHECK_EQUAL( mask.packed(), true );
+        BOOST_CHECK_EQUAL( mask.packedData().bytes(), 20 * 3 * 8 );
+        checkSame( mask, MaskC1(matrix) );
+
+        mask.unpack();
+        BOOST_CHECK_EQUAL( mask.packed(), false );
+        BOOST_CHECK_EQUAL( cv::countNonZero( *mask != matrix ), 0 );
+
+        /// mask of other values stays unpacked
+        mask.set(3, 2, 100);
+        BOOST_CHECK_EQUAL( mask.pack(), false );
+        BOOST_CHECK_EQUAL( mask.get(3, 2), 100 );
+    }
+
+    BOOST_AUTO_TEST_CASE( packed_as_unpacked ) {
+        const cv::Mat matrix = binaryPattern();
+        MaskC1 packed( matrix.clone() );
+        BOOST_REQUIRE_EQUAL( packed.pack(), true );
+        MaskC1 expected( matrix.clone() );
+
+        packed.dilate( cv::Size(5, 3) );
+        expected.dilate( cv::Size(5, 3) );
+        checkSame( packed, expected );
+
+        packed.erode(3, 2);
+        expected.erode(3, 2);
+        checkSame( packed, expected );
+
+        packed.threshold(0);
+        expected.threshold(0);
+        checkSame( packed, expected );
+
+        packed.changeColor(255, 0);
+        expected.changeColor(255, 0);
+        checkSame( packed, expected );
+
+        packed.set(70, 3, 255);
+        expected.set(70, 3, 255);
+        BOOST_CHECK_EQUAL( packed.packed(), true );
+        checkSame( packed, expected );
+    }
+
+    BOOST_AUTO_TEST_CASE( packed_perimeter ) {
+        const cv::Mat matrix = binaryPattern();
+        const int connectivity[] = { 4, 8 };
+        for (const int neighbours: connectivity) {
+            MaskC1 packed( matrix.clone() );
+            BOOST_REQUIRE_EQUAL( packed.pack(), true );
+            packed.perimeter(neighbours);
+            BOOST_CHECK_EQUAL( packed.packed(), true );
+
+            MaskC1 expected( matrix.clone() );
+            expected.perimeter(neighbours);
+            BOOST_CHECK_EQUAL( expected.packed(), false );
+            checkSame( packed, expected );
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE( packed_other_values ) {
+        MaskC1 mask( binaryPattern() );
+        BOOST_REQUIRE_EQUAL( mask.pack(), true );
+        MaskC1 copy(mask);
+
+        /// changing to other value unpacks mask, copy does not share data
+        mask.changeColor(255, 127);
+        BOOST_CHECK_EQUAL( mask.packed(), false );
+        BOOST_CHECK_EQUAL( mask.get(0, 0), 127 );
+        BOOST_CHECK_EQUAL( copy.packed(), true );
+        BOOST_CHECK_EQUAL( copy.get(0, 0), 255 );
+
+        copy.set(1, 1, 50);
+        BOOST_CHECK_EQUAL( copy.packed(), false );
+        BOOST_CHECK_EQUAL( copy.get(1, 1), 50 );
+    }
+
+    BOOST_AUTO_TEST_CASE( region_packed ) {
+        cv::Mat image = cv::Mat::zeros( 3, 70, CV_8UC3 );
+        cv::Mat( image, cv::Rect(60, 0, 10, 2) ).setTo( cv::Scalar(0, 0, 255) );
+
+        const MaskC1 region(image, cv::Point(65, 1), cv::Vec3b(0, 0, 255), 0);
+        BOOST_CHECK_EQUAL( region.packed(), true );
+        BOOST_CHECK_EQUAL( region.packedData().count(), 20 );
+
+        const cv::Mat matrix = *region;
+        BOOST_REQUIRE_EQUAL( matrix.type(), CV_8UC1 );
+        BOOST_CHECK_EQUAL( matrix.at<uchar>(0, 60), 255 );
+        BOOST_CHECK_EQUAL( matrix.at<uchar>(2, 60), 0 );
+        BOOST_CHECK_EQUAL( cv::countNonZero(matrix), 20 );
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,83 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "ias/MaskCache.h"
+
+#include <boost/test/unit_test.hpp>
+
+
+using namespace ias;
+
+
+BOOST_AUTO_TEST_SUITE( MaskCacheSuite )
+
+    BOOST_AUTO_TEST_CASE( disabled ) {
+        MaskCache cache;
+        BOOST_CHECK_EQUAL( cache.enabled(), false );
+
+        cache.insert( cv::Vec3b(1, 2, 3), 0, cv::Mat::zeros( 2, 2, CV_8UC1 ) );
+        BOOST_CHECK_EQUAL( cache.size(), 0 );
+        BOOST_CHECK_EQUAL( cache.find( cv::Vec3b(1, 2, 3), 0 ).empty(), true );
+        BOOST_CHECK_EQUAL( cache.misses(), 1 );
+    }
+
+    BOOST_AUTO_TEST_CASE( hit_miss ) {
+        MaskCache cache(100);
+        cache.insert( cv::Vec3b(1, 2, 3), 5, cv::Mat::zeros( 4, 5, CV_8UC1 ) );
+
+        BOOST_CHECK_EQUAL( cache.find( cv::Vec3b(1, 2, 3), 5 ).empty(), false );
+        BOOST_CHECK_EQUAL( cache.find( cv::Vec3b(1, 2, 3), 6 ).empty(), true );
+        BOOST_CHECK_EQUAL( cache.hits(), 1 );
+        BOOST_CHECK_EQUAL( cache.misses(), 1 );
+        BOOST_CHECK_EQUAL( cache.bytes(), 20 );
+
+        cache.clear();
+        BOOST_CHECK_EQUAL( cache.size(), 0 );
+        BOOST_CHECK_EQUAL( cache.bytes(), 0 );
+        BOOST_CHECK_EQUAL( cache.hits(), 1 );
+    }
+
+    BOOST_AUTO_TEST_CASE( evict_least_recent ) {
+        MaskCache cache(50);
+        cache.insert( cv::Vec3b(1, 0, 0), 0, cv::Mat::zeros( 4, 5, CV_8UC1 ) );
+        cache.insert( cv::Vec3b(2, 0, 0), 0, cv::Mat::zeros( 4, 5, CV_8UC1 ) );
+        cache.find( cv::Vec3b(1, 0, 0), 0 );
+
+        /// second mask is least recently used
+        cache.insert( cv::Vec3b(3, 0, 0), 0, cv::Mat::zeros( 4, 5, CV_8UC1 ) );
+        BOOST_CHECK_EQUAL( cache.size(), 2 );
+        BOOST_CHECK_EQUAL( cache.find( cv::Vec3b(2, 0, 0), 0 ).empty(), true );
+        BOOST_CHECK_EQUAL( cache.find( cv::Vec3b(1, 0, 0), 0 ).empty(), false );
+        BOOST_CHECK_EQUAL( cache.find( cv::Vec3b(3, 0, 0), 0 ).empty(), false );
+
+        cache.setBudget(20);
+        BOOST_CHECK_EQUAL( cache.size(), 1 );
+        BOOST_CHECK_EQUAL( cache.bytes(), 20 );
+
+        /// too big for budget
+        cache.insert( cv::Vec3b(4, 0, 0), 0, cv::Mat::zeros( 5, 5, CV_8UC1 ) );
+        BOOST_CHECK_EQUAL( cache.find( cv::Vec3b(4, 0, 0), 0 ).empty(), true );
+        BOOST_CHECK_EQUAL( cache.size(), 1 );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
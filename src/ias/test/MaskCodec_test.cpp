@@ -0,0 +1,140 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "ias/MaskCodec.h"
+
+#include <cstring>
+
+#include <zlib.h>
+
+#include <boost/test/unit_test.hpp>
+
+
+using namespace ias;
+
+
+BOOST_AUTO_TEST_SUITE( MaskCodecSuite )
+
+    static cv::Mat patternMask(const int rows, const int cols) {
+        cv::Mat mask = cv::Mat::zeros( rows, cols, CV_8UC1 );
+        for (int y = 0; y < rows; ++y) {
+            for (int x = 0; x < cols; ++x) {
+                if ( (x * 7 + y * 3) % 11 < 4 || x == cols - 1 )
+                    mask.at<uchar>(y, x) = 255;
+            }
+        }
+        return mask;
+    }
+
+    static uint32_t readBE32(const uchar* data) {
+        return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | data[3];
+    }
+
+    BOOST_AUTO_TEST_CASE( binary_mask ) {
+        cv::Mat mask = patternMask(5, 9);
+        BOOST_CHECK_EQUAL( isBinaryMask(mask), true );
+        mask.at<uchar>(2, 3) = 127;
+        BOOST_CHECK_EQUAL( isBinaryMask(mask), false );
+        BOOST_CHECK_EQUAL( isBinaryMask( cv::Mat::zeros(2, 2, CV_8UC3) ), false );
+    }
+
+    BOOST_AUTO_TEST_CASE( bilevel_png ) {
+        const cv::Mat mask = patternMask(40, 77);
+        std::vector<uchar> stored;
+        encodeBilevelPng(mask, 0, stored);
+        std::vector<uchar> compressed;
+        encodeBilevelPng(mask, 9, compressed);
+
+        static const uchar SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        BOOST_REQUIRE_GT( compressed.size(), 33 );
+        BOOST_CHECK_EQUAL( std::memcmp(compressed.data(), SIGNATURE, 8), 0 );
+        BOOST_CHECK_EQUAL( std::memcmp(compressed.data() + 12, "IHDR", 4), 0 );
+        BOOST_CHECK_EQUAL( readBE32(compressed.data() + 16), 77 );
+        BOOST_CHECK_EQUAL( readBE32(compressed.data() + 20), 40 );
+        BOOST_CHECK_EQUAL( compressed[24], 1 );                             /// bit depth
+        BOOST_CHECK_EQUAL( readBE32(compressed.data() + 29), ::crc32(0, compressed.data() + 12, 17) );
+
+        /// image data inflates to bit-packed rows
+        const uLong dataSize = readBE32(compressed.data() + 33);
+        BOOST_REQUIRE_EQUAL( std::memcmp(compressed.data() + 37, "IDAT", 4), 0 );
+        std::vector<uchar> raw( 40 * (77 / 8 + 2) );
+        uLongf rawSize = raw.size();
+        BOOST_REQUIRE_EQUAL( uncompress(raw.data(), &rawSize, compressed.data() + 41, dataSize), Z_OK );
+        BOOST_REQUIRE_EQUAL( rawSize, raw.size() );
+        for (int y = 0; y < mask.rows; ++y) {
+            const uchar* packed = raw.data() + y * (77 / 8 + 2);
+            BOOST_CHECK_EQUAL( packed[0], 0 );                               /// no filter
+            for (int x = 0; x < mask.cols; ++x) {
+                BOOST_CHECK_EQUAL( (packed[1 + (x >> 3)] >> (7 - (x & 7))) & 1, mask.at<uchar>(y, x) != 0 );
+            }
+        }
+
+        /// rows are bit-packed
+        BOOST_CHECK_LT( stored.size(), 40 * (77 / 8 + 2) + 100 );
+        BOOST_CHECK_LT( compressed.size(), stored.size() );
+    }
+
+    BOOST_AUTO_TEST_CASE( rle_roundtrip ) {
+        cv::Mat mask = patternMask(6, 300);
+        mask.row(2).setTo( cv::Scalar(0) );
+        mask.row(3).setTo( cv::Scalar(255) );
+        mask.at<uchar>(4, 0) = 255;
+        mask.at<uchar>(5, 0) = 0;
+
+        std::vector<uchar> data;
+        encodeRleHeader(mask.cols, mask.rows, data);
+        BOOST_CHECK_EQUAL( data.size(), RLE_HEADER_SIZE );
+        for (int y = 0; y < mask.rows; ++y) {
+            encodeRleRow(mask.ptr<uchar>(y), mask.cols, data);
+        }
+
+        cv::Mat decoded;
+        BOOST_REQUIRE_EQUAL( decodeRle(data.data(), data.size(), decoded), true );
+        BOOST_REQUIRE_EQUAL( decoded.rows, mask.rows );
+        BOOST_REQUIRE_EQUAL( decoded.cols, mask.cols );
+        for (int y = 0; y < mask.rows; ++y) {
+            for (int x = 0; x < mask.cols; ++x) {
+                BOOST_CHECK_EQUAL( decoded.at<uchar>(y, x), mask.at<uchar>(y, x) );
+            }
+        }
+
+        /// truncated and too long data
+        BOOST_CHECK_EQUAL( decodeRle(data.data(), data.size() - 1, decoded), false );
+        data.push_back( 0 );
+        BOOST_CHECK_EQUAL( decodeRle(data.data(), data.size(), decoded), false );
+
+        /// header declaring more rows than data can hold
+        std::vector<uchar> forged;
+        encodeRleHeader(1, 0x7FFFFFFF, forged);
+        forged.push_back( 1 );
+        BOOST_CHECK_EQUAL( decodeRle(forged.data(), forged.size(), decoded), false );
+    }
+
+    BOOST_AUTO_TEST_CASE( rle_empty_row ) {
+        const cv::Mat row = cv::Mat::zeros( 1, 100000, CV_8UC1 );
+        std::vector<uchar> data;
+        encodeRleRow(row.ptr<uchar>(0), row.cols, data);
+        BOOST_CHECK_EQUAL( data.size(), 3 );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
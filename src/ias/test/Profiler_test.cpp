@@ -0,0 +1,158 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include "ias/Profiler.h"
+
+#include <sstream>
+
+#include <boost/test/unit_test.hpp>
+
+#include "ias/BufferPool.h"
+#include "ias/MaskC1.h"
+
+
+using namespace ias;
+
+
+static const ProfileStage* findStage(const std::vector<ProfileStage>& stages, const std::string& name) {
+    for (std::size_t i = 0; i < stages.size(); ++i) {
+        if (stages[i].name == name)
+            return &stages[i];
+    }
+    return NULL;
+}
+
+
+BOOST_AUTO_TEST_SUITE( ProfilerSuite )
+
+    BOOST_AUTO_TEST_CASE( record_accumulate ) {
+        Profiler profiler;
+        BOOST_CHECK_EQUAL( profiler.enabled(), false );
+
+        profiler.record("stage", 2000000, 100, 10);
+        profiler.record("other", 1000, 1, 0);
+        profiler.record("stage", 1000000, 50, 5);
+
+        const std::vector<ProfileStage> stages = profiler.stages();
+        BOOST_REQUIRE_EQUAL( stages.size(), 2 );
+        BOOST_CHECK_EQUAL( stages[0].name, "stage" );
+        BOOST_CHECK_EQUAL( stages[0].calls, 2 );
+        BOOST_CHECK_EQUAL( stages[0].nanoseconds, 3000000 );
+        BOOST_CHECK_EQUAL( stages[0].pixels, 150 );
+        BOOST_CHECK_EQUAL( stages[0].bytes, 15 );
+        BOOST_CHECK_CLOSE( stages[0].milliseconds(), 3.0, 0.001 );
+        BOOST_CHECK_CLOSE( stages[0].megapixelsPerSecond(), 0.05, 0.001 );
+        BOOST_CHECK_EQUAL( stages[1].name, "other" );
+
+        profiler.reset();
+        BOOST_CHECK_EQUAL( profiler.stages().empty(), true );
+    }
+
+    BOOST_AUTO_TEST_CASE( write_json ) {
+        Profiler profiler;
+        profiler.record("MaskC1::threshold", 1000, 20, 0);
+
+        std::ostringstream json;
+        profiler.writeJson(json);
+        BOOST_CHECK( json.str().find("\"stage\": \"MaskC1::threshold\"") != std::string::npos );
+        BOOST_CHECK( json.str().find("\"pixels\": 20") != std::string::npos );
+
+        std::ostringstream text;
+        profiler.writeText(text);
+        BOOST_CHECK( text.str().find("MaskC1::threshold: calls=1") == 0 );
+    }
+
+    BOOST_AUTO_TEST_CASE( scope_allocations ) {
+        Profiler& profiler = Profiler::global();
+        profiler.reset();
+        profiler.setEnabled(true);
+        {
+            ProfileScope outer("outer", 10);
+            Profiler::countAllocation(100);
+            {
+                ProfileScope inner("inner", 10);
+                Profiler::countAllocation(20);
+            }
+            ProfileScope empty("empty", 10);
+        }
+        profiler.setEnabled(false);
+        Profiler::countAllocation(1000);
+
+        const std::vector<ProfileStage> stages = profiler.stages();
+        BOOST_REQUIRE_EQUAL( stages.size(), 3 );
+        BOOST_CHECK_EQUAL( findStage(stages, "inner")->bytes, 20 );
+        BOOST_CHECK_EQUAL( findStage(stages, "empty")->bytes, 0 );
+        /// includes inner stage
+        BOOST_CHECK_EQUAL( findStage(stages, "outer")->bytes, 120 );
+        profiler.reset();
+    }
+
+    BOOST_AUTO_TEST_CASE( disabled ) {
+        Profiler& profiler = Profiler::global();
+        profiler.reset();
+
+        MaskC1 mask( cv::Mat::zeros( 4, 5, CV_8UC1 ) );
+        mask.threshold(128);
+        BOOST_CHECK_EQUAL( profiler.stages().empty(), true );
+    }
+
+    BOOST_AUTO_TEST_CASE( enabled_stages ) {
+        if (Profiler::compiled() == false)
+            return ;
+
+        Profiler& profiler = Profiler::global();
+        profiler.reset();
+        profiler.setEnabled(true);
+
+        BufferPool::global().clear();
+        const cv::Mat image = cv::Mat::zeros( 4, 5, CV_8UC3 );
+        MaskC1 mask( image, cv::Vec3b(0, 0, 0), 0 );
+        mask.threshold(128);
+        mask.threshold(128);
+        mask.invalidate();
+
+        /// buffer is taken from pool
+        MaskC1 pooled( image, cv::Vec3b(0, 0, 0), 0 );
+
+        profiler.setEnabled(false);
+        pooled.dilate(3);
+
+        const std::vector<ProfileStage> stages = profiler.stages();
+        const ProfileStage* binarize = findStage(stages, "MaskC1::binarize");
+        BOOST_REQUIRE( binarize != NULL );
+        BOOST_CHECK_EQUAL( binarize->calls, 2 );
+        BOOST_CHECK_EQUAL( binarize->pixels, 40 );
+        /// only first call allocates
+        BOOST_CHECK_EQUAL( binarize->bytes, 20 );
+
+        const ProfileStage* threshold = findStage(stages, "MaskC1::threshold");
+        BOOST_REQUIRE( threshold != NULL );
+        BOOST_CHECK_EQUAL( threshold->calls, 2 );
+        BOOST_CHECK_EQUAL( threshold->pixels, 40 );
+
+        BOOST_CHECK( findStage(stages, "MaskC1::dilate") == NULL );
+        profiler.reset();
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
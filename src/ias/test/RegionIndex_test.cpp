@@ -0,0 +1,94 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "ias/RegionIndex.h"
+
+#include <boost/test/unit_test.hpp>
+
+
+using namespace ias;
+
+
+BOOST_AUTO_TEST_SUITE( RegionIndexSuite )
+
+    static cv::Mat patternImage() {
+        cv::Mat image( 40, 70, CV_8UC3 );
+        for (int y = 0; y < image.rows; ++y) {
+            for (int x = 0; x < image.cols; ++x) {
+                const bool inside = ( (x / 6 + y / 4) % 3 != 0 ) || (x % 11 == 0);
+                image.at<cv::Vec3b>(y, x) = inside ? cv::Vec3b(10, 20, 200 + (x + y) % 20) : cv::Vec3b(0, 255, 0);
+            }
+        }
+        return image;
+    }
+
+    BOOST_AUTO_TEST_CASE( empty_index ) {
+        RegionIndex index;
+
+        BOOST_CHECK_EQUAL( index.empty(), true );
+        BOOST_CHECK_EQUAL( index.matches( cv::Vec3b(0, 0, 0), 0 ), false );
+        BOOST_CHECK_EQUAL( index.regionMask( cv::Point(0, 0) ).empty(), true );
+    }
+
+    BOOST_AUTO_TEST_CASE( regions_boxes ) {
+        cv::Mat image( 3, 5, CV_8UC3, cv::Scalar(0, 0, 0) );
+        image.at<cv::Vec3b>(0, 0) = cv::Vec3b(255, 255, 255);
+        image.at<cv::Vec3b>(1, 0) = cv::Vec3b(255, 255, 255);
+        image.at<cv::Vec3b>(1, 1) = cv::Vec3b(255, 255, 255);
+        image.at<cv::Vec3b>(2, 4) = cv::Vec3b(255, 255, 255);
+
+        const RegionIndex index( image, cv::Vec3b(255, 255, 255), 0 );
+
+        BOOST_REQUIRE_EQUAL( index.regions(), 2 );
+        BOOST_CHECK_EQUAL( index.regionAt( cv::Point(1, 1) ), 0 );
+        BOOST_CHECK_EQUAL( index.regionAt( cv::Point(4, 2) ), 1 );
+        BOOST_CHECK_EQUAL( index.regionAt( cv::Point(3, 2) ), -1 );
+        BOOST_CHECK_EQUAL( index.regionAt( cv::Point(5, 2) ), -1 );
+        BOOST_CHECK_EQUAL( index.boundingBox(0), cv::Rect(0, 0, 2, 2) );
+        BOOST_CHECK_EQUAL( index.boundingBox(1), cv::Rect(4, 2, 1, 1) );
+        BOOST_CHECK_EQUAL( index.area(0), 3 );
+        BOOST_CHECK_EQUAL( index.area(1), 1 );
+    }
+
+    BOOST_AUTO_TEST_CASE( regionMask_as_MaskC1 ) {
+        const cv::Mat image = patternImage();
+        const cv::Vec3b color(10, 20, 210);
+
+        const RegionIndex index( image, color, 10 );
+        BOOST_CHECK_EQUAL( index.matches(color, 10), true );
+        BOOST_CHECK_EQUAL( index.matches(color, 11), false );
+
+        const cv::Point seeds[] = { cv::Point(0, 0), cv::Point(7, 0), cv::Point(33, 21), cv::Point(69, 39) };
+        for (std::size_t i = 0; i < sizeof(seeds) / sizeof(seeds[0]); ++i) {
+            const MaskC1 expected( image, seeds[i], color, 10 );
+            const MaskC1 mask = index.regionMask( seeds[i] );
+            BOOST_CHECK_EQUAL( mask.packed(), true );
+            for (int y = 0; y < image.rows; ++y) {
+                for (int x = 0; x < image.cols; ++x) {
+                    BOOST_REQUIRE_EQUAL( mask.get(x, y), expected.get(x, y) );
+                }
+            }
+        }
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
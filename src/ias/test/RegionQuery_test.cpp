@@ -0,0 +1,174 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include "ias/RegionQuery.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include "ias/Analysis.h"
+
+
+using namespace ias;
+
+
+static const cv::Vec3b RED(0, 0, 250);
+static const cv::Vec3b DARK_RED(0, 0, 230);
+static const cv::Vec3b BLUE(250, 0, 0);
+
+
+/// white image with red, dark red and blue rectangles
+static cv::Mat createImage() {
+    cv::Mat image( 20, 30, CV_8UC3, cv::Scalar(255, 255, 255) );
+    cv::Mat( image, cv::Rect(2, 2, 6, 6) ).setTo( cv::Scalar(RED[0], RED[1], RED[2]) );
+    cv::Mat( image, cv::Rect(8, 2, 4, 6) ).setTo( cv::Scalar(DARK_RED[0], DARK_RED[1], DARK_RED[2]) );
+    cv::Mat( image, cv::Rect(20, 2, 6, 6) ).setTo( cv::Scalar(RED[0], RED[1], RED[2]) );
+    cv::Mat( image, cv::Rect(2, 12, 6, 6) ).setTo( cv::Scalar(BLUE[0], BLUE[1], BLUE[2]) );
+    return image;
+}
+
+static int countValue(const cv::Mat& mask, const uchar value) {
+    int count = 0;
+    for (int y = 0; y < mask.rows; ++y) {
+        for (int x = 0; x < mask.cols; ++x) {
+            if (mask.at<uchar>(y, x) == value)
+                ++count;
+        }
+    }
+    return count;
+}
+
+
+BOOST_AUTO_TEST_SUITE( RegionQuerySuite )
+
+    BOOST_AUTO_TEST_CASE( classify_bits ) {
+        const cv::Mat image = createImage();
+        std::vector<cv::Vec3b> colors;
+        std::vector<uchar> tolerances;
+        colors.push_back( RED );        tolerances.push_back( 30 );
+        colors.push_back( DARK_RED );   tolerances.push_back( 0 );
+        colors.push_back( BLUE );       tolerances.push_back( 0 );
+
+        cv::Mat classes;
+        classifyColors(image, colors, tolerances, classes);
+        BOOST_REQUIRE_EQUAL( classes.type(), CV_8UC1 );
+        BOOST_CHECK_EQUAL( classes.at<uchar>(0, 0), 0 );
+        BOOST_CHECK_EQUAL( classes.at<uchar>(3, 3), 1 );
+        BOOST_CHECK_EQUAL( classes.at<uchar>(3, 9), 3 );
+        BOOST_CHECK_EQUAL( classes.at<uchar>(13, 3), 4 );
+    }
+
+    BOOST_AUTO_TEST_CASE( union_of_regions ) {
+        const cv::Mat image = createImage();
+        std::vector<RegionQuery> queries;
+        queries.push_back( RegionQuery( cv::Point(3, 3), RED, 0 ) );
+        queries.push_back( RegionQuery( cv::Point(3, 13), BLUE, 10 ) );
+        queries.push_back( RegionQuery( cv::Point(9, 3), DARK_RED, 0 ) );
+
+        const MaskC1 result = findRegions(image, queries);
+        BOOST_REQUIRE_EQUAL( result.empty(), false );
+        BOOST_CHECK_EQUAL( result.packed(), true );
+
+        /// the same as union of single regions
+        for (int y = 0; y < image.rows; ++y) {
+            for (int x = 0; x < image.cols; ++x) {
+                uchar expected = 0;
+                for (std::size_t q = 0; q < queries.size(); ++q) {
+                    const MaskC1 single( image, queries[q].seed, queries[q].color, queries[q].tolerance );
+                    expected |= single.get(x, y);
+                }
+                BOOST_REQUIRE_EQUAL( result.get(x, y), expected );
+            }
+        }
+        BOOST_CHECK_EQUAL( countValue(*result, 255), 36 + 36 + 24 );
+    }
+
+    BOOST_AUTO_TEST_CASE( overlapping_colors ) {
+        const cv::Mat image = createImage();
+        std::vector<RegionQuery> queries;
+        queries.push_back( RegionQuery( cv::Point(9, 3), DARK_RED, 0 ) );
+        queries.push_back( RegionQuery( cv::Point(3, 3), RED, 30 ) );
+
+        /// region of second query passes through pixels of first region
+        const MaskC1 labels = findRegions(image, queries, true);
+        BOOST_REQUIRE_EQUAL( labels.empty(), false );
+        BOOST_CHECK_EQUAL( labels.get(9, 3), 1 );
+        BOOST_CHECK_EQUAL( labels.get(3, 3), 2 );
+        BOOST_CHECK_EQUAL( labels.get(21, 3), 0 );
+        BOOST_CHECK_EQUAL( countValue(*labels, 1), 24 );
+        BOOST_CHECK_EQUAL( countValue(*labels, 2), 36 );
+    }
+
+    BOOST_AUTO_TEST_CASE( many_colors ) {
+        cv::Mat image( 10, 40, CV_8UC3, cv::Scalar(255, 255, 255) );
+        std::vector<RegionQuery> queries;
+        for (int i = 0; i < 12; ++i) {
+            const cv::Vec3b color(i * 10, 0, 0);
+            cv::Mat( image, cv::Rect(i * 3, 0, 2, 10) ).setTo( cv::Scalar(color[0], color[1], color[2]) );
+            queries.push_back( RegionQuery( cv::Point(i * 3, 5), color, 0 ) );
+        }
+
+        const MaskC1 labels = findRegions(image, queries, true);
+        BOOST_REQUIRE_EQUAL( labels.empty(), false );
+        for (int i = 0; i < 12; ++i) {
+            BOOST_CHECK_EQUAL( labels.get(i * 3 + 1, 9), i + 1 );
+            BOOST_CHECK_EQUAL( countValue(*labels, i + 1), 20 );
+        }
+        BOOST_CHECK_EQUAL( countValue(*labels, 0), 400 - 12 * 20 );
+    }
+
+    BOOST_AUTO_TEST_CASE( invalid_queries ) {
+        const cv::Mat image = createImage();
+        std::vector<RegionQuery> queries;
+        queries.push_back( RegionQuery( cv::Point(-1, 3), RED, 0 ) );
+        queries.push_back( RegionQuery( cv::Point(0, 0), RED, 0 ) );
+
+        const MaskC1 result = findRegions(image, queries);
+        BOOST_REQUIRE_EQUAL( result.empty(), false );
+        BOOST_CHECK_EQUAL( countValue(*result, 0), 600 );
+
+        BOOST_CHECK_EQUAL( findRegions(cv::Mat(), queries).empty(), true );
+
+        const std::vector<RegionQuery> tooMany( MAX_REGION_LABELS + 1, queries[1] );
+        BOOST_CHECK_EQUAL( findRegions(image, tooMany, true).empty(), true );
+        BOOST_CHECK_EQUAL( findRegions(image, tooMany, false).empty(), false );
+    }
+
+    BOOST_AUTO_TEST_CASE( analysis_queries ) {
+        Analysis object;
+        object.setImage( createImage() );
+
+        std::vector<RegionQuery> queries;
+        BOOST_CHECK_EQUAL( object.region(queries).empty(), true );
+
+        queries.push_back( RegionQuery( cv::Point(3, 3), RED, 0 ) );
+        object.findRegion(queries);
+        BOOST_CHECK_EQUAL( countValue(object.result(), 255), 36 );
+
+        queries.push_back( RegionQuery( cv::Point(21, 3), RED, 0 ) );
+        object.findRegion(queries, true);
+        BOOST_CHECK_EQUAL( countValue(object.result(), 1), 36 );
+        BOOST_CHECK_EQUAL( countValue(object.result(), 2), 36 );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,62 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "ias/RegionStats.h"
+
+#include <boost/test/unit_test.hpp>
+
+
+using namespace ias;
+
+
+BOOST_AUTO_TEST_SUITE( RegionStatsSuite )
+
+    BOOST_AUTO_TEST_CASE( empty_region ) {
+        const RegionStats stats( RleMask(4, 5) );
+        BOOST_CHECK_EQUAL( stats.area, 0 );
+        BOOST_CHECK_EQUAL( stats.boundingBox, cv::Rect() );
+        BOOST_CHECK_EQUAL( stats.perimeter, 0 );
+        BOOST_CHECK_EQUAL( stats.touchesBorder, false );
+    }
+
+    BOOST_AUTO_TEST_CASE( rectangle ) {
+        cv::Mat mask = cv::Mat::zeros( 10, 12, CV_8UC1 );
+        for (int y = 2; y < 6; ++y) {
+            for (int x = 3; x < 8; ++x) {
+                mask.at<uchar>(y, x) = 255;
+            }
+        }
+
+        const RegionStats stats( (RleMask(mask)) );
+        BOOST_CHECK_EQUAL( stats.area, 20 );
+        BOOST_CHECK_EQUAL( stats.boundingBox, cv::Rect(3, 2, 5, 4) );
+        BOOST_CHECK_CLOSE( stats.centroid.x, 5.0, 0.0001 );
+        BOOST_CHECK_CLOSE( stats.centroid.y, 3.5, 0.0001 );
+        BOOST_CHECK_EQUAL( stats.perimeter, 14 );
+        BOOST_CHECK_EQUAL( stats.touchesBorder, false );
+
+        mask.at<uchar>(5, 11) = 255;
+        BOOST_CHECK_EQUAL( RegionStats( (RleMask(mask)) ).touchesBorder, true );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,202 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "ias/RleMask.h"
+#include "ias/Analysis.h"
+#include "ias/MaskCodec.h"
+
+#include <cstdio>
+
+#include <boost/test/unit_test.hpp>
+
+
+using namespace ias;
+
+
+BOOST_AUTO_TEST_SUITE( RleMaskSuite )
+
+    static cv::Mat randomMask(const int rows, const int cols, const unsigned int seed, const int percent) {
+        cv::Mat mask = cv::Mat::zeros( rows, cols, CV_8UC1 );
+        unsigned int state = seed;
+        for (int y = 0; y < rows; ++y) {
+            for (int x = 0; x < cols; ++x) {
+                state = state * 1103515245 + 12345;
+                if ( (int)((state >> 16) % 100) < percent )
+                    mask.at<uchar>(y, x) = 255;
+            }
+        }
+        return mask;
+    }
+
+    static void checkEqual(const RleMask& result, const cv::Mat& expected) {
+        BOOST_REQUIRE_EQUAL( result.rows(), expected.rows );
+        BOOST_REQUIRE_EQUAL( result.cols(), expected.cols );
+        const MaskC1 mask = result.toMask();
+        for (int y = 0; y < expected.rows; ++y) {
+            for (int x = 0; x < expected.cols; ++x) {
+                BOOST_CHECK_EQUAL( mask.get(x, y), expected.at<uchar>(y, x) );
+            }
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE( from_mask ) {
+        cv::Mat mask = cv::Mat::zeros( 3, 6, CV_8UC1 );
+        mask.at<uchar>(0, 0) = 255;
+        mask.at<uchar>(0, 1) = 255;
+        mask.at<uchar>(0, 5) = 255;
+        mask.at<uchar>(2, 2) = 1;
+
+        const RleMask rle(mask);
+        BOOST_CHECK_EQUAL( rle.size(), 3 );
+        BOOST_CHECK_EQUAL( rle.area(), 4 );
+        BOOST_CHECK_EQUAL( rle.boundingBox(), cv::Rect(0, 0, 6, 3) );
+        BOOST_CHECK_EQUAL( rle.contains( cv::Point(1, 0) ), true );
+        BOOST_CHECK_EQUAL( rle.contains( cv::Point(2, 0) ), false );
+        BOOST_CHECK_EQUAL( rle.contains( cv::Point(2, 2) ), true );
+        BOOST_CHECK_EQUAL( rle.contains( cv::Point(2, 3) ), false );
+        BOOST_CHECK_EQUAL( rle.rowEnd(1) - rle.rowBegin(1), 0 );
+
+        const RleMask empty(3, 6);
+        BOOST_CHECK_EQUAL( empty.empty(), true );
+        BOOST_CHECK_EQUAL( empty.boundingBox(), cv::Rect() );
+    }
+
+    BOOST_AUTO_TEST_CASE( spans_merged ) {
+        std::vector<FillSpan> spans;
+        spans.push_back( FillSpan(1, 4, 6) );
+        spans.push_back( FillSpan(1, 0, 3) );
+        spans.push_back( FillSpan(0, 2, 2) );
+
+        const RleMask rle(2, 8, spans);
+        BOOST_REQUIRE_EQUAL( rle.size(), 2 );
+        BOOST_CHECK_EQUAL( rle.run(1).left, 0 );
+        BOOST_CHECK_EQUAL( rle.run(1).right, 6 );
+    }
+
+    BOOST_AUTO_TEST_CASE( set_operations ) {
+        const cv::Mat a = randomMask(17, 40, 1, 60);
+        const cv::Mat b = randomMask(17, 40, 2, 40);
+        const RleMask rleA(a);
+        const RleMask rleB(b);
+
+        cv::Mat unite = a.clone();
+        cv::Mat intersect = a.clone();
+        cv::Mat subtract = a.clone();
+        for (int y = 0; y < a.rows; ++y) {
+            for (int x = 0; x < a.cols; ++x) {
+                const bool inA = a.at<uchar>(y, x) != 0;
+                const bool inB = b.at<uchar>(y, x) != 0;
+                unite.at<uchar>(y, x) = (inA || inB) ? 255 : 0;
+                intersect.at<uchar>(y, x) = (inA && inB) ? 255 : 0;
+                subtract.at<uchar>(y, x) = (inA && !inB) ? 255 : 0;
+            }
+        }
+
+        checkEqual( rleA.unite(rleB), unite );
+        checkEqual( rleA.intersect(rleB), intersect );
+        checkEqual( rleA.subtract(rleB), subtract );
+
+        /// results are normalized
+        BOOST_CHECK( rleA.unite(rleB) == RleMask(unite) );
+        BOOST_CHECK( rleA.subtract(rleA).empty() );
+    }
+
+    BOOST_AUTO_TEST_CASE( perimeter_same_as_analysis ) {
+        const int percents[] = { 30, 70, 95 };
+        for (const int percent: percents) {
+            const cv::Mat mask = randomMask(23, 31, percent, percent);
+            for (int connectivity = 4; connectivity <= 8; connectivity += 4) {
+                Analysis analysis;
+                analysis.setImage( cv::Mat::zeros(mask.rows, mask.cols, CV_8UC3) );
+                analysis.findPerimeter(mask, connectivity);
+                checkEqual( RleMask(mask).perimeter(connectivity), analysis.result() );
+            }
+        }
+
+        /// single row
+        const cv::Mat row = randomMask(1, 20, 5, 80);
+        checkEqual( RleMask(row).perimeter(), row );
+    }
+
+    BOOST_AUTO_TEST_CASE( fill_same_as_mask ) {
+        const cv::Mat mask = randomMask(30, 40, 7, 55);
+        cv::Mat image( mask.rows, mask.cols, CV_8UC3 );
+        for (int y = 0; y < mask.rows; ++y) {
+            for (int x = 0; x < mask.cols; ++x) {
+                const uchar value = mask.at<uchar>(y, x);
+                image.at<cv::Vec3b>(y, x) = cv::Vec3b(value, value, value);
+            }
+        }
+
+        Analysis analysis;
+        analysis.setImage(image);
+        const cv::Point seeds[] = { cv::Point(0, 0), cv::Point(10, 10), cv::Point(39, 29), cv::Point(-1, 3) };
+        for (const cv::Point& seed: seeds) {
+            const MaskC1 expected( image, seed, cv::Vec3b(255, 255, 255), 0 );
+            const RleMask rle = RleMask::fill( image, seed, cv::Vec3b(255, 255, 255), 0 );
+            checkEqual( rle, expected.data() );
+            checkEqual( analysis.findRegionRle(seed, cv::Vec3b(255, 255, 255), 0), expected.data() );
+        }
+
+        /// answered from index
+        analysis.indexRegions( cv::Vec3b(255, 255, 255), 0 );
+        for (const cv::Point& seed: seeds) {
+            const MaskC1 expected( image, seed, cv::Vec3b(255, 255, 255), 0 );
+            checkEqual( analysis.findRegionRle(seed, cv::Vec3b(255, 255, 255), 0), expected.data() );
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE( serialization ) {
+        cv::Mat mask = randomMask(9, 300, 3, 50);
+        mask.row(4).setTo( cv::Scalar(255) );
+        mask.row(5).setTo( cv::Scalar(0) );
+        const RleMask rle(mask);
+
+        std::vector<uchar> data;
+        rle.serialize(data);
+        RleMask loaded;
+        BOOST_REQUIRE_EQUAL( loaded.deserialize(data.data(), data.size()), true );
+        BOOST_CHECK( loaded == rle );
+
+        /// the same format as files stored by storeImage()
+        BOOST_REQUIRE_EQUAL( storeImage(mask, "rlemask_test.rle"), true );
+        RleMask stored;
+        BOOST_REQUIRE_EQUAL( stored.load("rlemask_test.rle"), true );
+        BOOST_CHECK( stored == rle );
+        BOOST_REQUIRE_EQUAL( rle.store("rlemask_test.rle"), true );
+        ImageFile file;
+        BOOST_REQUIRE_EQUAL( file.load("rlemask_test.rle"), true );
+        BOOST_CHECK_EQUAL( file.image().at<cv::Vec3b>(4, 0), cv::Vec3b(255, 255, 255) );
+        std::remove("rlemask_test.rle");
+
+        BOOST_CHECK_EQUAL( loaded.deserialize(data.data(), data.size() - 1), false );
+
+        /// header declaring more rows than data can hold
+        std::vector<uchar> forged;
+        encodeRleHeader(1, 0x7FFFFFFF, forged);
+        forged.push_back( 1 );
+        BOOST_CHECK_EQUAL( loaded.deserialize(forged.data(), forged.size()), false );
+        BOOST_CHECK( loaded == rle );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
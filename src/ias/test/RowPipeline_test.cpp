@@ -0,0 +1,102 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "ias/RowPipeline.h"
+#include "ias/MaskC1.h"
+#include "ias/Kernels.h"
+
+#include <boost/test/unit_test.hpp>
+
+
+using namespace ias;
+
+
+BOOST_AUTO_TEST_SUITE( RowPipelineSuite )
+
+    static cv::Mat patternMask(const int rows, const int cols) {
+        cv::Mat matrix = cv::Mat::zeros( rows, cols, CV_8UC1 );
+        for (int y = 0; y < matrix.rows; ++y) {
+            for (int x = 0; x < matrix.cols; ++x) {
+                matrix.at<uchar>(y, x) = (uchar) ( (x * 37 + y * 91 + x * y) % 256 );
+            }
+        }
+        return matrix;
+    }
+
+    static void checkEqual(const cv::Mat& result, const MaskC1& expected) {
+        BOOST_REQUIRE_EQUAL( result.rows, expected.data().rows );
+        BOOST_REQUIRE_EQUAL( result.cols, expected.data().cols );
+        for (int y = 0; y < result.rows; ++y) {
+            for (int x = 0; x < result.cols; ++x) {
+                BOOST_CHECK_EQUAL( result.at<uchar>(y, x), expected.get(x, y) );
+            }
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE( no_stages ) {
+        const cv::Mat matrix = patternMask(4, 7);
+
+        RowPipeline pipeline;
+        cv::Mat result;
+        pipeline.run(matrix, result);
+
+        checkEqual(result, MaskC1(matrix.clone()));
+    }
+
+    BOOST_AUTO_TEST_CASE( single_row ) {
+        const cv::Mat matrix = patternMask(1, 9);
+
+        RowPipeline pipeline;
+        pipeline.addStage( RowPipeline::DILATE );
+        pipeline.addStage( RowPipeline::LAPLACE, 64 );
+        cv::Mat result;
+        pipeline.run(matrix, result);
+
+        MaskC1 expected( matrix.clone() );
+        expected.dilate(3);
+        expected.applyFilter<LaplaceKernel>();
+        expected.threshold(64);
+        checkEqual(result, expected);
+    }
+
+    BOOST_AUTO_TEST_CASE( stages_as_MaskC1 ) {
+        const cv::Mat matrix = patternMask(23, 31);
+
+        RowPipeline pipeline;
+        pipeline.addStage( RowPipeline::ERODE );
+        pipeline.addStage( RowPipeline::DILATE );
+        pipeline.addStage( RowPipeline::GAUSSIAN_BLUR, 100 );
+        pipeline.addStage( RowPipeline::LAPLACE );
+        cv::Mat result;
+        pipeline.run(matrix, result);
+
+        MaskC1 expected( matrix.clone() );
+        expected.erode(3);
+        expected.dilate(3);
+        expected.applyFilter<GaussianKernel>();
+        expected.threshold(100);
+        expected.applyFilter<LaplaceKernel>();
+        checkEqual(result, expected);
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,84 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "ias/RunLabeling.h"
+
+#include <boost/test/unit_test.hpp>
+
+
+using namespace ias;
+
+
+BOOST_AUTO_TEST_SUITE( RunLabelingSuite )
+
+    BOOST_AUTO_TEST_CASE( empty_mask ) {
+        RunLabeling labeling;
+        labeling.label( cv::Mat( 0, 0, CV_8UC1 ), 255 );
+
+        BOOST_CHECK_EQUAL( labeling.size(), 0 );
+        BOOST_CHECK_EQUAL( labeling.findRun( cv::Point(0, 0) ), -1 );
+    }
+
+    BOOST_AUTO_TEST_CASE( runs_of_rows ) {
+        cv::Mat mask = cv::Mat::zeros( 2, 6, CV_8UC1 );
+        mask.at<uchar>(0, 0) = 255;
+        mask.at<uchar>(0, 1) = 255;
+        mask.at<uchar>(0, 4) = 255;
+        mask.at<uchar>(1, 5) = 255;
+
+        RunLabeling labeling;
+        labeling.label( mask, 255 );
+
+        BOOST_REQUIRE_EQUAL( labeling.size(), 3 );
+        BOOST_CHECK_EQUAL( labeling.rowBegin(1), 2 );
+        BOOST_CHECK_EQUAL( labeling.run(0).left, 0 );
+        BOOST_CHECK_EQUAL( labeling.run(0).right, 1 );
+        BOOST_CHECK_EQUAL( labeling.findRun( cv::Point(4, 0) ), 1 );
+        BOOST_CHECK_EQUAL( labeling.findRun( cv::Point(2, 0) ), -1 );
+
+        /// diagonal runs are not connected
+        BOOST_CHECK_EQUAL( labeling.runLabel(1), 1 );
+        BOOST_CHECK_EQUAL( labeling.runLabel(2), 2 );
+    }
+
+    BOOST_AUTO_TEST_CASE( label_is_first_run ) {
+        /// "U" shape, arms are joined in last row
+        cv::Mat mask = cv::Mat::zeros( 3, 3, CV_8UC1 );
+        mask.at<uchar>(0, 0) = 255;
+        mask.at<uchar>(0, 2) = 255;
+        mask.at<uchar>(1, 0) = 255;
+        mask.at<uchar>(1, 2) = 255;
+        mask.at<uchar>(2, 0) = 255;
+        mask.at<uchar>(2, 1) = 255;
+        mask.at<uchar>(2, 2) = 255;
+
+        RunLabeling labeling;
+        labeling.label( mask, 255 );
+
+        BOOST_REQUIRE_EQUAL( labeling.size(), 5 );
+        for (std::size_t i = 0; i < labeling.size(); ++i) {
+            BOOST_CHECK_EQUAL( labeling.runLabel(i), 0 );
+        }
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,148 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "ias/StripProcessor.h"
+#include "ias/Analysis.h"
+
+#include <cstdio>
+
+#include <boost/test/unit_test.hpp>
+
+
+using namespace ias;
+
+
+BOOST_AUTO_TEST_SUITE( StripProcessorSuite )
+
+    static const cv::Vec3b BLACK(0, 0, 0);
+
+    /// U shape: arms join below strips containing seed, with separate blob inside
+    static cv::Mat shapesImage() {
+        cv::Mat image( 23, 17, CV_8UC3, cv::Scalar(255, 255, 255) );
+        for (int y = 1; y < 20; ++y) {
+            image.at<cv::Vec3b>(y, 2) = BLACK;
+            image.at<cv::Vec3b>(y, 3) = BLACK;
+            image.at<cv::Vec3b>(y, 12) = BLACK;
+        }
+        for (int x = 2; x < 13; ++x) {
+            image.at<cv::Vec3b>(20, x) = BLACK;
+        }
+        for (int y = 5; y < 9; ++y) {
+            for (int x = 6; x < 9; ++x) {
+                image.at<cv::Vec3b>(y, x) = BLACK;
+            }
+        }
+        /// diagonal neighbour is not connected
+        image.at<cv::Vec3b>(21, 13) = BLACK;
+        image.at<cv::Vec3b>(22, 16) = BLACK;
+        return image;
+    }
+
+    static cv::Mat runStrips(const int stripRows, const cv::Point& seed, const int operation) {
+        StripProcessor processor(stripRows);
+        BOOST_REQUIRE_EQUAL( processor.open("strip_test.raw"), true );
+        if (operation == 4 || operation == 8) {
+            processor.addPerimeter(operation);
+        } else if (operation == 1) {
+            processor.addSmoothPerimeter();
+        }
+
+        const ImageLayout& layout = processor.imageLayout();
+        cv::Mat result( layout.height, layout.width, CV_8UC1 );
+        int row = 0;
+        BOOST_REQUIRE_EQUAL( processor.findRegion(seed, BLACK, 0, [&](const uchar* data) {
+            std::copy( data, data + result.cols, result.ptr<uchar>(row++) );
+        }), true );
+        BOOST_CHECK_EQUAL( row, result.rows );
+        return result;
+    }
+
+    static cv::Mat runAnalysis(const cv::Mat& image, const cv::Point& seed, const int operation) {
+        Analysis analysis;
+        analysis.setImage( image );
+        analysis.findRegion(seed, BLACK, 0);
+        if (operation == 4 || operation == 8) {
+            analysis.findPerimeter(operation);
+        } else if (operation == 1) {
+            analysis.findSmoothPerimeter();
+        }
+        return analysis.result().clone();
+    }
+
+    static void checkEqual(const cv::Mat& result, const cv::Mat& expected) {
+        BOOST_REQUIRE_EQUAL( result.rows, expected.rows );
+        BOOST_REQUIRE_EQUAL( result.cols, expected.cols );
+        for (int y = 0; y < result.rows; ++y) {
+            for (int x = 0; x < result.cols; ++x) {
+                BOOST_CHECK_EQUAL( result.at<uchar>(y, x), expected.at<uchar>(y, x) );
+            }
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE( open_not_found ) {
+        StripProcessor processor(4);
+        BOOST_CHECK_EQUAL( processor.open("not_found.raw"), false );
+        BOOST_CHECK_EQUAL( processor.findRegion(cv::Point(0, 0), BLACK, 0, [](const uchar*) {}), false );
+    }
+
+    BOOST_AUTO_TEST_CASE( same_as_analysis ) {
+        const cv::Mat image = shapesImage();
+        BOOST_REQUIRE_EQUAL( storeImage(image, "strip_test.raw"), true );
+
+        const cv::Point seeds[] = { cv::Point(2, 1), cv::Point(12, 3), cv::Point(7, 6), cv::Point(13, 21), cv::Point(0, 0), cv::Point(16, 22) };
+        const int stripRows[] = { 1, 2, 3, 5, 23, 100 };
+        const int operations[] = { 0, 4, 8, 1 };
+        for (const cv::Point& seed: seeds) {
+            for (const int operation: operations) {
+                const cv::Mat expected = runAnalysis(image, seed, operation);
+                for (const int rows: stripRows) {
+                    checkEqual( runStrips(rows, seed, operation), expected );
+                }
+            }
+        }
+
+        std::remove("strip_test.raw");
+    }
+
+    BOOST_AUTO_TEST_CASE( store_pgm ) {
+        const cv::Mat image = shapesImage();
+        BOOST_REQUIRE_EQUAL( storeImage(image, "strip_test.ppm"), true );
+
+        StripProcessor processor(3);
+        BOOST_REQUIRE_EQUAL( processor.open("strip_test.ppm"), true );
+        BOOST_REQUIRE_EQUAL( processor.findRegion(cv::Point(12, 3), BLACK, 0, "strip_test.pgm"), true );
+
+        ImageFile file;
+        BOOST_REQUIRE_EQUAL( file.load("strip_test.pgm"), true );
+        const cv::Mat expected = runAnalysis(image, cv::Point(12, 3), 0);
+        for (int y = 0; y < expected.rows; ++y) {
+            for (int x = 0; x < expected.cols; ++x) {
+                BOOST_CHECK_EQUAL( file.image().at<cv::Vec3b>(y, x)[0], expected.at<uchar>(y, x) );
+            }
+        }
+
+        std::remove("strip_test.ppm");
+        std::remove("strip_test.pgm");
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
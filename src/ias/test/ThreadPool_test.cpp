@@ -0,0 +1,144 @@
+/// MIT License
+///
+/// Copyright (c) 2017 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "ias/ThreadPool.h"
+#include "ias/MaskC1.h"
+#include "ias/Kernels.h"
+
+#include <stdexcept>
+
+#include <boost/test/unit_test.hpp>
+
+
+using namespace ias;
+
+
+BOOST_AUTO_TEST_SUITE( ThreadPoolSuite )
+
+    BOOST_AUTO_TEST_CASE( bands_cover_range ) {
+        ThreadPool pool(4);
+        BOOST_CHECK_EQUAL( pool.size(), 4 );
+
+        std::vector<int> visits(1001, 0);
+        pool.parallelFor(1001, [&visits](const int begin, const int end) {
+            for (int i = begin; i < end; ++i) {
+                ++visits[i];
+            }
+        });
+
+        for (std::size_t i = 0; i < visits.size(); ++i) {
+            BOOST_CHECK_EQUAL( visits[i], 1 );
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE( grain_limits_bands ) {
+        ThreadPool pool(4);
+
+        std::atomic<int> calls(0);
+        pool.parallelFor(10, [&calls](const int, const int) {
+            ++calls;
+        }, 5);
+
+        BOOST_CHECK_EQUAL( calls.load(), 2 );
+    }
+
+    BOOST_AUTO_TEST_CASE( nested_loop ) {
+        ThreadPool pool(3);
+
+        std::vector<int> visits(30 * 30, 0);
+        pool.parallelFor(30, [&pool, &visits](const int begin, const int end) {
+            for (int y = begin; y < end; ++y) {
+                pool.parallelFor(30, [&visits, y](const int innerBegin, const int innerEnd) {
+                    for (int x = innerBegin; x < innerEnd; ++x) {
+                        ++visits[y * 30 + x];
+                    }
+                });
+            }
+        });
+
+        for (std::size_t i = 0; i < visits.size(); ++i) {
+            BOOST_CHECK_EQUAL( visits[i], 1 );
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE( exception_rethrown ) {
+        ThreadPool pool(4);
+
+        BOOST_CHECK_THROW( pool.parallelFor(100, [](const int begin, const int) {
+            if (begin > 0)
+                throw std::runtime_error("band failed");
+        }), std::runtime_error );
+
+        /// pool is still usable
+        std::atomic<int> sum(0);
+        pool.parallelFor(100, [&sum](const int begin, const int end) {
+            sum += end - begin;
+        });
+        BOOST_CHECK_EQUAL( sum.load(), 100 );
+    }
+
+    BOOST_AUTO_TEST_CASE( resize ) {
+        ThreadPool pool(2);
+        pool.resize(5);
+        BOOST_CHECK_EQUAL( pool.size(), 5 );
+        pool.resize(1);
+        BOOST_CHECK_EQUAL( pool.size(), 1 );
+        pool.resize(0);
+        BOOST_CHECK( pool.size() >= 1 );
+    }
+
+    BOOST_AUTO_TEST_CASE( MaskC1_deterministic ) {
+        cv::Mat image( 700, 300, CV_8UC3 );
+        for (int y = 0; y < image.rows; ++y) {
+            for (int x = 0; x < image.cols; ++x) {
+                image.at<cv::Vec3b>(y, x) = cv::Vec3b( (x * 7 + y) % 256, (x + y * 3) % 256, (x * y) % 256 );
+            }
+        }
+        const cv::Vec3b color(100, 100, 100);
+        const cv::Mat box = cv::Mat::ones( 3, 3, CV_64F ) / 9;
+        const cv::Mat separable = cv::Mat::ones( 5, 5, CV_64F ) / 16;
+
+        MaskC1 serial(image, color, 90);
+        serial.applyFilter<GaussianKernel>();
+        serial.applyFilter(box);
+        serial.applyFilter(separable);
+        serial.threshold(128);
+        serial.changeColor(0, 40);
+
+        ThreadPool::global().resize(4);
+        MaskC1 parallel(image, color, 90);
+        parallel.applyFilter<GaussianKernel>();
+        parallel.applyFilter(box);
+        parallel.applyFilter(separable);
+        parallel.threshold(128);
+        parallel.changeColor(0, 40);
+        ThreadPool::global().resize(1);
+
+        for (int y = 0; y < image.rows; ++y) {
+            for (int x = 0; x < image.cols; ++x) {
+                BOOST_REQUIRE_EQUAL( parallel.get(x, y), serial.get(x, y) );
+            }
+        }
+    }
+
+BOOST_AUTO_TEST_SUITE_END()